@@ -0,0 +1,659 @@
+/*
+ * Microbenchmarks de las operaciones del hash.
+ *
+ * Mide insertar, buscar claves que estan, buscar claves que no estan,
+ * quitar, recorrer, el costo de los rehash y destruir, para distintas
+ * cantidades de claves, distribuciones de largo de clave y cargas
+ * iniciales. Para cada operacion informa ns/op, percentiles de latencia
+ * (sobre una muestra de operaciones medidas de a una) y reservas de
+ * memoria por operacion.
+ *
+ * Se compila aparte de las pruebas, desde la raiz del repositorio:
+ *
+ *   gcc -O2 -std=c99 -I. $(ls *.c | grep -v pruebas.c) benchmarks/hash_benchmark.c -o hash_benchmark
+ *
+ * Para contar las reservas de memoria se agrega:
+ *
+ *   -DCONTAR_RESERVAS -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+ *
+ * Uso: ./hash_benchmark [cantidades] [carga]
+ *   cantidades: lista separada por comas (por defecto 1000,10000,100000)
+ *   carga: porcentaje de claves sobre la capacidad inicial (por defecto
+ *          0, que crea el hash con la capacidad minima y lo deja crecer)
+ *
+ * Ejemplo: ./hash_benchmark 1000,1000000,100000000 75
+ *
+ * Los nucleos de hash y comparacion se eligen segun el procesador; para
+ * comparar implementaciones se fuerzan con la variable de entorno:
+ *
+ *   HASH_NUCLEOS=portable ./hash_benchmark    (o sse42, avx2)
+ *
+ * Los arreglos grandes de las tablas se reservan con paginas de 2 MB y
+ * ubicacion NUMA segun otra variable, con las opciones separadas por
+ * comas:
+ *
+ *   HASH_RESERVA=grandes ./hash_benchmark
+ *   HASH_RESERVA=grandes,intercalar ./hash_benchmark   (o nodo=<n>)
+ *
+ * En linux tambien se informan las fallas de dTLB por operacion, si el
+ * sistema deja leer los contadores del procesador (si no, "-").
+ */
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "hash.h"
+#include "hash_rh.h"
+#include "hash_cuckoo.h"
+#include "hash_ordenado.h"
+#include "hash_hamt.h"
+#include "hash_reserva.h"
+#include "reserva.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define CANTIDADES_POR_DEFECTO "1000,10000,100000"
+#define MAX_CANTIDADES 16
+#define MAX_MUESTRAS 100000
+#define NANOSEGUNDOS 1000000000ULL
+#define CAPACIDAD_MIN 3
+#define PORCENTAJE 100
+#define SIN_CONTADOR -1
+
+/*
+ * Operaciones de una implementacion de tabla, para poder comparar
+ * distintas implementaciones con las mismas mediciones.
+ */
+typedef struct backend{
+    const char* nombre;
+    void* (*crear)(size_t capacidad);
+    int (*insertar)(void* tabla, const char* clave, void* elemento);
+    void* (*obtener)(void* tabla, const char* clave);
+    int (*quitar)(void* tabla, const char* clave);
+    size_t (*recorrer)(void* tabla);
+    void (*destruir)(void* tabla);
+}backend_t;
+
+/*
+ * Distribucion del largo de las claves generadas.
+ */
+typedef struct distribucion{
+    const char* nombre;
+    size_t largo_min;
+    size_t largo_max;
+}distribucion_t;
+
+typedef struct claves{
+    char* bloque;
+    char** presentes;
+    char** ausentes;
+    size_t cantidad;
+}claves_t;
+
+typedef enum operacion{
+    INSERTAR,
+    OBTENER,
+    QUITAR,
+}operacion_t;
+
+typedef struct medicion{
+    uint64_t total;
+    size_t operaciones;
+    uint64_t muestras[MAX_MUESTRAS];
+    size_t cant_muestras;
+    size_t reservas;
+    uint64_t fallas_tlb;
+}medicion_t;
+
+/* ---------------------------------------------------------------- */
+/* Conteo de reservas de memoria                                    */
+/* ---------------------------------------------------------------- */
+
+static size_t reservas = 0;
+
+#ifdef CONTAR_RESERVAS
+void* __real_malloc(size_t tamanio);
+void* __real_calloc(size_t cantidad, size_t tamanio);
+void* __real_realloc(void* puntero, size_t tamanio);
+void __real_free(void* puntero);
+
+void* __wrap_malloc(size_t tamanio){
+    reservas++;
+    return __real_malloc(tamanio);
+}
+
+void* __wrap_calloc(size_t cantidad, size_t tamanio){
+    reservas++;
+    return __real_calloc(cantidad, tamanio);
+}
+
+void* __wrap_realloc(void* puntero, size_t tamanio){
+    reservas++;
+    return __real_realloc(puntero, tamanio);
+}
+
+void __wrap_free(void* puntero){
+    __real_free(puntero);
+}
+#endif
+
+/* ---------------------------------------------------------------- */
+/* Conteo de fallas de dTLB                                         */
+/* ---------------------------------------------------------------- */
+
+static int contador_tlb = SIN_CONTADOR;
+
+/*
+ * Abre el contador de fallas de lectura del dTLB del proceso. Si no hay
+ * permiso o el procesador no lo tiene, las fallas no se informan.
+ */
+static void abrir_contador_tlb(void){
+#if defined(__linux__) && defined(SYS_perf_event_open)
+    struct perf_event_attr atributos;
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.type = PERF_TYPE_HW_CACHE;
+    atributos.size = sizeof(atributos);
+    atributos.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    atributos.disabled = 1;
+    atributos.exclude_kernel = 1;
+    atributos.exclude_hv = 1;
+    contador_tlb = (int)syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+    if(contador_tlb >= 0)
+        ioctl(contador_tlb, PERF_EVENT_IOC_ENABLE, 0);
+    else
+        contador_tlb = SIN_CONTADOR;
+#endif
+}
+
+static uint64_t fallas_tlb(void){
+    uint64_t fallas = 0;
+#ifdef __linux__
+    if(contador_tlb != SIN_CONTADOR && read(contador_tlb, &fallas, sizeof(fallas)) != sizeof(fallas))
+        fallas = 0;
+#endif
+    return fallas;
+}
+
+/* ---------------------------------------------------------------- */
+/* Reserva de los arreglos grandes                                  */
+/* ---------------------------------------------------------------- */
+
+static reserva_t reserva;
+static const reserva_t* con_reserva = NULL;
+
+/*
+ * Lee las opciones de reserva de HASH_RESERVA. Sin la variable las
+ * tablas se crean como siempre.
+ */
+static void leer_reserva(void){
+    const char* texto = getenv("HASH_RESERVA");
+    if(!texto || !*texto)
+        return;
+    while(*texto){
+        size_t largo = strcspn(texto, ",");
+        if(largo == strlen("grandes") && strncmp(texto, "grandes", largo) == 0)
+            reserva.paginas_grandes = true;
+        else if(largo == strlen("intercalar") && strncmp(texto, "intercalar", largo) == 0)
+            reserva.numa = RESERVA_NUMA_INTERCALAR;
+        else if(strncmp(texto, "nodo=", strlen("nodo=")) == 0){
+            reserva.numa = RESERVA_NUMA_NODO;
+            reserva.nodo = atoi(texto + strlen("nodo="));
+        }else
+            fprintf(stderr, "HASH_RESERVA: opcion desconocida '%.*s'\n", (int)largo, texto);
+        texto += largo;
+        if(*texto == ',')
+            texto++;
+    }
+    con_reserva = &reserva;
+}
+
+/* ---------------------------------------------------------------- */
+/* Implementaciones medidas                                         */
+/* ---------------------------------------------------------------- */
+
+static bool contar_clave(hash_t* hash, const char* clave, void* aux){
+    (*(size_t*)aux)++;
+    return false;
+}
+
+static void* encadenado_crear(size_t capacidad){
+    return hash_crear_con_reserva(NULL, capacidad, con_reserva);
+}
+
+static int encadenado_insertar(void* tabla, const char* clave, void* elemento){
+    return hash_insertar(tabla, clave, elemento);
+}
+
+static void* encadenado_obtener(void* tabla, const char* clave){
+    return hash_obtener(tabla, clave);
+}
+
+static int encadenado_quitar(void* tabla, const char* clave){
+    return hash_quitar(tabla, clave);
+}
+
+static size_t encadenado_recorrer(void* tabla){
+    size_t cantidad = 0;
+    hash_con_cada_clave(tabla, contar_clave, &cantidad);
+    return cantidad;
+}
+
+static void encadenado_destruir(void* tabla){
+    hash_destruir(tabla);
+}
+
+static bool contar_clave_rh(hash_rh_t* hash, const char* clave, void* aux){
+    (*(size_t*)aux)++;
+    return false;
+}
+
+static void* robin_hood_crear(size_t capacidad){
+    return hash_rh_crear_con_reserva(NULL, capacidad, con_reserva);
+}
+
+static int robin_hood_insertar(void* tabla, const char* clave, void* elemento){
+    return hash_rh_insertar(tabla, clave, elemento);
+}
+
+static void* robin_hood_obtener(void* tabla, const char* clave){
+    return hash_rh_obtener(tabla, clave);
+}
+
+static int robin_hood_quitar(void* tabla, const char* clave){
+    return hash_rh_quitar(tabla, clave);
+}
+
+static size_t robin_hood_recorrer(void* tabla){
+    size_t cantidad = 0;
+    hash_rh_con_cada_clave(tabla, contar_clave_rh, &cantidad);
+    return cantidad;
+}
+
+static void robin_hood_destruir(void* tabla){
+    hash_rh_destruir(tabla);
+}
+
+static bool contar_clave_cuckoo(hash_cuckoo_t* hash, const char* clave, void* aux){
+    (*(size_t*)aux)++;
+    return false;
+}
+
+static void* cuckoo_crear(size_t capacidad){
+    return hash_cuckoo_crear_con_reserva(NULL, capacidad, con_reserva);
+}
+
+static int cuckoo_insertar(void* tabla, const char* clave, void* elemento){
+    return hash_cuckoo_insertar(tabla, clave, elemento);
+}
+
+static void* cuckoo_obtener(void* tabla, const char* clave){
+    return hash_cuckoo_obtener(tabla, clave);
+}
+
+static int cuckoo_quitar(void* tabla, const char* clave){
+    return hash_cuckoo_quitar(tabla, clave);
+}
+
+static size_t cuckoo_recorrer(void* tabla){
+    size_t cantidad = 0;
+    hash_cuckoo_con_cada_clave(tabla, contar_clave_cuckoo, &cantidad);
+    return cantidad;
+}
+
+static void cuckoo_destruir(void* tabla){
+    hash_cuckoo_destruir(tabla);
+}
+
+static bool contar_clave_ordenado(hash_ordenado_t* hash, const char* clave, void* elemento, void* aux){
+    (*(size_t*)aux)++;
+    return false;
+}
+
+static void* ordenado_crear(size_t capacidad){
+    return hash_ordenado_crear_con_reserva(NULL, capacidad, con_reserva);
+}
+
+static int ordenado_insertar(void* tabla, const char* clave, void* elemento){
+    return hash_ordenado_insertar(tabla, clave, elemento);
+}
+
+static void* ordenado_obtener(void* tabla, const char* clave){
+    return hash_ordenado_obtener(tabla, clave);
+}
+
+static int ordenado_quitar(void* tabla, const char* clave){
+    return hash_ordenado_quitar(tabla, clave);
+}
+
+static size_t ordenado_recorrer(void* tabla){
+    size_t cantidad = 0;
+    hash_ordenado_con_cada_clave(tabla, contar_clave_ordenado, &cantidad);
+    return cantidad;
+}
+
+static void ordenado_destruir(void* tabla){
+    hash_ordenado_destruir(tabla);
+}
+
+static bool contar_clave_hamt(hash_hamt_t* hash, const char* clave, void* aux){
+    (*(size_t*)aux)++;
+    return false;
+}
+
+static void* hamt_crear(size_t capacidad){
+    return hash_hamt_crear(NULL);
+}
+
+static int hamt_insertar(void* tabla, const char* clave, void* elemento){
+    return hash_hamt_insertar(tabla, clave, elemento);
+}
+
+static void* hamt_obtener(void* tabla, const char* clave){
+    return hash_hamt_obtener(tabla, clave);
+}
+
+static int hamt_quitar(void* tabla, const char* clave){
+    return hash_hamt_quitar(tabla, clave);
+}
+
+static size_t hamt_recorrer(void* tabla){
+    size_t cantidad = 0;
+    hash_hamt_con_cada_clave(tabla, contar_clave_hamt, &cantidad);
+    return cantidad;
+}
+
+static void hamt_destruir(void* tabla){
+    hash_hamt_destruir(tabla);
+}
+
+static const backend_t backends[] = {
+    {"encadenado", encadenado_crear, encadenado_insertar, encadenado_obtener, encadenado_quitar, encadenado_recorrer, encadenado_destruir},
+    {"robin_hood", robin_hood_crear, robin_hood_insertar, robin_hood_obtener, robin_hood_quitar, robin_hood_recorrer, robin_hood_destruir},
+    {"cuckoo", cuckoo_crear, cuckoo_insertar, cuckoo_obtener, cuckoo_quitar, cuckoo_recorrer, cuckoo_destruir},
+    {"ordenado", ordenado_crear, ordenado_insertar, ordenado_obtener, ordenado_quitar, ordenado_recorrer, ordenado_destruir},
+    {"hamt", hamt_crear, hamt_insertar, hamt_obtener, hamt_quitar, hamt_recorrer, hamt_destruir},
+};
+
+static const distribucion_t distribuciones[] = {
+    {"patentes(6-7)", 6, 7},
+    {"cortas(8)", 8, 8},
+    {"urls(40-120)", 40, 120},
+};
+
+/* ---------------------------------------------------------------- */
+/* Generacion de claves                                             */
+/* ---------------------------------------------------------------- */
+
+static uint64_t estado_aleatorio = 0x2545f4914f6cdd1dULL;
+
+//Generador xorshift64*, reproducible entre ejecuciones
+static uint64_t aleatorio(void){
+    estado_aleatorio ^= estado_aleatorio >> 12;
+    estado_aleatorio ^= estado_aleatorio << 25;
+    estado_aleatorio ^= estado_aleatorio >> 27;
+    return estado_aleatorio * 0x2545f4914f6cdd1dULL;
+}
+
+/*
+ * Escribe en destino una clave unica del largo pedido: un prefijo que
+ * distingue presentes de ausentes, el numero de clave en base 36 y
+ * relleno aleatorio.
+ */
+static size_t generar_clave(char* destino, char prefijo, size_t numero, size_t largo){
+    static const char simbolos[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    size_t usado = 0;
+    destino[usado++] = prefijo;
+    do{
+        destino[usado++] = simbolos[numero % 36];
+        numero /= 36;
+    }while(numero);
+    while(usado < largo)
+        destino[usado++] = simbolos[aleatorio() % 36];
+    destino[usado++] = '\0';
+    return usado;
+}
+
+static size_t largo_aleatorio(const distribucion_t* distribucion){
+    return distribucion->largo_min + (size_t)(aleatorio() % (distribucion->largo_max - distribucion->largo_min + 1));
+}
+
+/*
+ * Genera cantidad claves presentes y cantidad ausentes en un unico
+ * bloque, para que generarlas no cuente en las reservas medidas.
+ */
+static bool generar_claves(claves_t* claves, const distribucion_t* distribucion, size_t cantidad){
+    size_t maximo = distribucion->largo_max + 16;
+    claves->bloque = malloc(2 * cantidad * maximo);
+    claves->presentes = malloc(cantidad * sizeof(char*));
+    claves->ausentes = malloc(cantidad * sizeof(char*));
+    claves->cantidad = cantidad;
+    if(!claves->bloque || !claves->presentes || !claves->ausentes)
+        return false;
+    size_t usado = 0;
+    for(size_t i = 0; i < cantidad; i++){
+        claves->presentes[i] = claves->bloque + usado;
+        usado += generar_clave(claves->presentes[i], 'P', i, largo_aleatorio(distribucion));
+        claves->ausentes[i] = claves->bloque + usado;
+        usado += generar_clave(claves->ausentes[i], 'X', i, largo_aleatorio(distribucion));
+    }
+    return true;
+}
+
+static void liberar_claves(claves_t* claves){
+    free(claves->bloque);
+    free(claves->presentes);
+    free(claves->ausentes);
+}
+
+//Mezcla el vector de claves (Fisher-Yates)
+static void mezclar(char** vector, size_t cantidad){
+    for(size_t i = cantidad; i > 1; i--){
+        size_t j = (size_t)(aleatorio() % i);
+        char* aux = vector[i - 1];
+        vector[i - 1] = vector[j];
+        vector[j] = aux;
+    }
+}
+
+/* ---------------------------------------------------------------- */
+/* Medicion                                                         */
+/* ---------------------------------------------------------------- */
+
+static uint64_t ahora_ns(void){
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (uint64_t)ahora.tv_sec * NANOSEGUNDOS + (uint64_t)ahora.tv_nsec;
+}
+
+static void iniciar_medicion(medicion_t* medicion){
+    medicion->total = 0;
+    medicion->operaciones = 0;
+    medicion->cant_muestras = 0;
+    medicion->reservas = reservas;
+    medicion->fallas_tlb = fallas_tlb();
+}
+
+static void terminar_medicion(medicion_t* medicion, size_t operaciones){
+    medicion->operaciones = operaciones;
+    medicion->reservas = reservas - medicion->reservas;
+    medicion->fallas_tlb = fallas_tlb() - medicion->fallas_tlb;
+}
+
+/*
+ * Devuelve cada cuantas operaciones se mide una de forma individual,
+ * para no tomar mas muestras que las que entran.
+ */
+static size_t paso_de_muestreo(size_t cantidad){
+    return cantidad / MAX_MUESTRAS + 1;
+}
+
+static void agregar_muestra(medicion_t* medicion, uint64_t inicio){
+    uint64_t duracion = ahora_ns() - inicio;
+    medicion->total += duracion;
+    if(medicion->cant_muestras < MAX_MUESTRAS)
+        medicion->muestras[medicion->cant_muestras++] = duracion;
+}
+
+static int comparar_muestras(const void* a, const void* b){
+    uint64_t primero = *(const uint64_t*)a, segundo = *(const uint64_t*)b;
+    return (primero > segundo) - (primero < segundo);
+}
+
+static uint64_t percentil(medicion_t* medicion, size_t milesimos){
+    if(!medicion->cant_muestras)
+        return 0;
+    size_t posicion = (medicion->cant_muestras - 1) * milesimos / 1000;
+    return medicion->muestras[posicion];
+}
+
+static void informar(const char* backend, const char* distribucion, size_t cantidad, const char* operacion, medicion_t* medicion){
+    qsort(medicion->muestras, medicion->cant_muestras, sizeof(uint64_t), comparar_muestras);
+    double por_operacion = medicion->operaciones ? (double)medicion->total / (double)medicion->operaciones : 0;
+    double reservas_por_operacion = medicion->operaciones ? (double)medicion->reservas / (double)medicion->operaciones : 0;
+    printf("%-12s %-14s %10zu %-16s %10.1f %8llu %8llu %8llu %10llu %8.2f", backend, distribucion, cantidad, operacion, por_operacion,
+        (unsigned long long)percentil(medicion, 500), (unsigned long long)percentil(medicion, 990),
+        (unsigned long long)percentil(medicion, 999), (unsigned long long)percentil(medicion, 1000), reservas_por_operacion);
+    if(contador_tlb != SIN_CONTADOR && medicion->operaciones)
+        printf(" %10.3f\n", (double)medicion->fallas_tlb / (double)medicion->operaciones);
+    else
+        printf(" %10s\n", "-");
+}
+
+//Ejecuta una operacion sobre una clave y devuelve 1 si la encontro
+static size_t operar(const backend_t* backend, void* tabla, operacion_t operacion, char* clave){
+    if(operacion == INSERTAR)
+        return backend->insertar(tabla, clave, clave) == 0;
+    if(operacion == OBTENER)
+        return backend->obtener(tabla, clave) != NULL;
+    return backend->quitar(tabla, clave) == 0;
+}
+
+/*
+ * Mide una tanda de operaciones sobre las claves. La primera operacion
+ * de cada tramo de muestreo se mide de a una para los percentiles; el
+ * resto del tramo se mide junto, y todo cuenta en el total.
+ */
+static size_t ejecutar(const backend_t* backend, void* tabla, operacion_t operacion, char** claves, size_t desde, size_t hasta, medicion_t* medicion){
+    size_t paso = paso_de_muestreo(hasta - desde);
+    size_t encontradas = 0;
+    for(size_t i = desde; i < hasta; i += paso){
+        size_t fin = i + paso < hasta ? i + paso : hasta;
+        uint64_t inicio = ahora_ns();
+        encontradas += operar(backend, tabla, operacion, claves[i]);
+        agregar_muestra(medicion, inicio);
+        if(fin - i > 1){
+            inicio = ahora_ns();
+            for(size_t j = i + 1; j < fin; j++)
+                encontradas += operar(backend, tabla, operacion, claves[j]);
+            medicion->total += ahora_ns() - inicio;
+        }
+    }
+    terminar_medicion(medicion, hasta - desde);
+    return encontradas;
+}
+
+static size_t capacidad_inicial(size_t cantidad, size_t carga){
+    if(!carga)
+        return CAPACIDAD_MIN;
+    return cantidad * PORCENTAJE / carga + 1;
+}
+
+/*
+ * Corre todas las mediciones de un backend para una distribucion y una
+ * cantidad de claves.
+ */
+static void medir(const backend_t* backend, const distribucion_t* distribucion, size_t cantidad, size_t carga){
+    static medicion_t medicion;
+    claves_t claves;
+    if(!generar_claves(&claves, distribucion, cantidad)){
+        fprintf(stderr, "No hay memoria para %zu claves\n", cantidad);
+        liberar_claves(&claves);
+        return;
+    }
+
+    iniciar_medicion(&medicion);
+    void* tabla = backend->crear(capacidad_inicial(cantidad, carga));
+    ejecutar(backend, tabla, INSERTAR, claves.presentes, 0, cantidad, &medicion);
+    informar(backend->nombre, distribucion->nombre, cantidad, "insertar", &medicion);
+    uint64_t con_rehash = medicion.total;
+
+    mezclar(claves.presentes, cantidad);
+    iniciar_medicion(&medicion);
+    size_t encontradas = ejecutar(backend, tabla, OBTENER, claves.presentes, 0, cantidad, &medicion);
+    informar(backend->nombre, distribucion->nombre, cantidad, "obtener(esta)", &medicion);
+    if(encontradas != cantidad)
+        fprintf(stderr, "%s: se encontraron %zu de %zu claves\n", backend->nombre, encontradas, cantidad);
+
+    iniciar_medicion(&medicion);
+    ejecutar(backend, tabla, OBTENER, claves.ausentes, 0, cantidad, &medicion);
+    informar(backend->nombre, distribucion->nombre, cantidad, "obtener(no esta)", &medicion);
+
+    iniciar_medicion(&medicion);
+    uint64_t inicio = ahora_ns();
+    size_t recorridas = backend->recorrer(tabla);
+    medicion.total = ahora_ns() - inicio;
+    terminar_medicion(&medicion, recorridas);
+    informar(backend->nombre, distribucion->nombre, cantidad, "recorrer", &medicion);
+
+    iniciar_medicion(&medicion);
+    ejecutar(backend, tabla, QUITAR, claves.presentes, 0, cantidad / 2, &medicion);
+    informar(backend->nombre, distribucion->nombre, cantidad, "quitar", &medicion);
+
+    iniciar_medicion(&medicion);
+    inicio = ahora_ns();
+    backend->destruir(tabla);
+    medicion.total = ahora_ns() - inicio;
+    terminar_medicion(&medicion, cantidad - cantidad / 2);
+    informar(backend->nombre, distribucion->nombre, cantidad, "destruir", &medicion);
+
+    //El costo de los rehash es la diferencia contra insertar en una tabla ya dimensionada
+    iniciar_medicion(&medicion);
+    tabla = backend->crear(capacidad_inicial(cantidad, PORCENTAJE / 2));
+    ejecutar(backend, tabla, INSERTAR, claves.presentes, 0, cantidad, &medicion);
+    medicion.total = con_rehash > medicion.total ? con_rehash - medicion.total : 0;
+    medicion.cant_muestras = 0;
+    informar(backend->nombre, distribucion->nombre, cantidad, "rehash", &medicion);
+    backend->destruir(tabla);
+
+    liberar_claves(&claves);
+}
+
+static size_t leer_cantidades(const char* texto, size_t* cantidades){
+    size_t leidas = 0;
+    while(*texto && leidas < MAX_CANTIDADES){
+        char* fin;
+        cantidades[leidas++] = (size_t)strtoull(texto, &fin, 10);
+        texto = *fin == ',' ? fin + 1 : fin;
+        if(fin == texto && *fin)
+            break;
+    }
+    return leidas;
+}
+
+int main(int argc, char* argv[]){
+    size_t cantidades[MAX_CANTIDADES];
+    size_t cant_cantidades = leer_cantidades(argc > 1 ? argv[1] : CANTIDADES_POR_DEFECTO, cantidades);
+    size_t carga = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : 0;
+
+    leer_reserva();
+    abrir_contador_tlb();
+
+    printf("%-12s %-14s %10s %-16s %10s %8s %8s %8s %10s %8s %10s\n", "backend", "claves", "cantidad", "operacion", "ns/op", "p50", "p99", "p99.9", "max", "res/op", "dTLB/op");
+    for(size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++){
+        for(size_t d = 0; d < sizeof(distribuciones) / sizeof(distribuciones[0]); d++){
+            for(size_t c = 0; c < cant_cantidades; c++)
+                medir(&backends[b], &distribuciones[d], cantidades[c], carga);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,358 @@
+/*
+ * Analizador de la calidad de las funciones de hash sobre un archivo de
+ * claves reales.
+ *
+ * Lee un archivo con una clave por linea (se descartan las repetidas) y
+ * para el hasheador del hash y cada funcion alternativa informa:
+ *  - chi cuadrado de la distribucion de las claves en los baldes,
+ *    normalizado por los grados de libertad (cerca de 1 es una
+ *    distribucion uniforme; muy por encima indica agrupamiento) y su
+ *    desvio en cantidad de desvios estandar.
+ *  - baldes ocupados, cadena maxima y colisiones de balde (claves que
+ *    caen en un balde ya ocupado).
+ *  - colisiones del hash completo (claves distintas con el mismo valor).
+ *  - avalancha: probabilidad promedio de que cambie cada bit de salida
+ *    al invertir un bit de entrada (ideal 0.5) y el peor sesgo.
+ *  - velocidad en GB/s hasheando todas las claves.
+ *
+ * Se compila aparte de las pruebas, desde la raiz del repositorio:
+ *
+ *   gcc -O2 -std=c99 -I. $(ls *.c | grep -v pruebas.c) benchmarks/hash_calidad.c -o hash_calidad -lm
+ *
+ * Uso: ./hash_calidad archivo [baldes]
+ *   baldes: cantidad de baldes para la distribucion (por defecto la
+ *           capacidad que tendria el hash luego de insertar las claves)
+ *
+ * Ejemplo: ./hash_calidad patentes.txt 65537
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "hash_interno.h"
+#include "hash_funciones.h"
+
+#define ERROR -1
+#define EXITO 0
+#define CAPACIDAD_MIN 3
+#define MAX_CARGA 75
+#define MAX_LINEA 4096
+#define BITS_SALIDA 64
+#define MAX_MUESTRAS_AVALANCHA 2000
+#define TIEMPO_MINIMO_NS 200000000ULL
+#define NANOSEGUNDOS 1000000000ULL
+#define SEMILLA_FNV 0
+
+typedef uint64_t (*funcion_hash_t)(const char* clave, size_t largo);
+
+typedef struct funcion{
+    const char* nombre;
+    funcion_hash_t hashear;
+}funcion_t;
+
+typedef struct claves{
+    char** claves;
+    size_t* largos;
+    size_t cantidad;
+    size_t bytes;
+}claves_t;
+
+static uint64_t con_hasheador(const char* clave, size_t largo){
+    (void)largo;
+    return (uint64_t)hasheador(clave);
+}
+
+static uint64_t con_fnv1a(const char* clave, size_t largo){
+    return hash_fnv1a(clave, largo, SEMILLA_FNV);
+}
+
+static uint64_t con_fnv1a_mezclado(const char* clave, size_t largo){
+    return hash_mezclar(hash_fnv1a(clave, largo, SEMILLA_FNV));
+}
+
+static uint64_t con_djb2(const char* clave, size_t largo){
+    uint64_t valor = 5381;
+    for(size_t i = 0; i < largo; i++)
+        valor = valor * 33 + (unsigned char)clave[i];
+    return valor;
+}
+
+static const funcion_t funciones[] = {
+    {"hasheador", con_hasheador},
+    {"fnv1a", con_fnv1a},
+    {"fnv1a+mezcla", con_fnv1a_mezclado},
+    {"djb2", con_djb2},
+};
+
+#define CANT_FUNCIONES (sizeof(funciones) / sizeof(funciones[0]))
+
+static uint64_t ahora_ns(){
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (uint64_t)ahora.tv_sec * NANOSEGUNDOS + (uint64_t)ahora.tv_nsec;
+}
+
+static int comparar_claves(const void* a, const void* b){
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static int comparar_valores(const void* a, const void* b){
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void liberar_claves(claves_t* claves){
+    for(size_t i = 0; i < claves->cantidad; i++)
+        free(claves->claves[i]);
+    free(claves->claves);
+    free(claves->largos);
+}
+
+/*
+ * Lee las claves del archivo, una por linea, ignorando las lineas
+ * vacias y las claves repetidas.
+ */
+static int leer_claves(const char* ruta, claves_t* claves){
+    FILE* archivo = fopen(ruta, "r");
+    if(!archivo)
+        return ERROR;
+    size_t capacidad = 1024;
+    memset(claves, 0, sizeof(claves_t));
+    claves->claves = malloc(capacidad * sizeof(char*));
+    char linea[MAX_LINEA];
+    while(claves->claves && fgets(linea, sizeof(linea), archivo)){
+        linea[strcspn(linea, "\r\n")] = 0;
+        if(!linea[0])
+            continue;
+        if(claves->cantidad == capacidad){
+            char** nuevas = realloc(claves->claves, 2 * capacidad * sizeof(char*));
+            if(!nuevas)
+                break;
+            claves->claves = nuevas;
+            capacidad *= 2;
+        }
+        size_t largo = strlen(linea);
+        char* clave = malloc(largo + 1);
+        if(!clave)
+            break;
+        memcpy(clave, linea, largo + 1);
+        claves->claves[claves->cantidad++] = clave;
+    }
+    bool completo = feof(archivo) && claves->claves;
+    fclose(archivo);
+    if(!completo){
+        liberar_claves(claves);
+        return ERROR;
+    }
+
+    qsort(claves->claves, claves->cantidad, sizeof(char*), comparar_claves);
+    size_t distintas = 0;
+    for(size_t i = 0; i < claves->cantidad; i++){
+        if(distintas && strcmp(claves->claves[distintas - 1], claves->claves[i]) == 0)
+            free(claves->claves[i]);
+        else
+            claves->claves[distintas++] = claves->claves[i];
+    }
+    claves->cantidad = distintas;
+    claves->largos = malloc((distintas ? distintas : 1) * sizeof(size_t));
+    if(!claves->largos){
+        liberar_claves(claves);
+        return ERROR;
+    }
+    for(size_t i = 0; i < distintas; i++){
+        claves->largos[i] = strlen(claves->claves[i]);
+        claves->bytes += claves->largos[i];
+    }
+    return EXITO;
+}
+
+/*
+ * Cuenta los baldes que ocupan las primeras cantidad claves en la
+ * capacidad dada, marcandolos en ocupados.
+ */
+static size_t contar_ocupados(const claves_t* claves, size_t cantidad, size_t capacidad, bool* ocupados){
+    memset(ocupados, 0, capacidad * sizeof(bool));
+    size_t cuenta = 0;
+    for(size_t i = 0; i < cantidad; i++){
+        size_t balde = hasheador(claves->claves[i]) % capacidad;
+        if(!ocupados[balde]){
+            ocupados[balde] = true;
+            cuenta++;
+        }
+    }
+    return cuenta;
+}
+
+/*
+ * Devuelve la capacidad que tendria el hash despues de insertar las
+ * claves en orden. Simula lo que hace hash_insertar: crece cuando los
+ * baldes ocupados llegan al factor de carga, no la cantidad de claves.
+ * Devuelve 0 en caso de error.
+ */
+static size_t capacidad_del_hash(const claves_t* claves){
+    size_t capacidad = CAPACIDAD_MIN;
+    bool* ocupados = calloc(capacidad, sizeof(bool));
+    size_t cuenta = 0;
+    for(size_t i = 0; i < claves->cantidad && ocupados; i++){
+        size_t balde = hasheador(claves->claves[i]) % capacidad;
+        if(!ocupados[balde]){
+            ocupados[balde] = true;
+            cuenta++;
+        }
+        if(cuenta * 100 / capacidad < MAX_CARGA)
+            continue;
+        capacidad = proximo_primo(capacidad);
+        bool* nuevos = realloc(ocupados, capacidad * sizeof(bool));
+        if(!nuevos){
+            free(ocupados);
+            return 0;
+        }
+        ocupados = nuevos;
+        cuenta = contar_ocupados(claves, i + 1, capacidad, ocupados);
+    }
+    if(!ocupados)
+        return 0;
+    free(ocupados);
+    return capacidad;
+}
+
+/*
+ * Informa la distribucion de los valores en los baldes y las colisiones
+ * del hash completo. Ordena los valores.
+ */
+static void analizar_distribucion(uint64_t* valores, size_t cantidad, size_t baldes){
+    size_t* cuenta = calloc(baldes, sizeof(size_t));
+    if(!cuenta){
+        printf("  sin memoria para los baldes\n");
+        return;
+    }
+    for(size_t i = 0; i < cantidad; i++)
+        cuenta[valores[i] % baldes]++;
+    double esperado = (double)cantidad / (double)baldes;
+    double chi = 0;
+    size_t ocupados = 0, maxima = 0;
+    for(size_t i = 0; i < baldes; i++){
+        double diferencia = (double)cuenta[i] - esperado;
+        chi += diferencia * diferencia / esperado;
+        if(cuenta[i])
+            ocupados++;
+        if(cuenta[i] > maxima)
+            maxima = cuenta[i];
+    }
+    free(cuenta);
+    double libertad = (double)(baldes - 1);
+    printf("  chi cuadrado: %.3f (%+.1f desvios)\n", chi / libertad, (chi - libertad) / sqrt(2 * libertad));
+    printf("  baldes ocupados: %zu de %zu, cadena maxima %zu, colisiones de balde %zu\n", ocupados, baldes, maxima, cantidad - ocupados);
+
+    qsort(valores, cantidad, sizeof(uint64_t), comparar_valores);
+    size_t colisiones = 0;
+    for(size_t i = 1; i < cantidad; i++)
+        if(valores[i] == valores[i - 1])
+            colisiones++;
+    printf("  colisiones del hash completo: %zu\n", colisiones);
+}
+
+/*
+ * Invierte cada bit de una muestra de claves y cuenta cuantas veces
+ * cambia cada bit de salida. No invierte bits que dejarian un 0 en la
+ * clave, porque el hasheador la cortaria ahi.
+ */
+static void analizar_avalancha(funcion_hash_t hashear, const claves_t* claves){
+    size_t cambios[BITS_SALIDA] = {0};
+    size_t pruebas = 0;
+    size_t paso = claves->cantidad / MAX_MUESTRAS_AVALANCHA + 1;
+    char copia[MAX_LINEA];
+    for(size_t i = 0; i < claves->cantidad; i += paso){
+        size_t largo = claves->largos[i];
+        memcpy(copia, claves->claves[i], largo + 1);
+        uint64_t original = hashear(copia, largo);
+        for(size_t byte = 0; byte < largo; byte++){
+            for(int bit = 0; bit < 8; bit++){
+                char mascara = (char)(1 << bit);
+                if((copia[byte] ^ mascara) == 0)
+                    continue;
+                copia[byte] ^= mascara;
+                uint64_t diferencia = original ^ hashear(copia, largo);
+                copia[byte] ^= mascara;
+                for(int salida = 0; salida < BITS_SALIDA; salida++)
+                    cambios[salida] += (diferencia >> salida) & 1;
+                pruebas++;
+            }
+        }
+    }
+    if(!pruebas)
+        return;
+    double promedio = 0, peor = 0;
+    for(int salida = 0; salida < BITS_SALIDA; salida++){
+        double probabilidad = (double)cambios[salida] / (double)pruebas;
+        promedio += probabilidad;
+        if(fabs(probabilidad - 0.5) > peor)
+            peor = fabs(probabilidad - 0.5);
+    }
+    printf("  avalancha: %.3f promedio, peor sesgo %.3f (%zu bits invertidos)\n", promedio / BITS_SALIDA, peor, pruebas);
+}
+
+/*
+ * Hashea todas las claves las veces necesarias para medir al menos
+ * TIEMPO_MINIMO_NS e informa los bytes por segundo.
+ */
+static void medir_velocidad(funcion_hash_t hashear, const claves_t* claves){
+    volatile uint64_t acumulado = 0;
+    size_t vueltas = 0;
+    uint64_t inicio = ahora_ns(), transcurrido;
+    do{
+        for(size_t i = 0; i < claves->cantidad; i++)
+            acumulado += hashear(claves->claves[i], claves->largos[i]);
+        vueltas++;
+        transcurrido = ahora_ns() - inicio;
+    }while(transcurrido < TIEMPO_MINIMO_NS);
+    double bytes = (double)claves->bytes * (double)vueltas;
+    printf("  velocidad: %.3f GB/s, %.1f ns/clave\n", bytes / (double)transcurrido, (double)transcurrido / ((double)claves->cantidad * (double)vueltas));
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 2){
+        fprintf(stderr, "Uso: %s archivo [baldes]\n", argv[0]);
+        return 1;
+    }
+    claves_t claves;
+    if(leer_claves(argv[1], &claves) == ERROR){
+        fprintf(stderr, "No se pudo leer %s\n", argv[1]);
+        return 1;
+    }
+    if(!claves.cantidad){
+        fprintf(stderr, "%s no tiene claves\n", argv[1]);
+        liberar_claves(&claves);
+        return 1;
+    }
+    size_t baldes = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : capacidad_del_hash(&claves);
+    if(argc <= 2 && !baldes){
+        fprintf(stderr, "No hay memoria para simular el hash\n");
+        liberar_claves(&claves);
+        return 1;
+    }
+    if(baldes < 2)
+        baldes = 2;
+    uint64_t* valores = malloc(claves.cantidad * sizeof(uint64_t));
+    if(!valores){
+        liberar_claves(&claves);
+        return 1;
+    }
+    printf("%zu claves distintas, %zu bytes, %zu baldes\n", claves.cantidad, claves.bytes, baldes);
+    for(size_t f = 0; f < CANT_FUNCIONES; f++){
+        printf("\n%s\n", funciones[f].nombre);
+        for(size_t i = 0; i < claves.cantidad; i++)
+            valores[i] = funciones[f].hashear(claves.claves[i], claves.largos[i]);
+        analizar_distribucion(valores, claves.cantidad, baldes);
+        analizar_avalancha(funciones[f].hashear, &claves);
+        medir_velocidad(funciones[f].hashear, &claves);
+    }
+    free(valores);
+    liberar_claves(&claves);
+    return 0;
+}
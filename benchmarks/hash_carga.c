@@ -0,0 +1,376 @@
+/*
+ * Generador de carga mixta al estilo YCSB para el hash.
+ *
+ * Carga una cantidad inicial de claves y despues ejecuta una mezcla
+ * configurable de lecturas, inserciones, actualizaciones y bajas,
+ * eligiendo las claves con distribucion uniforme, Zipf o "ultimas"
+ * (las insertadas mas recientemente son las mas consultadas). Cada
+ * intervalo (una cantidad fija de operaciones) informa el rendimiento
+ * y la latencia de cola, de forma que se vean los picos que producen
+ * los rehash bajo rotacion de claves.
+ *
+ * El hash no es seguro para varios hilos; con mas de un hilo todas las
+ * operaciones se serializan con un mutex, que es como lo usa hoy una
+ * aplicacion concurrente.
+ *
+ * Se compila aparte de las pruebas, desde la raiz del repositorio:
+ *
+ *   gcc -O2 -std=c99 -pthread -I. $(ls *.c | grep -v pruebas.c) benchmarks/hash_carga.c -lm -o hash_carga
+ *
+ * Uso: ./hash_carga [opciones]
+ *   -n claves iniciales            (por defecto 100000)
+ *   -o operaciones totales         (por defecto 1000000)
+ *   -m lectura,insercion,actualizacion,baja en porcentajes (por defecto 50,20,20,10)
+ *   -d uniforme|zipf|ultimas       (por defecto zipf)
+ *   -z constante de Zipf, distinta de 1 (por defecto 0.99)
+ *   -h hilos                       (por defecto 1)
+ *   -i operaciones por intervalo   (por defecto 100000)
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "hash.h"
+
+#define NANOSEGUNDOS 1000000000ULL
+#define LARGO_CLAVE 24
+#define PORCENTAJE 100
+#define MAX_MUESTRAS 65536
+#define MAX_HILOS 64
+#define IGUAL 0
+
+typedef enum distribucion{
+    UNIFORME,
+    ZIPF,
+    ULTIMAS,
+}distribucion_t;
+
+typedef struct configuracion{
+    size_t claves_iniciales;
+    size_t operaciones;
+    size_t mezcla[4];
+    distribucion_t distribucion;
+    double constante_zipf;
+    size_t hilos;
+    size_t intervalo;
+}configuracion_t;
+
+/*
+ * Generador de numeros con distribucion Zipf sobre [0, cantidad), con
+ * el metodo de Gray et al. que usa YCSB. La cantidad puede crecer a
+ * medida que se insertan claves; zeta se actualiza incrementalmente.
+ */
+typedef struct zipf{
+    double constante;
+    double zeta_2;
+    double zeta_n;
+    size_t cantidad;
+}zipf_t;
+
+/*
+ * Estado compartido entre los hilos. Las claves se identifican por un
+ * numero: las que estan en [primera, siguiente) son las vivas (las
+ * bajas quitan desde la mas antigua y las inserciones agregan al final).
+ */
+typedef struct carga{
+    configuracion_t* configuracion;
+    hash_t* hash;
+    pthread_mutex_t mutex;
+    size_t primera;
+    size_t siguiente;
+    size_t realizadas;
+    zipf_t zipf;
+}carga_t;
+
+/*
+ * Latencias de un intervalo. Si hay mas operaciones que MAX_MUESTRAS
+ * las muestras son un muestreo uniforme de todas (reservoir sampling),
+ * y el maximo se lleva aparte para no perder los picos de los rehash.
+ */
+typedef struct intervalo{
+    uint64_t muestras[MAX_MUESTRAS];
+    size_t cant_muestras;
+    size_t operaciones;
+    uint64_t maximo;
+}intervalo_t;
+
+typedef struct hilo{
+    carga_t* carga;
+    pthread_t id;
+    uint64_t estado;
+    intervalo_t* intervalo;
+    pthread_mutex_t* mutex_intervalo;
+}hilo_t;
+
+static uint64_t ahora_ns(void){
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (uint64_t)ahora.tv_sec * NANOSEGUNDOS + (uint64_t)ahora.tv_nsec;
+}
+
+//Generador xorshift64* con estado propio para cada hilo
+static uint64_t aleatorio(uint64_t* estado){
+    *estado ^= *estado >> 12;
+    *estado ^= *estado << 25;
+    *estado ^= *estado >> 27;
+    return *estado * 0x2545f4914f6cdd1dULL;
+}
+
+static double aleatorio_unitario(uint64_t* estado){
+    return (double)(aleatorio(estado) >> 11) / (double)(1ULL << 53);
+}
+
+static void zipf_crecer(zipf_t* zipf, size_t cantidad){
+    for(size_t i = zipf->cantidad + 1; i <= cantidad; i++)
+        zipf->zeta_n += 1.0 / pow((double)i, zipf->constante);
+    zipf->cantidad = cantidad;
+}
+
+static void zipf_iniciar(zipf_t* zipf, double constante, size_t cantidad){
+    zipf->constante = constante;
+    zipf->zeta_2 = 1.0 + 1.0 / pow(2.0, constante);
+    zipf->zeta_n = 0;
+    zipf->cantidad = 0;
+    zipf_crecer(zipf, cantidad);
+}
+
+//Devuelve un rango en [0, cantidad), donde 0 es el mas frecuente
+static size_t zipf_siguiente(zipf_t* zipf, uint64_t* estado){
+    double n = (double)zipf->cantidad;
+    double alfa = 1.0 / (1.0 - zipf->constante);
+    double eta = (1.0 - pow(2.0 / n, 1.0 - zipf->constante)) / (1.0 - zipf->zeta_2 / zipf->zeta_n);
+    double u = aleatorio_unitario(estado);
+    double uz = u * zipf->zeta_n;
+    if(uz < 1.0)
+        return 0;
+    if(uz < zipf->zeta_2)
+        return 1;
+    size_t rango = (size_t)(n * pow(eta * u - eta + 1.0, alfa));
+    return rango < zipf->cantidad ? rango : zipf->cantidad - 1;
+}
+
+static void escribir_clave(char* destino, size_t numero){
+    snprintf(destino, LARGO_CLAVE, "usuario%016zx", (size_t)(numero * 0x9e3779b97f4a7c15ULL));
+}
+
+/*
+ * Elige el numero de una clave viva segun la distribucion configurada.
+ * Debe llamarse con el mutex tomado.
+ */
+static size_t elegir_clave(carga_t* carga, uint64_t* estado){
+    size_t vivas = carga->siguiente - carga->primera;
+    if(!vivas)
+        return carga->primera;
+    switch(carga->configuracion->distribucion){
+        case UNIFORME:
+            return carga->primera + (size_t)(aleatorio(estado) % vivas);
+        case ULTIMAS:
+            return carga->siguiente - 1 - zipf_siguiente(&carga->zipf, estado) % vivas;
+        default:
+            //Se dispersa el rango para que las claves frecuentes no sean contiguas
+            return carga->primera + (zipf_siguiente(&carga->zipf, estado) * 0x9e3779b97f4a7c15ULL) % vivas;
+    }
+}
+
+static char* duplicar_clave(const char* clave){
+    char* copia = malloc(strlen(clave) + 1);
+    if(copia)
+        strcpy(copia, clave);
+    return copia;
+}
+
+/*
+ * Ejecuta una operacion elegida segun la mezcla configurada.
+ */
+static void operar(carga_t* carga, uint64_t* estado){
+    char clave[LARGO_CLAVE];
+    size_t* mezcla = carga->configuracion->mezcla;
+    size_t tirada = (size_t)(aleatorio(estado) % PORCENTAJE);
+    pthread_mutex_lock(&carga->mutex);
+    if(tirada < mezcla[0]){
+        escribir_clave(clave, elegir_clave(carga, estado));
+        hash_obtener(carga->hash, clave);
+    }else if(tirada < mezcla[0] + mezcla[1]){
+        escribir_clave(clave, carga->siguiente++);
+        hash_insertar(carga->hash, clave, duplicar_clave(clave));
+        if(carga->siguiente - carga->primera > carga->zipf.cantidad)
+            zipf_crecer(&carga->zipf, carga->siguiente - carga->primera);
+    }else if(tirada < mezcla[0] + mezcla[1] + mezcla[2]){
+        escribir_clave(clave, elegir_clave(carga, estado));
+        hash_insertar(carga->hash, clave, duplicar_clave(clave));
+    }else if(carga->primera < carga->siguiente){
+        escribir_clave(clave, carga->primera++);
+        hash_quitar(carga->hash, clave);
+    }
+    pthread_mutex_unlock(&carga->mutex);
+}
+
+static int comparar_muestras(const void* a, const void* b){
+    uint64_t primero = *(const uint64_t*)a, segundo = *(const uint64_t*)b;
+    return (primero > segundo) - (primero < segundo);
+}
+
+static uint64_t percentil(intervalo_t* intervalo, size_t milesimos){
+    if(!intervalo->cant_muestras)
+        return 0;
+    return intervalo->muestras[(intervalo->cant_muestras - 1) * milesimos / 1000];
+}
+
+static void informar_intervalo(intervalo_t* intervalo, size_t numero, uint64_t duracion, size_t cantidad){
+    qsort(intervalo->muestras, intervalo->cant_muestras, sizeof(uint64_t), comparar_muestras);
+    double segundos = (double)duracion / (double)NANOSEGUNDOS;
+    printf("%8zu %12.0f %10zu %8llu %8llu %8llu %10llu\n", numero, (double)intervalo->operaciones / segundos, cantidad,
+        (unsigned long long)percentil(intervalo, 500), (unsigned long long)percentil(intervalo, 990),
+        (unsigned long long)percentil(intervalo, 999), (unsigned long long)intervalo->maximo);
+    intervalo->cant_muestras = 0;
+    intervalo->operaciones = 0;
+    intervalo->maximo = 0;
+}
+
+/*
+ * Cuerpo de cada hilo: toma operaciones del total compartido hasta
+ * agotarlo, midiendo la latencia de cada una (incluida la espera del
+ * mutex, que es lo que ve quien llama).
+ */
+static void* trabajar(void* aux){
+    hilo_t* hilo = aux;
+    carga_t* carga = hilo->carga;
+    while(true){
+        pthread_mutex_lock(hilo->mutex_intervalo);
+        bool terminado = carga->realizadas >= carga->configuracion->operaciones;
+        carga->realizadas++;
+        pthread_mutex_unlock(hilo->mutex_intervalo);
+        if(terminado)
+            break;
+        uint64_t inicio = ahora_ns();
+        operar(carga, &hilo->estado);
+        uint64_t duracion = ahora_ns() - inicio;
+        pthread_mutex_lock(hilo->mutex_intervalo);
+        intervalo_t* intervalo = hilo->intervalo;
+        intervalo->operaciones++;
+        if(duracion > intervalo->maximo)
+            intervalo->maximo = duracion;
+        if(intervalo->cant_muestras < MAX_MUESTRAS){
+            intervalo->muestras[intervalo->cant_muestras++] = duracion;
+        }else{
+            uint64_t lugar = aleatorio(&hilo->estado) % intervalo->operaciones;
+            if(lugar < MAX_MUESTRAS)
+                intervalo->muestras[lugar] = duracion;
+        }
+        pthread_mutex_unlock(hilo->mutex_intervalo);
+    }
+    return NULL;
+}
+
+static void cargar_iniciales(carga_t* carga){
+    char clave[LARGO_CLAVE];
+    for(size_t i = 0; i < carga->configuracion->claves_iniciales; i++){
+        escribir_clave(clave, carga->siguiente++);
+        hash_insertar(carga->hash, clave, duplicar_clave(clave));
+    }
+}
+
+static bool leer_mezcla(const char* texto, size_t* mezcla){
+    unsigned long valores[4];
+    if(sscanf(texto, "%lu,%lu,%lu,%lu", &valores[0], &valores[1], &valores[2], &valores[3]) != 4)
+        return false;
+    for(size_t i = 0; i < 4; i++)
+        mezcla[i] = (size_t)valores[i];
+    return mezcla[0] + mezcla[1] + mezcla[2] + mezcla[3] == PORCENTAJE;
+}
+
+static bool leer_configuracion(int argc, char* argv[], configuracion_t* configuracion){
+    int opcion;
+    while((opcion = getopt(argc, argv, "n:o:m:d:z:h:i:")) != -1){
+        switch(opcion){
+            case 'n': configuracion->claves_iniciales = (size_t)strtoull(optarg, NULL, 10); break;
+            case 'o': configuracion->operaciones = (size_t)strtoull(optarg, NULL, 10); break;
+            case 'm':
+                if(!leer_mezcla(optarg, configuracion->mezcla))
+                    return false;
+                break;
+            case 'd':
+                if(strcmp(optarg, "uniforme") == IGUAL)
+                    configuracion->distribucion = UNIFORME;
+                else if(strcmp(optarg, "ultimas") == IGUAL)
+                    configuracion->distribucion = ULTIMAS;
+                else if(strcmp(optarg, "zipf") == IGUAL)
+                    configuracion->distribucion = ZIPF;
+                else
+                    return false;
+                break;
+            case 'z': configuracion->constante_zipf = strtod(optarg, NULL); break;
+            case 'h': configuracion->hilos = (size_t)strtoull(optarg, NULL, 10); break;
+            case 'i': configuracion->intervalo = (size_t)strtoull(optarg, NULL, 10); break;
+            default: return false;
+        }
+    }
+    //Con constante 1 el exponente 1 / (1 - constante) de zipf_siguiente es infinito
+    if(configuracion->constante_zipf == 1.0)
+        return false;
+    return configuracion->hilos > 0 && configuracion->hilos <= MAX_HILOS && configuracion->intervalo > 0;
+}
+
+int main(int argc, char* argv[]){
+    configuracion_t configuracion = {100000, 1000000, {50, 20, 20, 10}, ZIPF, 0.99, 1, 100000};
+    if(!leer_configuracion(argc, argv, &configuracion)){
+        fprintf(stderr, "Uso: %s [-n claves] [-o operaciones] [-m l,i,a,b] [-d uniforme|zipf|ultimas] [-z constante] [-h hilos] [-i intervalo]\n", argv[0]);
+        return 1;
+    }
+
+    static carga_t carga;
+    static intervalo_t intervalo;
+    carga.configuracion = &configuracion;
+    carga.hash = hash_crear(free, 3);
+    pthread_mutex_init(&carga.mutex, NULL);
+    zipf_iniciar(&carga.zipf, configuracion.constante_zipf, configuracion.claves_iniciales ? configuracion.claves_iniciales : 1);
+    cargar_iniciales(&carga);
+
+    pthread_mutex_t mutex_intervalo;
+    pthread_mutex_init(&mutex_intervalo, NULL);
+    hilo_t hilos[MAX_HILOS];
+    printf("%8s %12s %10s %8s %8s %8s %10s\n", "intervalo", "ops/s", "claves", "p50", "p99", "p99.9", "max");
+    uint64_t inicio = ahora_ns();
+    for(size_t i = 0; i < configuracion.hilos; i++){
+        hilos[i] = (hilo_t){&carga, 0, 0x2545f4914f6cdd1dULL + i * 0x9e3779b97f4a7c15ULL, &intervalo, &mutex_intervalo};
+        pthread_create(&hilos[i].id, NULL, trabajar, &hilos[i]);
+    }
+
+    //El hilo principal informa cada vez que se completa un intervalo de operaciones
+    size_t numero = 0;
+    uint64_t inicio_intervalo = inicio;
+    bool terminado = false;
+    while(!terminado){
+        struct timespec espera = {0, 1000000};
+        nanosleep(&espera, NULL);
+        pthread_mutex_lock(&mutex_intervalo);
+        terminado = carga.realizadas >= configuracion.operaciones;
+        if(intervalo.operaciones >= configuracion.intervalo || (terminado && intervalo.operaciones)){
+            uint64_t fin = ahora_ns();
+            pthread_mutex_lock(&carga.mutex);
+            size_t cantidad = hash_cantidad(carga.hash);
+            pthread_mutex_unlock(&carga.mutex);
+            informar_intervalo(&intervalo, ++numero, fin - inicio_intervalo, cantidad);
+            inicio_intervalo = fin;
+        }
+        pthread_mutex_unlock(&mutex_intervalo);
+    }
+    for(size_t i = 0; i < configuracion.hilos; i++)
+        pthread_join(hilos[i].id, NULL);
+    if(intervalo.operaciones)
+        informar_intervalo(&intervalo, ++numero, ahora_ns() - inicio_intervalo, hash_cantidad(carga.hash));
+
+    double segundos = (double)(ahora_ns() - inicio) / (double)NANOSEGUNDOS;
+    printf("Total: %zu operaciones en %.2f s (%.0f ops/s)\n", configuracion.operaciones, segundos, (double)configuracion.operaciones / segundos);
+    hash_destruir(carga.hash);
+    pthread_mutex_destroy(&carga.mutex);
+    pthread_mutex_destroy(&mutex_intervalo);
+    return 0;
+}
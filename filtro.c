@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "hash_funciones.h"
+#include "filtro.h"
+#include "reserva.h"
+
+#define VACIO 0
+#define IGUAL 0
+#define CONTADORES_POR_BLOQUE 64
+#define BITS_POSICION 6
+#define MASCARA_POSICION 63
+#define MIN_FUNCIONES 1
+#define MAX_FUNCIONES 8
+#define CONTADOR_SATURADO UINT8_MAX
+#define SEMILLA_FILTRO 0x9e3779b97f4a7c15ULL
+#define MAGIA "FILTRO01"
+#define LARGO_MAGIA 8
+
+struct filtro{
+    uint8_t* contadores;
+    size_t bloques;
+    size_t funciones;
+};
+
+typedef struct cabecera{
+    char magia[LARGO_MAGIA];
+    uint64_t bloques;
+    uint64_t funciones;
+}cabecera_t;
+
+/*
+ * Reserva los contadores en 0 alineados a una linea de cache, para que
+ * cada bloque ocupe una sola. Devuelve NULL en caso de error.
+ */
+static uint8_t* reservar_contadores(size_t bloques){
+    if(bloques > SIZE_MAX / CONTADORES_POR_BLOQUE)
+        return NULL;
+    return reserva_obtener(NULL, bloques * CONTADORES_POR_BLOQUE);
+}
+
+filtro_t* filtro_crear(size_t cantidad, size_t bits_por_clave){
+    if(!bits_por_clave)
+        return NULL;
+    filtro_t* filtro = calloc(1, sizeof(filtro_t));
+    if(!filtro)
+        return NULL;
+    filtro->bloques = (cantidad * bits_por_clave) / CONTADORES_POR_BLOQUE + 1;
+    //La cantidad optima de funciones es bits_por_clave * ln(2)
+    filtro->funciones = (bits_por_clave * 69 + 50) / 100;
+    if(filtro->funciones < MIN_FUNCIONES)
+        filtro->funciones = MIN_FUNCIONES;
+    if(filtro->funciones > MAX_FUNCIONES)
+        filtro->funciones = MAX_FUNCIONES;
+    filtro->contadores = reservar_contadores(filtro->bloques);
+    if(!filtro->contadores){
+        free(filtro);
+        return NULL;
+    }
+    return filtro;
+}
+
+/*
+ * Calcula el hash de la clave, devuelve el bloque que le corresponde y
+ * deja en posiciones los bits de donde se sacan las posiciones dentro
+ * del bloque.
+ */
+static uint8_t* bloque_de(filtro_t* filtro, const char* clave, uint64_t* posiciones){
+    uint64_t numero = hash_fnv1a(clave, strlen(clave), SEMILLA_FILTRO);
+    *posiciones = hash_mezclar(numero);
+    return filtro->contadores + (size_t)(numero % filtro->bloques) * CONTADORES_POR_BLOQUE;
+}
+
+void filtro_agregar(filtro_t* filtro, const char* clave){
+    if(!filtro || !clave)
+        return;
+    uint64_t posiciones;
+    uint8_t* bloque = bloque_de(filtro, clave, &posiciones);
+    for(size_t i = 0; i < filtro->funciones; i++){
+        uint8_t* contador = &bloque[(posiciones >> (i * BITS_POSICION)) & MASCARA_POSICION];
+        if(*contador != CONTADOR_SATURADO)
+            (*contador)++;
+    }
+}
+
+void filtro_quitar(filtro_t* filtro, const char* clave){
+    if(!filtro || !clave)
+        return;
+    uint64_t posiciones;
+    uint8_t* bloque = bloque_de(filtro, clave, &posiciones);
+    for(size_t i = 0; i < filtro->funciones; i++){
+        uint8_t* contador = &bloque[(posiciones >> (i * BITS_POSICION)) & MASCARA_POSICION];
+        //Un contador saturado ya no se sabe cuantas claves cuenta
+        if(*contador != VACIO && *contador != CONTADOR_SATURADO)
+            (*contador)--;
+    }
+}
+
+bool filtro_puede_contener(filtro_t* filtro, const char* clave){
+    if(!filtro || !clave)
+        return true;
+    uint64_t posiciones;
+    uint8_t* bloque = bloque_de(filtro, clave, &posiciones);
+    for(size_t i = 0; i < filtro->funciones; i++){
+        if(bloque[(posiciones >> (i * BITS_POSICION)) & MASCARA_POSICION] == VACIO)
+            return false;
+    }
+    return true;
+}
+
+size_t filtro_exportar(filtro_t* filtro, void* buffer, size_t tamanio){
+    if(!filtro)
+        return VACIO;
+    size_t necesario = sizeof(cabecera_t) + filtro->bloques * sizeof(uint64_t);
+    if(!buffer || tamanio < necesario)
+        return necesario;
+    cabecera_t cabecera;
+    memcpy(cabecera.magia, MAGIA, LARGO_MAGIA);
+    cabecera.bloques = filtro->bloques;
+    cabecera.funciones = filtro->funciones;
+    memcpy(buffer, &cabecera, sizeof(cabecera));
+    uint8_t* destino = (uint8_t*)buffer + sizeof(cabecera);
+    for(size_t i = 0; i < filtro->bloques; i++){
+        uint64_t bits = 0;
+        const uint8_t* bloque = filtro->contadores + i * CONTADORES_POR_BLOQUE;
+        for(size_t j = 0; j < CONTADORES_POR_BLOQUE; j++){
+            if(bloque[j] != VACIO)
+                bits |= (uint64_t)1 << j;
+        }
+        memcpy(destino + i * sizeof(bits), &bits, sizeof(bits));
+    }
+    return necesario;
+}
+
+filtro_t* filtro_importar(const void* datos, size_t tamanio){
+    cabecera_t cabecera;
+    if(!datos || tamanio < sizeof(cabecera))
+        return NULL;
+    memcpy(&cabecera, datos, sizeof(cabecera));
+    if(memcmp(cabecera.magia, MAGIA, LARGO_MAGIA) != IGUAL || !cabecera.bloques)
+        return NULL;
+    if(cabecera.funciones < MIN_FUNCIONES || cabecera.funciones > MAX_FUNCIONES)
+        return NULL;
+    if((tamanio - sizeof(cabecera)) / sizeof(uint64_t) < cabecera.bloques)
+        return NULL;
+    filtro_t* filtro = calloc(1, sizeof(filtro_t));
+    if(!filtro)
+        return NULL;
+    filtro->bloques = (size_t)cabecera.bloques;
+    filtro->funciones = (size_t)cabecera.funciones;
+    filtro->contadores = reservar_contadores(filtro->bloques);
+    if(!filtro->contadores){
+        free(filtro);
+        return NULL;
+    }
+    const uint8_t* origen = (const uint8_t*)datos + sizeof(cabecera);
+    for(size_t i = 0; i < filtro->bloques; i++){
+        uint64_t bits;
+        memcpy(&bits, origen + i * sizeof(bits), sizeof(bits));
+        for(size_t j = 0; j < CONTADORES_POR_BLOQUE; j++)
+            filtro->contadores[i * CONTADORES_POR_BLOQUE + j] = (uint8_t)((bits >> j) & 1);
+    }
+    return filtro;
+}
+
+void filtro_destruir(filtro_t* filtro){
+    if(!filtro)
+        return;
+    reserva_liberar(filtro->contadores);
+    free(filtro);
+}
@@ -0,0 +1,68 @@
+#ifndef __FILTRO_H__
+#define __FILTRO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Filtro de pertenencia (filtro de Bloom por bloques con contadores).
+ * Responde si una clave puede estar en el conjunto o si seguro no esta:
+ * puede dar falsos positivos pero nunca falsos negativos. Todas las
+ * posiciones de una clave caen en el mismo bloque de 64 contadores, por
+ * lo que cada consulta toca una sola linea de cache. Al usar contadores
+ * en lugar de bits, las claves se pueden quitar.
+ */
+typedef struct filtro filtro_t;
+
+/*
+ * Crea un filtro dimensionado para la cantidad de claves dada, usando
+ * bits_por_clave posiciones por clave (a mas posiciones, menos falsos
+ * positivos).
+ *
+ * Devuelve el filtro creado o NULL en caso de error.
+ */
+filtro_t* filtro_crear(size_t cantidad, size_t bits_por_clave);
+
+/*
+ * Agrega la clave al filtro.
+ */
+void filtro_agregar(filtro_t* filtro, const char* clave);
+
+/*
+ * Quita la clave del filtro. La clave tiene que haber sido agregada
+ * antes; quitar una clave que no se agrego produce falsos negativos.
+ */
+void filtro_quitar(filtro_t* filtro, const char* clave);
+
+/*
+ * Devuelve false si la clave seguro no esta en el filtro o true si
+ * puede estar (o en caso de error).
+ */
+bool filtro_puede_contener(filtro_t* filtro, const char* clave);
+
+/*
+ * Escribe en el buffer una version compacta del filtro (un bit por
+ * posicion) que puede enviarse a otros procesos y abrirse con
+ * filtro_importar.
+ *
+ * Devuelve la cantidad de bytes que ocupa la version exportada. Si el
+ * buffer es NULL o no alcanza no se escribe nada, de forma que se
+ * puede consultar el tamaño necesario antes de exportar. Devuelve 0 en
+ * caso de error.
+ */
+size_t filtro_exportar(filtro_t* filtro, void* buffer, size_t tamanio);
+
+/*
+ * Crea un filtro a partir de un filtro exportado. El filtro importado
+ * solo sirve para consultas: no se le deben agregar ni quitar claves.
+ *
+ * Devuelve el filtro creado o NULL en caso de error.
+ */
+filtro_t* filtro_importar(const void* datos, size_t tamanio);
+
+/*
+ * Libera la memoria reservada por el filtro.
+ */
+void filtro_destruir(filtro_t* filtro);
+
+#endif /* __FILTRO_H__ */
@@ -6,6 +6,9 @@
 #include "lista.h"
 #include "hash.h"
 #include "hash_iterador.h"
+#include "hash_interno.h"
+#include "filtro.h"
+#include "hash_simd.h"
 
 #define CAPACIDAD_MIN 3
 #define ERROR -1
@@ -15,23 +18,15 @@
 #define MAX_CARGA 75
 #define MAX_PRIMO 100
 
-typedef struct elemento{
-    char* clave;
-    void* elemento;
-}ele_t;
-
-
-typedef struct vector{
-    lista_t* lista;
-}vector_t;
-
-struct hash{
-    vector_t* vector;
-    hash_destruir_dato_t destructor;
-    size_t capacidad;
-    size_t cant_elementos;
-    size_t pos_habilitadas;
-};
+/*
+ * Clave de una operacion junto con su largo y su hash, que se calculan
+ * una sola vez por operacion.
+ */
+typedef struct buscada{
+    const char* clave;
+    size_t largo;
+    size_t hash;
+}buscada_t;
 
 struct hash_iter{
     hash_t* hash;
@@ -51,13 +46,13 @@ hash_t* hash_crear(hash_destruir_dato_t destruir_elemento, size_t capacidad){
     if(capacidad < CAPACIDAD_MIN)
         capacidad = CAPACIDAD_MIN;
     aux->capacidad = capacidad;
-    vector_t* vector_aux = calloc(aux->capacidad, sizeof(vector_t));
-    if(!vector_aux){
+    aux->paginas = hash_crear_paginas(&aux->reserva, aux->capacidad);
+    if(!aux->paginas){
         free(aux);
         return NULL;
     }
-    aux->vector = vector_aux;
     aux->destructor = destruir_elemento;
+    aux->nucleos = hash_simd_nucleos();
     return aux;
 }
 
@@ -67,35 +62,82 @@ hash_t* hash_crear(hash_destruir_dato_t destruir_elemento, size_t capacidad){
  * clave
  */
 size_t hasheador(const char* clave){
-    size_t numero = 0;
-    for (int i = 0; i < strlen(clave); i++)
-        numero += (size_t)(clave[i]*(i+1));
-    return numero;
+    return (size_t)hash_simd_hashear(clave, strlen(clave));
+}
+
+//Calcula el largo y el hash de la clave con los nucleos del hash
+buscada_t preparar_clave(hash_t* hash, const char* clave){
+    buscada_t buscada;
+    buscada.clave = clave;
+    buscada.largo = strlen(clave);
+    buscada.hash = (size_t)hash->nucleos->hashear(clave, buscada.largo);
+    return buscada;
 }
 
-ele_t* crear_elemento(const char* clave, void* elemento){
-    ele_t* aux = calloc(1, sizeof(ele_t));
+ele_t* crear_elemento(hash_t* hash, char* clave, const buscada_t* buscada, void* elemento, origen_clave_t origen){
+    ele_t* aux = calloc(1, sizeof(ele_t) + hash->extra_entrada);
     if(!aux)
         return NULL;
     aux->elemento = elemento;
-    aux->clave = malloc(strlen(clave)+1);
+    aux->origen = origen;
+    aux->hash = buscada->hash;
+    aux->largo = buscada->largo;
+    if(hash->pool){
+        aux->clave = (char*)hash_pool_internar(hash->pool, clave);
+    }else if(origen != CLAVE_COPIADA){
+        aux->clave = clave;
+    }else{
+        aux->clave = malloc(strlen(clave)+1);
+        if(aux->clave)
+            strcpy(aux->clave, clave);
+    }
     if(!aux->clave){
         free(aux);
         return NULL;
     }
-    strcpy(aux->clave, clave);
     return aux;
 }
 
+//Libera una clave propia con el destructor de claves del hash
+void destruir_clave(hash_t* hash, char* clave){
+    if(hash->destructor_clave)
+        hash->destructor_clave(clave);
+    else
+        free(clave);
+}
+
+//Libera la clave de la entrada segun su origen, o la suelta si es del pool
+void hash_liberar_clave(hash_t* hash, ele_t* entrada){
+    if(hash->pool)
+        hash_pool_soltar(hash->pool, entrada->clave);
+    else if(entrada->origen == CLAVE_PROPIA)
+        destruir_clave(hash, entrada->clave);
+    else if(entrada->origen == CLAVE_COPIADA)
+        free(entrada->clave);
+}
 
 /*
- * Recibira una lista y una clave y un puntero a posicion.
+ * Devuelve la clave con la que hay que buscar en las listas del hash:
+ * la misma clave o, si el hash usa un pool, su copia internada (NULL si
+ * no esta en el pool, en cuyo caso tampoco esta en el hash).
+ */
+const char* clave_a_buscar(hash_t* hash, const char* clave){
+    if(!hash->pool)
+        return clave;
+    return hash_pool_buscar(hash->pool, clave);
+}
+
+
+/*
+ * Recibira el hash, una de sus listas, una clave y un puntero a posicion.
  * 
  * Buscara y devolvera el elemento, si es que existe. O
  * NULL si hay un error o no esta. Si recibe un puntero a un entero de posicion
- * le asiganara un valor para borrar el elemento en dicha posicion de la lista
+ * le asiganara un valor para borrar el elemento en dicha posicion de la lista.
+ * Si el hash usa un pool la clave es internada y compara solo los punteros;
+ * si no, compara el hash y el largo antes que los bytes.
  */
-ele_t* buscar_elemento(lista_t* lista, const char* clave, int* posicion){
+ele_t* buscar_elemento(hash_t* hash, lista_t* lista, const buscada_t* buscada, int* posicion){
     lista_iterador_t* iterador = lista_iterador_crear(lista);
     if(!iterador)
         return NULL;
@@ -104,8 +146,10 @@ ele_t* buscar_elemento(lista_t* lista, const char* clave, int* posicion){
     int i = 0;
     while (lista_iterador_tiene_siguiente(iterador) && !encontrado){
         aux = (ele_t*)lista_iterador_siguiente(iterador);
-        if(strcmp(clave, aux->clave) == IGUAL)
+        if(aux->clave == buscada->clave)
             encontrado = true;
+        else if(!hash->pool && aux->hash == buscada->hash && aux->largo == buscada->largo)
+            encontrado = hash->nucleos->iguales(aux->clave, buscada->clave, buscada->largo);
         i++;
     }
     lista_iterador_destruir(iterador);
@@ -121,109 +165,314 @@ size_t calcular_carga(hash_t* hash){
     return((hash->pos_habilitadas*100)/hash->capacidad);
 }
 
+/*
+ * Se llamara con cada entrada nueva antes de guardarla en el hash, para
+ * mantener al dia las estructuras auxiliares de la tabla.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso las estructuras
+ * quedan como estaban.
+ */
+int registrar_entrada(hash_t* hash, ele_t* entrada){
+    if(hash->indice && indice_agregar(hash->indice, entrada) == ERROR)
+        return ERROR;
+    filtro_agregar(hash->filtro, entrada->clave);
+    return EXITO;
+}
+
+/*
+ * Se llamara cada vez que una entrada abandone el hash, antes de
+ * liberarla, para mantener al dia las estructuras auxiliares.
+ */
+void olvidar_entrada(hash_t* hash, ele_t* entrada){
+    indice_quitar(hash->indice, entrada->clave);
+    filtro_quitar(hash->filtro, entrada->clave);
+    hash_ttl_descartar(hash, entrada);
+}
+
+/*
+ * Devuelve false si la clave seguro no esta en el hash, sin tocar el
+ * vector de la tabla, o true si puede estar.
+ */
+bool puede_estar(hash_t* hash, const char* clave){
+    if(!hash->filtro || filtro_puede_contener(hash->filtro, clave))
+        return true;
+    HASH_CONTAR(hash, descartes_filtro);
+    return false;
+}
+
 
 /*
  * En el caso de que se exceda el factor de balanceo se llamara a esta funcion
  * pasandole el hash.
  * 
- * Creara un nuevo hash y hara un swap con el nuevo. Despues destruira el viejo.
+ * Creara paginas de baldes mas grandes y movera las entradas a ellas, reconstruyendo
+ * el filtro si el hash tiene uno. Despues liberara las paginas viejas.
  */
 int rehash(hash_t* hash);
+ele_t* buscar_entrada(hash_t* hash, const buscada_t* buscada);
+static ele_t* buscar_guardada(hash_t* hash, const buscada_t* buscada);
 
 /*
  * En el caso de que se reciba una clave existenete se llamara a esta funcion, mandandole el hash
- * el elemento nuevo a insertar y la lista donde se encuentra dicha clave.
+ * la entrada donde se encuentra dicha clave y el elemento nuevo.
  * 
- * Buscara el elemento en la lista y hara un swap con el nuevo para que este quede insertado. Luego
- * liberara la memoria del elemento viejo.
+ * Dejara el elemento nuevo en la entrada, conservando la clave ya guardada, y liberara
+ * el elemento viejo.
  */
-void reemplazar(hash_t* hash, ele_t* nuevo, lista_t* lista){
-    int pos = 0;
-    ele_t* borrado = buscar_elemento(lista, nuevo->clave, &pos);
-    ele_t aux = *borrado;
-    *borrado = *nuevo;
-    *nuevo = aux;
-    free(nuevo->clave);
-    if(hash->destructor)
-        hash->destructor(nuevo->elemento);
-    free(nuevo);
+void reemplazar(hash_t* hash, ele_t* entrada, void* elemento){
+    if(entrada->multiple){
+        hash_multi_liberar(hash, entrada, elemento);
+        entrada->elemento = elemento;
+        return;
+    }
+    if(entrada->elemento != elemento)
+        hash_soltar_dato(hash, entrada);
+    entrada->elemento = elemento;
+}
+
+//Libera el elemento de la entrada, o todos sus valores si tiene varios
+void hash_liberar_dato(hash_t* hash, ele_t* entrada){
+    if(entrada->multiple)
+        hash_multi_liberar(hash, entrada, NULL);
+    else if(hash->destructor)
+        hash->destructor(entrada->elemento);
 }
 
 int hash_insertar(hash_t* hash, const char* clave, void* elemento){
     if(!hash || !clave)
         return ERROR;
-    size_t pos = (hasheador(clave)%hash->capacidad);
-    if(!hash->vector[pos].lista){
-        hash->vector[pos].lista = lista_crear();
-        if(!hash->vector[pos].lista)
-            return ERROR;
-        hash->pos_habilitadas++;
+    return hash_insertar_entrada(hash, (char*)clave, elemento, CLAVE_COPIADA, NULL);
+}
+
+/*
+ * Inserta la entrada sin registrarla en el log.
+ */
+static int insertar_entrada(hash_t* hash, char* clave, void* elemento, origen_clave_t origen, ele_t** entrada){
+    buscada_t buscada = preparar_clave(hash, clave);
+    size_t pos = (buscada.hash%hash->capacidad);
+    if(hash_preparar_balde(hash, pos) == ERROR){
+        HASH_TRAZAR(hash, SIN_MEMORIA, clave, sizeof(pagina_t));
+        return ERROR;
     }
-    if(!lista_vacia(hash->vector[pos].lista)){
-        if(hash_contiene(hash, clave)){
-            ele_t* nuevo = crear_elemento(clave, elemento);
-            if(!nuevo)
-                return ERROR;
-            reemplazar(hash, nuevo, hash->vector[pos].lista);
+    if(!lista_vacia(HASH_BALDE(hash, pos)->lista)){
+        ele_t* existente = buscar_guardada(hash, &buscada);
+        if(existente){
+            hash_ttl_descartar(hash, existente);
+            reemplazar(hash, existente, elemento);
+            HASH_CONTAR(hash, reemplazos);
+            HASH_TRAZAR(hash, INSERTAR, clave, 0);
+            if(origen == CLAVE_PROPIA)
+                destruir_clave(hash, clave);
+            if(entrada)
+                *entrada = existente;
             return EXITO;
         }
     }
-    ele_t* insertado = crear_elemento(clave, elemento);
-    int retorno = lista_insertar(hash->vector[pos].lista, insertado);
-    if(retorno == ERROR)
+    if(!HASH_BALDE(hash, pos)->lista){
+        HASH_BALDE(hash, pos)->lista = lista_crear();
+        if(!HASH_BALDE(hash, pos)->lista){
+            HASH_TRAZAR(hash, SIN_MEMORIA, clave, lista_tamanio_estructura());
+            return ERROR;
+        }
+        hash->pos_habilitadas++;
+    }
+    ele_t* insertado = crear_elemento(hash, clave, &buscada, elemento, origen);
+    if(!insertado){
+        HASH_TRAZAR(hash, SIN_MEMORIA, clave, sizeof(ele_t) + hash->extra_entrada + buscada.largo + 1);
         return ERROR;
+    }
+    int retorno = registrar_entrada(hash, insertado);
+    if(retorno == EXITO){
+        retorno = lista_insertar(HASH_BALDE(hash, pos)->lista, insertado);
+        if(retorno == ERROR)
+            olvidar_entrada(hash, insertado);
+    }
+    if(retorno == ERROR){
+        HASH_TRAZAR(hash, SIN_MEMORIA, clave, sizeof(void*));
+        if(hash->pool || origen == CLAVE_COPIADA)
+            hash_liberar_clave(hash, insertado);
+        free(insertado);
+        return ERROR;
+    }
     hash->cant_elementos++;
+    HASH_CONTAR(hash, inserciones);
+    HASH_TRAZAR(hash, INSERTAR, clave, 1);
+    if(hash->pool && origen == CLAVE_PROPIA)
+        destruir_clave(hash, clave);
+    if(entrada)
+        *entrada = insertado;
     if(calcular_carga(hash)>=MAX_CARGA)
         rehash(hash); 
     return EXITO;
 }
 
+int hash_insertar_entrada(hash_t* hash, char* clave, void* elemento, origen_clave_t origen, ele_t** entrada){
+    if(!hash->wal)
+        return insertar_entrada(hash, clave, elemento, origen, entrada);
+    if(hash_wal_anotar_insercion(hash, clave, elemento) == ERROR)
+        return ERROR;
+    int retorno = insertar_entrada(hash, clave, elemento, origen, entrada);
+    hash_wal_terminar(hash, retorno == EXITO);
+    return retorno;
+}
+
 int hash_quitar(hash_t *hash, const char *clave){
     if(!hash || !clave)
         return ERROR;
     int retorno = EXITO, pos_lista = 0;
-    size_t pos = (hasheador(clave) % hash->capacidad);
-    if (lista_vacia(hash->vector[pos].lista))
+    buscada_t buscada = preparar_clave(hash, clave);
+    size_t pos = (buscada.hash % hash->capacidad);
+    ele_t* aux = NULL;
+    buscada.clave = puede_estar(hash, clave) ? clave_a_buscar(hash, clave) : NULL;
+    if(buscada.clave && !lista_vacia(HASH_BALDE(hash, pos)->lista) && hash_preparar_balde(hash, pos) == EXITO)
+        aux = buscar_elemento(hash, HASH_BALDE(hash, pos)->lista, &buscada, &pos_lista);
+    if(!aux){
+        HASH_TRAZAR(hash, QUITAR, clave, 0);
         return ERROR;
-    ele_t* aux = buscar_elemento(hash->vector[pos].lista, clave, &pos_lista);
-    if(!aux)
+    }
+    if(hash->wal && hash_wal_anotar_quitado(hash, clave) == ERROR)
         return ERROR;
-    free(aux->clave);
-    if (hash->destructor)
-        hash->destructor(aux->elemento);
-    free(aux);
-    retorno = lista_borrar_de_posicion(hash->vector[pos].lista, (size_t)pos_lista);
-    if(retorno == ERROR)
+    HASH_TRAZAR(hash, QUITAR, clave, 1);
+    bool desenganchada = hash_desenganchar_entrada(hash, pos, (size_t)pos_lista) != NULL;
+    if(hash->wal)
+        hash_wal_terminar(hash, desenganchada);
+    if(!desenganchada)
         return ERROR;
-    hash->cant_elementos--;
+    hash_liberar_entrada(hash, aux);
+    HASH_CONTAR(hash, quitados);
     return retorno;
 }
 
-void* hash_obtener(hash_t *hash, const char *clave){
-    if(!hash || !clave)
+ele_t* hash_desenganchar_entrada(hash_t* hash, size_t balde, size_t posicion){
+    lista_t* lista = HASH_BALDE(hash, balde)->lista;
+    ele_t* entrada = lista_elemento_en_posicion(lista, posicion);
+    if(!entrada)
         return NULL;
-    size_t pos = (hasheador(clave) % hash->capacidad);
-    if(lista_vacia(hash->vector[pos].lista))
+    olvidar_entrada(hash, entrada);
+    lista_borrar_de_posicion(lista, posicion);
+    if(lista_vacia(lista)){
+        lista_destruir(lista);
+        HASH_BALDE(hash, balde)->lista = NULL;
+        hash->pos_habilitadas--;
+    }
+    hash->cant_elementos--;
+    return entrada;
+}
+
+int hash_enganchar_entrada(hash_t* hash, ele_t* entrada){
+    size_t pos = entrada->hash % hash->capacidad;
+    if(!HASH_BALDE(hash, pos)->lista){
+        HASH_BALDE(hash, pos)->lista = lista_crear();
+        if(!HASH_BALDE(hash, pos)->lista)
+            return ERROR;
+        hash->pos_habilitadas++;
+    }
+    if(registrar_entrada(hash, entrada) == ERROR)
+        return ERROR;
+    if(lista_insertar(HASH_BALDE(hash, pos)->lista, entrada) == ERROR){
+        olvidar_entrada(hash, entrada);
+        return ERROR;
+    }
+    hash->cant_elementos++;
+    return EXITO;
+}
+
+void hash_soltar_dato(hash_t* hash, ele_t* entrada){
+    hash_diferir(hash, entrada, false);
+    if(!entrada->elemento_compartido)
+        hash_liberar_dato(hash, entrada);
+    entrada->elemento_compartido = false;
+}
+
+void hash_liberar_entrada(hash_t* hash, ele_t* entrada){
+    hash_diferir(hash, entrada, true);
+    if(!entrada->clave_compartida)
+        hash_liberar_clave(hash, entrada);
+    if(!entrada->elemento_compartido)
+        hash_liberar_dato(hash, entrada);
+    free(entrada->temporizador);
+    free(entrada);
+}
+
+/*
+ * Busca la entrada de una clave ya preparada, este vencida o no.
+ * Insertar reemplaza una entrada vencida en lugar de quitarla, para que
+ * no se anote un registro en el log dentro del de la insercion.
+ */
+static ele_t* buscar_guardada(hash_t* hash, const buscada_t* buscada){
+    if(!puede_estar(hash, buscada->clave))
+        return NULL;
+    size_t pos = (buscada->hash % hash->capacidad);
+    if(lista_vacia(HASH_BALDE(hash, pos)->lista))
+        return NULL;
+    buscada_t internada = *buscada;
+    internada.clave = clave_a_buscar(hash, buscada->clave);
+    if(!internada.clave)
         return NULL;
     int numero = ERROR;
-    ele_t* aux = buscar_elemento(hash->vector[pos].lista, clave, &numero);
-    if(!aux)
+    return buscar_elemento(hash, HASH_BALDE(hash, pos)->lista, &internada, &numero);
+}
+
+/*
+ * Busca la entrada de una clave ya preparada. Si la entrada esta
+ * vencida devuelve NULL y la quita, salvo durante un recorrido del hash,
+ * en el que quitarla liberaria la lista que se esta recorriendo.
+ */
+ele_t* buscar_entrada(hash_t* hash, const buscada_t* buscada){
+    ele_t* entrada = buscar_guardada(hash, buscada);
+    if(entrada && entrada->temporizador && hash_ttl_vencida(hash, entrada)){
+        if(!hash->recorridos)
+            hash_quitar(hash, entrada->clave);
         return NULL;
+    }
+    return entrada;
+}
+
+ele_t* hash_buscar_entrada(hash_t* hash, const char* clave){
+    buscada_t buscada = preparar_clave(hash, clave);
+    return buscar_entrada(hash, &buscada);
+}
+
+ele_t* hash_buscar_igual(hash_t* hash, const ele_t* entrada){
+    buscada_t buscada = {entrada->clave, entrada->largo, entrada->hash};
+    return buscar_entrada(hash, &buscada);
+}
+
+ele_t* hash_buscar_igual_vigente(hash_t* hash, const ele_t* entrada){
+    hash->recorridos++;
+    ele_t* encontrada = hash_buscar_igual(hash, entrada);
+    hash->recorridos--;
+    return encontrada;
+}
+
+void* hash_obtener(hash_t *hash, const char *clave){
+    if(!hash || !clave)
+        return NULL;
+    HASH_CONTAR(hash, busquedas);
+    ele_t* aux = hash_buscar_entrada(hash, clave);
+    if(!aux){
+        HASH_CONTAR(hash, fallos);
+        HASH_TRAZAR(hash, BUSCAR, clave, 0);
+        return NULL;
+    }
+    HASH_CONTAR(hash, aciertos);
+    HASH_TRAZAR(hash, BUSCAR, clave, 1);
+    if(aux->multiple)
+        return ((valores_t*)aux->elemento)->elementos[0];
     return aux->elemento;
 }
 
 bool hash_contiene(hash_t *hash, const char *clave){
     if(!hash || !clave)
         return false;
-    int i = ERROR;
-    size_t pos = (hasheador(clave) % hash->capacidad);
-    if (lista_vacia(hash->vector[pos].lista))
-        return false;
-    ele_t *esta = buscar_elemento(hash->vector[pos].lista, clave, &i);
-    if (!esta)
-        return false;
-     if (strcmp((const char *)(esta->clave), clave) != IGUAL)
+    HASH_CONTAR(hash, busquedas);
+    if(!hash_buscar_entrada(hash, clave)){
+        HASH_CONTAR(hash, fallos);
+        HASH_TRAZAR(hash, BUSCAR, clave, 0);
         return false;
+    }
+    HASH_CONTAR(hash, aciertos);
+    HASH_TRAZAR(hash, BUSCAR, clave, 1);
     return true;
 }
 
@@ -236,20 +485,21 @@ size_t hash_cantidad(hash_t *hash){
 void hash_destruir(hash_t *hash){
     if(!hash)
         return;
+    hash_wal_cerrar(hash);
+    hash_snapshots_destruir(hash);
     for(int i = 0; i<hash->capacidad; i++){
-        lista_iterador_t* iterador = lista_iterador_crear(hash->vector[i].lista);
+        lista_iterador_t* iterador = lista_iterador_crear(HASH_BALDE(hash, i)->lista);
         ele_t* aux = NULL;
         while(lista_iterador_tiene_siguiente(iterador)){
             aux = lista_iterador_siguiente(iterador);
-            free(aux->clave);
-             if(hash->destructor)
-                hash->destructor(aux->elemento);
-            free(aux);
+            hash_liberar_entrada(hash, aux);
         }
         lista_iterador_destruir(iterador);
-        lista_destruir(hash->vector[i].lista);
     }
-    free(hash->vector);
+    hash_liberar_paginas(hash->paginas, hash->capacidad);
+    filtro_destruir(hash->filtro);
+    indice_destruir(hash->indice);
+    rueda_destruir(hash->rueda);
     free(hash);
 }
 
@@ -259,11 +509,14 @@ size_t hash_con_cada_clave(hash_t* hash, bool (*funcion)(hash_t* hash, const cha
     size_t cant = 0;
     bool corte = false;
     int i = 0;
+    hash->recorridos++;
     while(i<hash->capacidad && !corte){
-        if(!lista_vacia(hash->vector[i].lista)){
-            lista_iterador_t* iterador = lista_iterador_crear(hash->vector[i].lista);
-            if(!iterador)
+        if(!lista_vacia(HASH_BALDE(hash, i)->lista)){
+            lista_iterador_t* iterador = lista_iterador_crear(HASH_BALDE(hash, i)->lista);
+            if(!iterador){
+                hash->recorridos--;
                 return VACIO;
+            }
             ele_t* elem = NULL;
             while (lista_iterador_tiene_siguiente(iterador) && !corte){
                 elem = lista_iterador_siguiente(iterador);
@@ -274,22 +527,11 @@ size_t hash_con_cada_clave(hash_t* hash, bool (*funcion)(hash_t* hash, const cha
         }
         i++;
     }
+    hash->recorridos--;
     return cant;
 }
 
 
-/*
- * En el caso de que se deba rehashear se llamara a esta funcion la cual recibira
- * el hash, una clave y el hash nuevo.
- * 
- * Inseratara los elementos en el hash nuevo y siempre retornara false
- */
-bool rehashear(hash_t* hash, const char* clave, void* aux){
-    hash_t* nuevo = (hash_t*)aux;
-    hash_insertar(nuevo, clave, hash_obtener(hash, clave));
-    return false;
-}
-
 /*
  * Recibira la capacidad del hash viejo para asignarle la capacidad al nuevo
  * 
@@ -306,25 +548,107 @@ size_t proximo_primo(size_t capacidad){
     return primo;
 }
 
-int rehash(hash_t *hash){
-    hash_t* nuevo = hash_crear(hash->destructor, proximo_primo(hash->capacidad));
-    if(nuevo == NULL){
+pagina_t** hash_crear_paginas(const reserva_t* reserva, size_t capacidad){
+    size_t cantidad = HASH_PAGINAS(capacidad);
+    size_t completa = sizeof(pagina_t) + BALDES_POR_PAGINA * sizeof(vector_t);
+    size_t ultima = capacidad - (cantidad - 1) * BALDES_POR_PAGINA;
+    pagina_t** paginas = malloc(cantidad * sizeof(pagina_t*));
+    bloque_t* bloque = reserva_obtener(reserva, sizeof(bloque_t) + (cantidad - 1) * completa + sizeof(pagina_t) + ultima * sizeof(vector_t));
+    if(!paginas || !bloque){
+        free(paginas);
+        reserva_liberar(bloque);
+        return NULL;
+    }
+    bloque->paginas = cantidad;
+    for(size_t i = 0; i < cantidad; i++){
+        paginas[i] = (pagina_t*)((char*)(bloque + 1) + i * completa);
+        paginas[i]->referencias = 1;
+        paginas[i]->cantidad = i + 1 < cantidad ? BALDES_POR_PAGINA : ultima;
+        paginas[i]->bloque = bloque;
+    }
+    return paginas;
+}
+
+void hash_liberar_pagina(pagina_t* pagina){
+    if(!pagina->bloque)
+        free(pagina);
+    else if(--pagina->bloque->paginas == VACIO)
+        reserva_liberar(pagina->bloque);
+}
+
+void hash_liberar_paginas(pagina_t** paginas, size_t capacidad){
+    for(size_t i = 0; i < HASH_PAGINAS(capacidad); i++){
+        for(size_t j = 0; j < paginas[i]->cantidad; j++)
+            lista_destruir(paginas[i]->baldes[j].lista);
+        hash_liberar_pagina(paginas[i]);
+    }
+    free(paginas);
+}
+
+/*
+ * Recibira el hash y paginas nuevas con su capacidad.
+ *
+ * Movera cada entrada del hash a la posicion que le corresponde en las
+ * paginas nuevas, sin copiar claves ni elementos. Devuelve la cantidad de
+ * posiciones habilitadas en las paginas nuevas o ERROR si no pudo crear
+ * alguna lista o recorrer algun balde, en cuyo caso el hash queda
+ * intacto.
+ */
+int mover_entradas(hash_t* hash, pagina_t** paginas, size_t capacidad){
+    int habilitadas = 0;
+    for(size_t i = 0; i < hash->capacidad; i++){
+        lista_iterador_t* iterador = lista_iterador_crear(HASH_BALDE(hash, i)->lista);
+        if(!iterador && !lista_vacia(HASH_BALDE(hash, i)->lista))
+            return ERROR;
+        while(lista_iterador_tiene_siguiente(iterador)){
+            ele_t* entrada = lista_iterador_siguiente(iterador);
+            vector_t* balde = PAGINA_BALDE(paginas, entrada->hash % capacidad);
+            if(!balde->lista){
+                balde->lista = lista_crear();
+                habilitadas++;
+            }
+            if(!balde->lista || lista_insertar(balde->lista, entrada) == ERROR){
+                lista_iterador_destruir(iterador);
+                return ERROR;
+            }
+        }
+        lista_iterador_destruir(iterador);
+    }
+    return habilitadas;
+}
+
+int hash_redimensionar(hash_t* hash, size_t capacidad){
+    uint64_t inicio = hash_reloj_ns();
+    HASH_TRAZAR(hash, REHASH_INICIO, NULL, hash->capacidad);
+    pagina_t** paginas = hash_separar(hash) == EXITO ? hash_crear_paginas(&hash->reserva, capacidad) : NULL;
+    if(!paginas){
+        HASH_TRAZAR(hash, SIN_MEMORIA, NULL, capacidad * sizeof(vector_t));
+        HASH_TRAZAR(hash, REHASH_FIN, NULL, hash->capacidad);
         return ERROR;
     }
-    size_t cantidad = hash_con_cada_clave(hash, rehashear, nuevo);
-    if(cantidad != hash->cant_elementos){
-        hash_destruir(nuevo);
+    int habilitadas = mover_entradas(hash, paginas, capacidad);
+    if(habilitadas == ERROR){
+        HASH_TRAZAR(hash, SIN_MEMORIA, NULL, lista_tamanio_estructura());
+        hash_liberar_paginas(paginas, capacidad);
+        HASH_TRAZAR(hash, REHASH_FIN, NULL, hash->capacidad);
         return ERROR;
     }
-
-    hash_t aux = *hash;
-    *hash = *nuevo;
-    *nuevo = aux;
-    nuevo->destructor = NULL;
-    hash_destruir(nuevo);
+    hash_liberar_paginas(hash->paginas, hash->capacidad);
+    hash->paginas = paginas;
+    hash->capacidad = capacidad;
+    hash->pos_habilitadas = (size_t)habilitadas;
+    if(hash->filtro)
+        hash_filtro_reconstruir(hash);
+    hash->rehashes++;
+    hash->tiempo_rehash_ns += hash_reloj_ns() - inicio;
+    HASH_TRAZAR(hash, REHASH_FIN, NULL, capacidad);
     return EXITO;
 }
 
+int rehash(hash_t *hash){
+    return hash_redimensionar(hash, proximo_primo(hash->capacidad));
+}
+
 hash_iterador_t* hash_iterador_crear(hash_t* hash){
     if(!hash)
         return NULL;
@@ -348,10 +672,10 @@ const char* hash_iterador_siguiente(hash_iterador_t* iterador){
     if(!iterador)
         return NULL;
     if(!iterador->lista){
-        if(!iterador->hash->vector[iterador->posicion].lista){ 
+        if(!HASH_BALDE(iterador->hash, iterador->posicion)->lista){ 
             iterador->posicion++;
         }
-        iterador->lista = iterador->hash->vector[iterador->posicion].lista;
+        iterador->lista = HASH_BALDE(iterador->hash, iterador->posicion)->lista;
         iterador->iterador_lista = lista_iterador_crear(iterador->lista);
     }
     iterador->sigue = lista_iterador_tiene_siguiente(iterador->iterador_lista);
@@ -361,13 +685,13 @@ const char* hash_iterador_siguiente(hash_iterador_t* iterador){
             iterador->posicion++;
             bool corte = false;
             while(iterador->posicion < iterador->hash->capacidad && !corte){
-                if (!iterador->hash->vector[iterador->posicion].lista)
+                if (!HASH_BALDE(iterador->hash, iterador->posicion)->lista)
                     iterador->posicion++;
                 else
                     corte = true;
             }
             if(corte){
-                iterador->lista = iterador->hash->vector[iterador->posicion].lista;
+                iterador->lista = HASH_BALDE(iterador->hash, iterador->posicion)->lista;
                 iterador->iterador_lista = lista_iterador_crear(iterador->lista);
                 iterador->sigue = lista_iterador_tiene_siguiente(iterador->iterador_lista);
             }else{
@@ -375,6 +699,8 @@ const char* hash_iterador_siguiente(hash_iterador_t* iterador){
                 return NULL;
             }
         }else{
+            lista_iterador_destruir(iterador->iterador_lista);
+            iterador->iterador_lista = NULL;
             return NULL;
         }
     }
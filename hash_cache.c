@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_cache.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+#define CAPACIDAD_INICIAL 16
+
+/*
+ * Nodo de la lista de uso. Se guarda en el espacio extra de la entrada
+ * del hash interno, que no cambia de lugar mientras la clave este en la
+ * tabla, asi que no hace falta otra reserva por clave.
+ */
+typedef struct nodo_cache{
+    struct nodo_cache* anterior;
+    struct nodo_cache* siguiente;
+    size_t bytes;
+}nodo_cache_t;
+
+struct hash_cache{
+    hash_t* hash;
+    nodo_cache_t* reciente;
+    nodo_cache_t* antiguo;
+    size_t max_elementos;
+    size_t max_bytes;
+    size_t bytes;
+    size_t aciertos;
+    size_t fallos;
+    size_t desalojos;
+};
+
+static nodo_cache_t* nodo_de(ele_t* entrada){
+    return HASH_EXTRA(entrada);
+}
+
+static ele_t* entrada_de(nodo_cache_t* nodo){
+    return (ele_t*)nodo - 1;
+}
+
+/*
+ * Saca el nodo de la lista de uso.
+ */
+static void desenlazar(hash_cache_t* cache, nodo_cache_t* nodo){
+    if(nodo->anterior)
+        nodo->anterior->siguiente = nodo->siguiente;
+    else
+        cache->reciente = nodo->siguiente;
+    if(nodo->siguiente)
+        nodo->siguiente->anterior = nodo->anterior;
+    else
+        cache->antiguo = nodo->anterior;
+    nodo->anterior = NULL;
+    nodo->siguiente = NULL;
+}
+
+/*
+ * Agrega el nodo al frente de la lista de uso.
+ */
+static void enlazar_al_frente(hash_cache_t* cache, nodo_cache_t* nodo){
+    nodo->siguiente = cache->reciente;
+    if(cache->reciente)
+        cache->reciente->anterior = nodo;
+    cache->reciente = nodo;
+    if(!cache->antiguo)
+        cache->antiguo = nodo;
+}
+
+/*
+ * Saca la entrada de la lista de uso y la quita del hash interno, que
+ * invoca al destructor con su elemento.
+ */
+static void quitar_entrada(hash_cache_t* cache, ele_t* entrada){
+    nodo_cache_t* nodo = nodo_de(entrada);
+    desenlazar(cache, nodo);
+    cache->bytes -= nodo->bytes;
+    hash_quitar(cache->hash, entrada->clave);
+}
+
+//Devuelve true si la cache excede alguno de sus limites
+static bool excedida(hash_cache_t* cache){
+    if(cache->max_elementos && hash_cantidad(cache->hash) > cache->max_elementos)
+        return true;
+    return cache->max_bytes && cache->bytes > cache->max_bytes;
+}
+
+/*
+ * Desaloja los elementos usados hace mas tiempo hasta volver a estar
+ * dentro del presupuesto.
+ */
+static void desalojar(hash_cache_t* cache){
+    while(excedida(cache) && cache->antiguo){
+        quitar_entrada(cache, entrada_de(cache->antiguo));
+        cache->desalojos++;
+    }
+}
+
+hash_cache_t* hash_cache_crear(hash_destruir_dato_t destructor, size_t max_elementos, size_t max_bytes){
+    hash_cache_t* cache = calloc(1, sizeof(hash_cache_t));
+    if(!cache)
+        return NULL;
+    size_t capacidad = max_elementos ? max_elementos + max_elementos / 3 : CAPACIDAD_INICIAL;
+    cache->hash = hash_crear(destructor, capacidad);
+    if(!cache->hash){
+        free(cache);
+        return NULL;
+    }
+    cache->hash->extra_entrada = sizeof(nodo_cache_t);
+    cache->max_elementos = max_elementos;
+    cache->max_bytes = max_bytes;
+    return cache;
+}
+
+int hash_cache_insertar(hash_cache_t* cache, const char* clave, void* elemento, size_t bytes){
+    if(!cache || !clave || (cache->max_bytes && bytes > cache->max_bytes))
+        return ERROR;
+    size_t cantidad = hash_cantidad(cache->hash);
+    ele_t* entrada = NULL;
+    if(hash_insertar_entrada(cache->hash, (char*)clave, elemento, CLAVE_COPIADA, &entrada) == ERROR)
+        return ERROR;
+    nodo_cache_t* nodo = nodo_de(entrada);
+    if(hash_cantidad(cache->hash) == cantidad){
+        cache->bytes -= nodo->bytes;
+        desenlazar(cache, nodo);
+    }
+    nodo->bytes = bytes;
+    cache->bytes += bytes;
+    enlazar_al_frente(cache, nodo);
+    desalojar(cache);
+    return EXITO;
+}
+
+void* hash_cache_obtener(hash_cache_t* cache, const char* clave){
+    if(!cache || !clave)
+        return NULL;
+    ele_t* entrada = hash_buscar_entrada(cache->hash, clave);
+    if(!entrada){
+        cache->fallos++;
+        return NULL;
+    }
+    cache->aciertos++;
+    nodo_cache_t* nodo = nodo_de(entrada);
+    if(cache->reciente != nodo){
+        desenlazar(cache, nodo);
+        enlazar_al_frente(cache, nodo);
+    }
+    return entrada->elemento;
+}
+
+bool hash_cache_contiene(hash_cache_t* cache, const char* clave){
+    if(!cache || !clave)
+        return false;
+    return hash_contiene(cache->hash, clave);
+}
+
+int hash_cache_quitar(hash_cache_t* cache, const char* clave){
+    if(!cache || !clave)
+        return ERROR;
+    ele_t* entrada = hash_buscar_entrada(cache->hash, clave);
+    if(!entrada)
+        return ERROR;
+    quitar_entrada(cache, entrada);
+    return EXITO;
+}
+
+size_t hash_cache_cantidad(hash_cache_t* cache){
+    if(!cache)
+        return VACIO;
+    return hash_cantidad(cache->hash);
+}
+
+size_t hash_cache_bytes(hash_cache_t* cache){
+    if(!cache)
+        return VACIO;
+    return cache->bytes;
+}
+
+size_t hash_cache_aciertos(hash_cache_t* cache){
+    if(!cache)
+        return VACIO;
+    return cache->aciertos;
+}
+
+size_t hash_cache_fallos(hash_cache_t* cache){
+    if(!cache)
+        return VACIO;
+    return cache->fallos;
+}
+
+size_t hash_cache_desalojos(hash_cache_t* cache){
+    if(!cache)
+        return VACIO;
+    return cache->desalojos;
+}
+
+void hash_cache_destruir(hash_cache_t* cache){
+    if(!cache)
+        return;
+    hash_destruir(cache->hash);
+    free(cache);
+}
@@ -0,0 +1,81 @@
+#ifndef __HASH_CACHE_H__
+#define __HASH_CACHE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Cache acotada construida sobre el hash. Cada elemento guardado lleva
+ * la cuenta de su ultimo uso en una lista doblemente enlazada, por lo
+ * que cuando se excede el presupuesto se desaloja el elemento usado
+ * hace mas tiempo en O(1), sin recorrer la tabla.
+ */
+typedef struct hash_cache hash_cache_t;
+
+/*
+ * Crea la cache. Max_elementos es la cantidad maxima de elementos y
+ * max_bytes el total maximo de bytes (segun lo declarado al insertar
+ * cada elemento). Un limite en 0 indica que no se limita por ese
+ * criterio. El destructor se invoca con cada elemento que abandone la
+ * cache, incluidos los desalojados.
+ *
+ * Devuelve la cache creada o NULL en caso de error.
+ */
+hash_cache_t* hash_cache_crear(hash_destruir_dato_t destructor, size_t max_elementos, size_t max_bytes);
+
+/*
+ * Inserta el elemento asociado a la clave, declarando que ocupa la
+ * cantidad de bytes dada, y lo marca como el mas reciente. Si la clave
+ * ya existia se reemplaza su elemento. Si al insertar se excede el
+ * presupuesto, se desalojan los elementos menos usados.
+ *
+ * Devuelve 0 si pudo guardarlo o -1 si no pudo (por ejemplo si el
+ * elemento solo ya excede el limite de bytes).
+ */
+int hash_cache_insertar(hash_cache_t* cache, const char* clave, void* elemento, size_t bytes);
+
+/*
+ * Devuelve el elemento asociado a la clave y lo marca como el mas
+ * reciente, o NULL si no esta (o en caso de error). Cada llamada cuenta
+ * como un acierto o un fallo.
+ */
+void* hash_cache_obtener(hash_cache_t* cache, const char* clave);
+
+/*
+ * Devuelve true si la cache contiene la clave o false en caso
+ * contrario. No modifica el orden de uso ni los contadores.
+ */
+bool hash_cache_contiene(hash_cache_t* cache, const char* clave);
+
+/*
+ * Quita el elemento de la clave e invoca al destructor.
+ * Devuelve 0 si pudo quitarlo o -1 si no pudo.
+ */
+int hash_cache_quitar(hash_cache_t* cache, const char* clave);
+
+/*
+ * Devuelve la cantidad de elementos en la cache o 0 en caso de error.
+ */
+size_t hash_cache_cantidad(hash_cache_t* cache);
+
+/*
+ * Devuelve el total de bytes declarados por los elementos en la cache
+ * o 0 en caso de error.
+ */
+size_t hash_cache_bytes(hash_cache_t* cache);
+
+/*
+ * Devuelven la cantidad de aciertos, de fallos y de desalojos desde la
+ * creacion de la cache, o 0 en caso de error.
+ */
+size_t hash_cache_aciertos(hash_cache_t* cache);
+size_t hash_cache_fallos(hash_cache_t* cache);
+size_t hash_cache_desalojos(hash_cache_t* cache);
+
+/*
+ * Destruye la cache invocando al destructor con cada elemento.
+ */
+void hash_cache_destruir(hash_cache_t* cache);
+
+#endif /* __HASH_CACHE_H__ */
@@ -0,0 +1,27 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_claves.h"
+
+#define ERROR -1
+#define EXITO 0
+
+int hash_establecer_destructor_clave(hash_t* hash, hash_destruir_clave_t destructor){
+    if(!hash)
+        return ERROR;
+    hash->destructor_clave = destructor;
+    return EXITO;
+}
+
+int hash_insertar_propio(hash_t* hash, char* clave, void* elemento){
+    if(!hash || !clave)
+        return ERROR;
+    return hash_insertar_entrada(hash, clave, elemento, CLAVE_PROPIA, NULL);
+}
+
+int hash_insertar_prestado(hash_t* hash, const char* clave, void* elemento){
+    if(!hash || !clave)
+        return ERROR;
+    return hash_insertar_entrada(hash, (char*)clave, elemento, CLAVE_PRESTADA, NULL);
+}
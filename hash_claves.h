@@ -0,0 +1,41 @@
+#ifndef __HASH_CLAVES_H__
+#define __HASH_CLAVES_H__
+
+#include "hash.h"
+
+/*
+ * Destructor de las claves cuya propiedad se le cede al hash.
+ */
+typedef void (*hash_destruir_clave_t)(char* clave);
+
+/*
+ * Establece la funcion con la que el hash libera las claves que recibe
+ * con hash_insertar_propio. Con NULL (el valor inicial) se usa free.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo.
+ */
+int hash_establecer_destructor_clave(hash_t* hash, hash_destruir_clave_t destructor);
+
+/*
+ * Inserta el elemento como hash_insertar, pero sin copiar la clave: el
+ * hash se queda con ella y la libera con el destructor de claves cuando
+ * ya no la necesita (al quitarla, al destruir el hash, o enseguida si la
+ * clave ya estaba en el hash o si el hash usa un pool).
+ *
+ * Devuelve 0 si pudo guardarlo o -1 si no pudo, en cuyo caso la clave
+ * sigue siendo de quien llama.
+ */
+int hash_insertar_propio(hash_t* hash, char* clave, void* elemento);
+
+/*
+ * Inserta el elemento como hash_insertar, pero sin copiar la clave ni
+ * liberarla nunca: quien llama garantiza que la clave no cambia y vive
+ * mas que su entrada en el hash (por ejemplo una cadena literal o una
+ * clave en un bloque de memoria propio). Si el hash usa un pool, la
+ * clave se interna igual que con hash_insertar.
+ *
+ * Devuelve 0 si pudo guardarlo o -1 si no pudo.
+ */
+int hash_insertar_prestado(hash_t* hash, const char* clave, void* elemento);
+
+#endif /* __HASH_CLAVES_H__ */
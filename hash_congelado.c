@@ -0,0 +1,354 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "lista.h"
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_funciones.h"
+#include "hash_congelado.h"
+
+#define ERROR -1
+#define EXITO 0
+#define IGUAL 0
+#define VACIO 0
+#define CLAVES_POR_GRUPO 4
+#define MAX_INTENTOS 16
+#define MAX_DESPLAZAMIENTO 16
+
+typedef struct posicion{
+    const char* clave;
+    void* elemento;
+}posicion_t;
+
+/*
+ * Desplazamiento elegido para un grupo de claves. La posicion de una
+ * clave del grupo es (f1 + d0 * f2 + d1) modulo la cantidad de claves.
+ */
+typedef struct desplazamiento{
+    uint32_t d0;
+    uint32_t d1;
+}desplazamiento_t;
+
+struct hash_congelado{
+    posicion_t* posiciones;
+    desplazamiento_t* desplazamientos;
+    char* claves;
+    size_t cantidad;
+    size_t cant_grupos;
+    uint64_t semilla;
+    hash_destruir_dato_t destructor;
+};
+
+typedef struct entrada{
+    const char* clave;
+    void* elemento;
+    uint64_t hash;
+}entrada_t;
+
+typedef struct grupo{
+    size_t numero;
+    size_t tamanio;
+}grupo_t;
+
+/*
+ * Las entradas vigentes se agregan desde el principio y los elementos
+ * de las vencidas desde el final, para destruirlos si se congela.
+ */
+typedef struct construccion{
+    hash_t* hash;
+    entrada_t* entradas;
+    size_t cantidad;
+    size_t vencidas;
+    size_t total;
+    char* claves;
+    size_t usado;
+}construccion_t;
+
+/*
+ * Copia la clave del elemento al bloque de claves y lo agrega a las
+ * entradas de la construccion, salvo que este vencido.
+ */
+static void copiar_elemento(void* dato, void* contexto){
+    ele_t* elemento = dato;
+    construccion_t* construccion = contexto;
+    if(hash_ttl_vencida(construccion->hash, elemento)){
+        construccion->entradas[construccion->total - ++construccion->vencidas].elemento = elemento->elemento;
+        return;
+    }
+    size_t largo = strlen(elemento->clave) + 1;
+    entrada_t* entrada = &construccion->entradas[construccion->cantidad++];
+    memcpy(construccion->claves + construccion->usado, elemento->clave, largo);
+    entrada->clave = construccion->claves + construccion->usado;
+    entrada->elemento = elemento->elemento;
+    construccion->usado += largo;
+}
+
+//Suma el largo de la clave del elemento al total recibido
+static void sumar_largo(void* dato, void* contexto){
+    *(size_t*)contexto += strlen(((ele_t*)dato)->clave) + 1;
+}
+
+/*
+ * Calcula la posicion de una clave a partir de su hash y del
+ * desplazamiento de su grupo.
+ */
+static size_t calcular_posicion(uint64_t hash, desplazamiento_t desplazamiento, size_t cantidad){
+    uint64_t mezcla = hash_mezclar(hash);
+    uint64_t f1 = (mezcla & UINT32_MAX) % cantidad;
+    uint64_t f2 = (mezcla >> 32) % cantidad;
+    return (size_t)((f1 + desplazamiento.d0 * f2 + desplazamiento.d1) % cantidad);
+}
+
+//Ordena los grupos de mayor a menor cantidad de claves
+static int comparar_grupos(const void* a, const void* b){
+    const grupo_t* primero = a;
+    const grupo_t* segundo = b;
+    if(primero->tamanio == segundo->tamanio)
+        return (primero->numero > segundo->numero) - (primero->numero < segundo->numero);
+    return (primero->tamanio < segundo->tamanio) - (primero->tamanio > segundo->tamanio);
+}
+
+/*
+ * Intenta ubicar todas las claves del grupo con el desplazamiento dado.
+ * Si alguna posicion esta ocupada deshace las ocupadas y devuelve false.
+ */
+static bool probar_desplazamiento(entrada_t* entradas, size_t* miembros, size_t tamanio, desplazamiento_t desplazamiento, bool* ocupado, size_t* posiciones, size_t cantidad){
+    for(size_t i = 0; i < tamanio; i++){
+        posiciones[i] = calcular_posicion(entradas[miembros[i]].hash, desplazamiento, cantidad);
+        if(ocupado[posiciones[i]]){
+            for(size_t j = 0; j < i; j++)
+                ocupado[posiciones[j]] = false;
+            return false;
+        }
+        ocupado[posiciones[i]] = true;
+    }
+    return true;
+}
+
+/*
+ * Busca un desplazamiento que ubique a todas las claves del grupo en
+ * posiciones libres. Un grupo de una sola clave se ubica directamente
+ * en la proxima posicion libre.
+ *
+ * Devuelve 0 si lo encontro o -1 si no lo encontro.
+ */
+static int ubicar_grupo(entrada_t* entradas, size_t* miembros, size_t tamanio, desplazamiento_t* desplazamiento, bool* ocupado, size_t* libre, size_t* posiciones, size_t cantidad){
+    if(tamanio == 1){
+        while(ocupado[*libre])
+            (*libre)++;
+        desplazamiento->d0 = 0;
+        desplazamiento->d1 = 0;
+        size_t base = calcular_posicion(entradas[miembros[0]].hash, *desplazamiento, cantidad);
+        desplazamiento->d1 = (uint32_t)((*libre + cantidad - base) % cantidad);
+        ocupado[*libre] = true;
+        return EXITO;
+    }
+    for(uint32_t d0 = 0; d0 < MAX_DESPLAZAMIENTO; d0++){
+        for(size_t d1 = 0; d1 < cantidad; d1++){
+            desplazamiento->d0 = d0;
+            desplazamiento->d1 = (uint32_t)d1;
+            if(probar_desplazamiento(entradas, miembros, tamanio, *desplazamiento, ocupado, posiciones, cantidad))
+                return EXITO;
+        }
+    }
+    return ERROR;
+}
+
+/*
+ * Agrupa las claves segun su hash y ubica los grupos de mayor a menor,
+ * guardando el desplazamiento de cada uno.
+ *
+ * Devuelve 0 si pudo ubicar todas las claves o -1 si no pudo con la
+ * semilla actual.
+ */
+static int ubicar_claves(hash_congelado_t* congelado, entrada_t* entradas, size_t* inicio, size_t* miembros, grupo_t* grupos, bool* ocupado, size_t* posiciones){
+    size_t cantidad = congelado->cantidad;
+    memset(inicio, 0, (congelado->cant_grupos + 1) * sizeof(size_t));
+    for(size_t i = 0; i < cantidad; i++){
+        entradas[i].hash = hash_fnv1a(entradas[i].clave, strlen(entradas[i].clave), congelado->semilla);
+        inicio[entradas[i].hash % congelado->cant_grupos + 1]++;
+    }
+    for(size_t i = 0; i < congelado->cant_grupos; i++){
+        grupos[i].numero = i;
+        grupos[i].tamanio = inicio[i + 1];
+        inicio[i + 1] += inicio[i];
+    }
+    for(size_t i = 0; i < cantidad; i++){
+        size_t numero = entradas[i].hash % congelado->cant_grupos;
+        miembros[inicio[numero] + (--grupos[numero].tamanio)] = i;
+    }
+    for(size_t i = 0; i < congelado->cant_grupos; i++)
+        grupos[i].tamanio = inicio[i + 1] - inicio[i];
+    qsort(grupos, congelado->cant_grupos, sizeof(grupo_t), comparar_grupos);
+
+    memset(ocupado, 0, cantidad * sizeof(bool));
+    memset(congelado->desplazamientos, 0, congelado->cant_grupos * sizeof(desplazamiento_t));
+    size_t libre = 0;
+    for(size_t i = 0; i < congelado->cant_grupos && grupos[i].tamanio; i++){
+        size_t numero = grupos[i].numero;
+        if(ubicar_grupo(entradas, miembros + inicio[numero], grupos[i].tamanio, &congelado->desplazamientos[numero], ocupado, &libre, posiciones, cantidad) == ERROR)
+            return ERROR;
+    }
+    return EXITO;
+}
+
+/*
+ * Construye la funcion de hash perfecta probando semillas hasta que
+ * todas las claves quedan ubicadas, y llena el vector de posiciones.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo.
+ */
+static int construir(hash_congelado_t* congelado, entrada_t* entradas){
+    size_t cantidad = congelado->cantidad;
+    size_t* inicio = malloc((congelado->cant_grupos + 1) * sizeof(size_t));
+    size_t* miembros = malloc(cantidad * sizeof(size_t));
+    size_t* posiciones = malloc(cantidad * sizeof(size_t));
+    grupo_t* grupos = malloc(congelado->cant_grupos * sizeof(grupo_t));
+    bool* ocupado = malloc(cantidad * sizeof(bool));
+    int retorno = ERROR;
+    if(inicio && miembros && posiciones && grupos && ocupado){
+        for(uint64_t semilla = 0; semilla < MAX_INTENTOS && retorno == ERROR; semilla++){
+            congelado->semilla = semilla;
+            retorno = ubicar_claves(congelado, entradas, inicio, miembros, grupos, ocupado, posiciones);
+        }
+    }
+    for(size_t i = 0; i < cantidad && retorno == EXITO; i++){
+        size_t numero = entradas[i].hash % congelado->cant_grupos;
+        size_t posicion = calcular_posicion(entradas[i].hash, congelado->desplazamientos[numero], cantidad);
+        congelado->posiciones[posicion].clave = entradas[i].clave;
+        congelado->posiciones[posicion].elemento = entradas[i].elemento;
+    }
+    free(inicio);
+    free(miembros);
+    free(posiciones);
+    free(grupos);
+    free(ocupado);
+    return retorno;
+}
+
+/*
+ * Libera la memoria del hash congelado sin invocar al destructor.
+ */
+static void liberar_congelado(hash_congelado_t* congelado){
+    free(congelado->posiciones);
+    free(congelado->desplazamientos);
+    free(congelado->claves);
+    free(congelado);
+}
+
+/*
+ * Reserva el hash congelado y copia las claves y elementos vigentes del
+ * hash recibido al bloque de claves y a las entradas. Reserva para todas
+ * las entradas del hash, porque una clave puede vencer mientras se
+ * copia, y despues toma la cantidad de las vigentes.
+ */
+static hash_congelado_t* reservar_congelado(hash_t* hash, construccion_t* construccion){
+    hash_congelado_t* congelado = calloc(1, sizeof(hash_congelado_t));
+    if(!congelado)
+        return NULL;
+    congelado->cantidad = hash->cant_elementos;
+    congelado->cant_grupos = congelado->cantidad / CLAVES_POR_GRUPO + 1;
+    size_t largo_claves = 0;
+    for(size_t i = 0; i < hash->capacidad; i++)
+        lista_con_cada_elemento(HASH_BALDE(hash, i)->lista, sumar_largo, &largo_claves);
+
+    congelado->posiciones = calloc(congelado->cantidad + 1, sizeof(posicion_t));
+    congelado->desplazamientos = calloc(congelado->cant_grupos, sizeof(desplazamiento_t));
+    congelado->claves = malloc(largo_claves + 1);
+    construccion->entradas = malloc((congelado->cantidad + 1) * sizeof(entrada_t));
+    construccion->claves = congelado->claves;
+    construccion->hash = hash;
+    construccion->total = congelado->cantidad + 1;
+    if(!congelado->posiciones || !congelado->desplazamientos || !congelado->claves || !construccion->entradas){
+        free(construccion->entradas);
+        liberar_congelado(congelado);
+        return NULL;
+    }
+    for(size_t i = 0; i < hash->capacidad; i++)
+        lista_con_cada_elemento(HASH_BALDE(hash, i)->lista, copiar_elemento, construccion);
+    congelado->cantidad = construccion->cantidad;
+    congelado->cant_grupos = congelado->cantidad / CLAVES_POR_GRUPO + 1;
+    return congelado;
+}
+
+hash_congelado_t* hash_congelar(hash_t* hash){
+    if(!hash || hash->multiples || hash_con_snapshots(hash))
+        return NULL;
+    construccion_t construccion = {NULL, NULL, VACIO, VACIO, VACIO, NULL, VACIO};
+    hash_congelado_t* congelado = reservar_congelado(hash, &construccion);
+    if(!congelado)
+        return NULL;
+    int retorno = EXITO;
+    if(congelado->cantidad)
+        retorno = construir(congelado, construccion.entradas);
+    if(retorno == ERROR){
+        free(construccion.entradas);
+        liberar_congelado(congelado);
+        return NULL;
+    }
+    for(size_t i = 1; hash->destructor && i <= construccion.vencidas; i++)
+        hash->destructor(construccion.entradas[construccion.total - i].elemento);
+    free(construccion.entradas);
+    congelado->destructor = hash->destructor;
+    hash->destructor = NULL;
+    hash_destruir(hash);
+    return congelado;
+}
+
+/*
+ * Devuelve la posicion que le corresponde a la clave. La clave esta
+ * en el hash solo si coincide con la guardada en esa posicion.
+ */
+static posicion_t* buscar_posicion(hash_congelado_t* congelado, const char* clave){
+    if(!congelado->cantidad)
+        return NULL;
+    uint64_t numero = hash_fnv1a(clave, strlen(clave), congelado->semilla);
+    desplazamiento_t desplazamiento = congelado->desplazamientos[numero % congelado->cant_grupos];
+    posicion_t* posicion = &congelado->posiciones[calcular_posicion(numero, desplazamiento, congelado->cantidad)];
+    if(strcmp(posicion->clave, clave) != IGUAL)
+        return NULL;
+    return posicion;
+}
+
+void* hash_congelado_obtener(hash_congelado_t* congelado, const char* clave){
+    if(!congelado || !clave)
+        return NULL;
+    posicion_t* posicion = buscar_posicion(congelado, clave);
+    if(!posicion)
+        return NULL;
+    return posicion->elemento;
+}
+
+bool hash_congelado_contiene(hash_congelado_t* congelado, const char* clave){
+    if(!congelado || !clave)
+        return false;
+    return buscar_posicion(congelado, clave) != NULL;
+}
+
+size_t hash_congelado_cantidad(hash_congelado_t* congelado){
+    if(!congelado)
+        return VACIO;
+    return congelado->cantidad;
+}
+
+size_t hash_congelado_con_cada_clave(hash_congelado_t* congelado, bool (*funcion)(const char* clave, void* elemento, void* aux), void* aux){
+    if(!congelado || !funcion)
+        return VACIO;
+    size_t cant = 0;
+    bool corte = false;
+    while(cant < congelado->cantidad && !corte){
+        corte = funcion(congelado->posiciones[cant].clave, congelado->posiciones[cant].elemento, aux);
+        cant++;
+    }
+    return cant;
+}
+
+void hash_congelado_destruir(hash_congelado_t* congelado){
+    if(!congelado)
+        return;
+    for(size_t i = 0; i < congelado->cantidad && congelado->destructor; i++)
+        congelado->destructor(congelado->posiciones[i].elemento);
+    liberar_congelado(congelado);
+}
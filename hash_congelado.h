@@ -0,0 +1,65 @@
+#ifndef __HASH_CONGELADO_H__
+#define __HASH_CONGELADO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Hash inmutable construido a partir de un hash ya cargado. Usa una
+ * funcion de hash perfecta minima (CHD): cada clave tiene asignada una
+ * posicion propia en un vector de exactamente tantas posiciones como
+ * claves, por lo que una busqueda calcula un hash, lee una posicion y
+ * compara una clave. Las claves se guardan en un unico bloque contiguo.
+ */
+typedef struct hash_congelado hash_congelado_t;
+
+/*
+ * Congela el hash dado. Las claves y los elementos pasan al hash
+ * congelado, que se queda tambien con el destructor. Si se pudo
+ * congelar, el hash original se destruye (sin invocar al destructor)
+ * y no debe volver a usarse.
+ *
+ * Las claves vencidas no pasan al hash congelado y sus elementos se
+ * destruyen. No se pueden congelar hashes con claves de varios valores
+ * ni con snapshots sin soltar.
+ *
+ * Devuelve el hash congelado o NULL en caso de error, en cuyo caso el
+ * hash original queda intacto.
+ */
+hash_congelado_t* hash_congelar(hash_t* hash);
+
+/*
+ * Devuelve el elemento asociado a la clave dada o NULL si la clave no
+ * existe (o en caso de error).
+ */
+void* hash_congelado_obtener(hash_congelado_t* congelado, const char* clave);
+
+/*
+ * Devuelve true si el hash congelado contiene la clave dada o false en
+ * caso contrario (o en caso de error).
+ */
+bool hash_congelado_contiene(hash_congelado_t* congelado, const char* clave);
+
+/*
+ * Devuelve la cantidad de elementos del hash congelado o 0 en caso de
+ * error.
+ */
+size_t hash_congelado_cantidad(hash_congelado_t* congelado);
+
+/*
+ * Recorre las claves del hash congelado e invoca a la funcion con cada
+ * clave, su elemento y el puntero auxiliar. La iteracion se corta
+ * cuando la funcion devuelve true.
+ *
+ * Devuelve la cantidad de veces que fue invocada la funcion o 0 en
+ * caso de error.
+ */
+size_t hash_congelado_con_cada_clave(hash_congelado_t* congelado, bool (*funcion)(const char* clave, void* elemento, void* aux), void* aux);
+
+/*
+ * Destruye el hash congelado invocando al destructor con cada elemento.
+ */
+void hash_congelado_destruir(hash_congelado_t* congelado);
+
+#endif /* __HASH_CONGELADO_H__ */
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "lista.h"
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_memoria.h"
+#include "hash_conjuntos.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+#define PRIMERA 0
+
+//Devuelve true si las entradas de un hash pueden pasar al otro tal como estan
+static bool claves_compatibles(hash_t* destino, hash_t* origen){
+    return destino->pool == origen->pool && destino->destructor_clave == origen->destructor_clave;
+}
+
+/*
+ * Mueve al destino la entrada que esta al principio de la lista del
+ * balde del origen, cuya clave no esta en el destino. El temporizador se
+ * aparta mientras tanto para que sacarla del origen no lo descarte.
+ */
+static int mover_entrada(hash_t* destino, hash_t* origen, size_t balde, ele_t* entrada){
+    temporizador_t* temporizador = entrada->temporizador;
+    entrada->temporizador = NULL;
+    if(hash_enganchar_entrada(destino, entrada) == ERROR){
+        entrada->temporizador = temporizador;
+        return ERROR;
+    }
+    hash_desenganchar_entrada(origen, balde, PRIMERA);
+    entrada->temporizador = temporizador;
+    hash_ttl_transferir(origen, entrada, destino, entrada);
+    if(entrada->multiple){
+        origen->multiples--;
+        destino->multiples++;
+    }
+    HASH_CONTAR(destino, inserciones);
+    HASH_TRAZAR(destino, INSERTAR, entrada->clave, 1);
+    return EXITO;
+}
+
+/*
+ * Deja en la entrada del destino el elemento (y el vencimiento) de la
+ * entrada del origen, que se libera junto con su clave.
+ */
+static void usar_elemento_de_origen(hash_t* destino, ele_t* existente, hash_t* origen, size_t balde, ele_t* entrada){
+    hash_ttl_descartar(destino, existente);
+    hash_soltar_dato(destino, existente);
+    existente->elemento = entrada->elemento;
+    existente->multiple = entrada->multiple;
+    if(entrada->multiple){
+        origen->multiples--;
+        destino->multiples++;
+    }
+    hash_ttl_transferir(origen, entrada, destino, existente);
+    hash_desenganchar_entrada(origen, balde, PRIMERA);
+    hash_liberar_clave(origen, entrada);
+    free(entrada);
+    HASH_CONTAR(destino, reemplazos);
+    HASH_TRAZAR(destino, INSERTAR, existente->clave, 0);
+}
+
+int hash_fusionar(hash_t* destino, hash_t* origen, hash_politica_t politica){
+    if(!destino || !origen || destino == origen || !claves_compatibles(destino, origen) || destino->wal || origen->wal || hash_con_snapshots(origen))
+        return ERROR;
+    if(hash_reservar(destino, destino->cant_elementos + origen->cant_elementos) == ERROR)
+        return ERROR;
+    if(origen->rueda && rueda_cantidad(origen->rueda) && hash_ttl_preparar(destino) == ERROR)
+        return ERROR;
+    for(size_t i = 0; i < origen->capacidad; i++){
+        while(HASH_BALDE(origen, i)->lista){
+            ele_t* entrada = lista_primero(HASH_BALDE(origen, i)->lista);
+            if(hash_preparar_balde(destino, entrada->hash % destino->capacidad) == ERROR)
+                return ERROR;
+            entrada->clave_compartida = entrada->elemento_compartido = false;
+            ele_t* existente = hash_buscar_igual(destino, entrada);
+            if(!existente){
+                if(mover_entrada(destino, origen, i, entrada) == ERROR)
+                    return ERROR;
+            }else if(politica == HASH_USAR_ORIGEN){
+                usar_elemento_de_origen(destino, existente, origen, i, entrada);
+            }else{
+                hash_desenganchar_entrada(origen, i, PRIMERA);
+                hash_liberar_entrada(origen, entrada);
+            }
+        }
+    }
+    return EXITO;
+}
+
+/*
+ * Quita del hash las claves que estan en otro (si quitar_comunes) o las
+ * que no estan, sumando en quitadas las que pudo quitar. Devuelve 0 si
+ * recorrio todo el hash o -1 si tuvo que cortar a mitad de camino.
+ */
+static int filtrar(hash_t* hash, hash_t* otro, bool quitar_comunes, size_t* quitadas){
+    for(size_t i = 0; i < hash->capacidad; i++){
+        if(hash_preparar_balde(hash, i) == ERROR)
+            return ERROR;
+        size_t j = 0;
+        while(HASH_BALDE(hash, i)->lista && j < lista_elementos(HASH_BALDE(hash, i)->lista)){
+            ele_t* entrada = lista_elemento_en_posicion(HASH_BALDE(hash, i)->lista, j);
+            bool comun = hash == otro || hash_buscar_igual_vigente(otro, entrada);
+            if(comun != quitar_comunes){
+                j++;
+                continue;
+            }
+            if(hash->wal && hash_wal_anotar_quitado(hash, entrada->clave) == ERROR)
+                return ERROR;
+            HASH_TRAZAR(hash, QUITAR, entrada->clave, 1);
+            hash_desenganchar_entrada(hash, i, j);
+            if(hash->wal)
+                hash_wal_terminar(hash, true);
+            hash_liberar_entrada(hash, entrada);
+            HASH_CONTAR(hash, quitados);
+            (*quitadas)++;
+        }
+    }
+    return EXITO;
+}
+
+int hash_interseccion(hash_t* hash, hash_t* otro, size_t* quitadas){
+    size_t cantidad = VACIO;
+    int retorno = hash && otro ? filtrar(hash, otro, false, &cantidad) : ERROR;
+    if(quitadas)
+        *quitadas = cantidad;
+    return retorno;
+}
+
+int hash_diferencia(hash_t* hash, hash_t* otro, size_t* quitadas){
+    size_t cantidad = VACIO;
+    int retorno = hash && otro ? filtrar(hash, otro, true, &cantidad) : ERROR;
+    if(quitadas)
+        *quitadas = cantidad;
+    return retorno;
+}
@@ -0,0 +1,59 @@
+#ifndef __HASH_CONJUNTOS_H__
+#define __HASH_CONJUNTOS_H__
+
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Operaciones de conjuntos entre hashes. Las entradas se mueven de un
+ * hash al otro sin copiar sus claves ni volver a calcular su hash.
+ */
+
+/*
+ * Que elemento queda cuando una clave esta en los dos hashes.
+ */
+typedef enum hash_politica{
+    HASH_CONSERVAR_DESTINO,
+    HASH_USAR_ORIGEN
+}hash_politica_t;
+
+/*
+ * Mueve todas las claves del origen al destino, que se agranda una sola
+ * vez para recibirlas; el origen queda vacio. Si una clave esta en los
+ * dos, la politica decide que elemento queda y el otro se libera con el
+ * destructor de su hash. Los elementos movidos pasan a ser del destino,
+ * que los liberara con su destructor, y conservan su vencimiento (los
+ * dos hashes deben usar el mismo reloj).
+ *
+ * Los dos hashes tienen que guardar las claves de la misma forma: sin
+ * pool o con el mismo pool, y con el mismo destructor de claves. El
+ * origen no puede tener snapshots sin soltar y ninguno de los dos puede
+ * tener el log activo (hash_wal.h).
+ *
+ * Devuelve 0 si pudo o -1 si no pudo. Si falla a mitad de camino, cada
+ * clave queda en uno de los dos hashes.
+ */
+int hash_fusionar(hash_t* destino, hash_t* origen, hash_politica_t politica);
+
+/*
+ * Quita del hash las claves que no estan en otro, invocando al
+ * destructor con sus elementos. Otro no se modifica. Si quitadas no es
+ * NULL, guarda ahi la cantidad de claves quitadas.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo. Si falla a mitad de camino (sin
+ * memoria para copiar un balde compartido o sin poder anotar en el log)
+ * las claves quitadas hasta ahi no vuelven y quitadas las cuenta.
+ */
+int hash_interseccion(hash_t* hash, hash_t* otro, size_t* quitadas);
+
+/*
+ * Quita del hash las claves que estan en otro, invocando al destructor
+ * con sus elementos. Otro no se modifica. Si quitadas no es NULL, guarda
+ * ahi la cantidad de claves quitadas.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, con las mismas reglas que
+ * hash_interseccion para un fallo a mitad de camino.
+ */
+int hash_diferencia(hash_t* hash, hash_t* otro, size_t* quitadas);
+
+#endif /* __HASH_CONJUNTOS_H__ */
@@ -0,0 +1,356 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "hash.h"
+#include "hash_funciones.h"
+#include "hash_simd.h"
+#include "hash_cuckoo.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+#define LUGARES 4
+#define BALDES_MIN 2
+#define MAX_CARGA 95
+#define MAX_DESPLAZAMIENTOS 500
+#define SIN_LUGAR -2
+#define SEMILLA_AZAR 0x2545f4914f6cdd1dULL
+
+/*
+ * Balde de la tabla. Una etiqueta en 0 indica un lugar libre. Los
+ * elementos se guardan aparte, de forma que las etiquetas, los largos y
+ * las claves que se revisan al buscar quedan juntos. El relleno lleva el
+ * balde a una linea de cache y, como reserva alinea los arreglos a una
+ * linea, ningun balde queda partido entre dos.
+ */
+typedef struct balde{
+    char* claves[LUGARES];
+    uint32_t largos[LUGARES];
+    uint8_t etiquetas[LUGARES];
+    char relleno[RESERVA_ALINEACION - LUGARES * (sizeof(char*) + sizeof(uint32_t) + sizeof(uint8_t))];
+}balde_t;
+
+//Falla al compilar si el balde no ocupa justo una linea de cache
+typedef char balde_de_una_linea[sizeof(balde_t) == RESERVA_ALINEACION ? 1 : -1];
+
+struct hash_cuckoo{
+    balde_t* baldes;
+    void** elementos;
+    size_t cant_baldes;
+    size_t cantidad;
+    uint64_t azar;
+    hash_destruir_dato_t destructor;
+    const hash_nucleos_t* nucleos;
+    reserva_t reserva;
+};
+
+/*
+ * Clave que se esta ubicando, junto con lo que hace falta para moverla
+ * sin volver a hashearla.
+ */
+typedef struct entrada{
+    char* clave;
+    void* elemento;
+    uint8_t etiqueta;
+    size_t balde;
+    uint32_t largo;
+}entrada_t;
+
+//Calcula el primer balde y la etiqueta de la clave a partir de su hash
+static size_t balde_y_etiqueta(hash_cuckoo_t* hash, uint64_t valor, uint8_t* etiqueta){
+    *etiqueta = (uint8_t)(valor >> 56);
+    if(!*etiqueta)
+        *etiqueta = 1;
+    return (size_t)valor & (hash->cant_baldes - 1);
+}
+
+/*
+ * Devuelve el otro balde posible de una clave a partir de uno de ellos y
+ * de su etiqueta, sin necesitar la clave.
+ */
+static size_t balde_alternativo(hash_cuckoo_t* hash, size_t balde, uint8_t etiqueta){
+    return (balde ^ (size_t)hash_mezclar(etiqueta)) & (hash->cant_baldes - 1);
+}
+
+//Generador xorshift para elegir a quien desplazar
+static size_t azar(hash_cuckoo_t* hash){
+    hash->azar ^= hash->azar << 13;
+    hash->azar ^= hash->azar >> 7;
+    hash->azar ^= hash->azar << 17;
+    return (size_t)hash->azar;
+}
+
+hash_cuckoo_t* hash_cuckoo_crear(hash_destruir_dato_t destruir_elemento, size_t capacidad){
+    return hash_cuckoo_crear_con_reserva(destruir_elemento, capacidad, NULL);
+}
+
+hash_cuckoo_t* hash_cuckoo_crear_con_reserva(hash_destruir_dato_t destruir_elemento, size_t capacidad, const reserva_t* reserva){
+    if(!capacidad)
+        return NULL;
+    hash_cuckoo_t* hash = calloc(1, sizeof(hash_cuckoo_t));
+    if(!hash)
+        return NULL;
+    if(reserva)
+        hash->reserva = *reserva;
+    size_t baldes = BALDES_MIN;
+    while(baldes * LUGARES * MAX_CARGA / 100 < capacidad)
+        baldes *= 2;
+    hash->baldes = reserva_obtener(&hash->reserva, baldes * sizeof(balde_t));
+    hash->elementos = reserva_obtener(&hash->reserva, baldes * LUGARES * sizeof(void*));
+    if(!hash->baldes || !hash->elementos){
+        reserva_liberar(hash->baldes);
+        reserva_liberar(hash->elementos);
+        free(hash);
+        return NULL;
+    }
+    hash->cant_baldes = baldes;
+    hash->azar = SEMILLA_AZAR;
+    hash->destructor = destruir_elemento;
+    hash->nucleos = hash_simd_nucleos();
+    return hash;
+}
+
+/*
+ * Devuelve la posicion (balde * LUGARES + lugar) de la clave o ERROR si
+ * no esta. Revisa solo los dos baldes posibles.
+ */
+static long buscar(hash_cuckoo_t* hash, const char* clave, size_t largo, uint64_t valor){
+    uint8_t etiqueta;
+    size_t balde = balde_y_etiqueta(hash, valor, &etiqueta);
+    for(int intento = 0; intento < 2; intento++){
+        balde_t* actual = &hash->baldes[balde];
+        uint32_t candidatos = hash->nucleos->coincidencias(actual->etiquetas, LUGARES, etiqueta);
+        while(candidatos){
+            size_t lugar = (size_t)__builtin_ctz(candidatos);
+            if(actual->largos[lugar] == largo && hash->nucleos->iguales(actual->claves[lugar], clave, largo))
+                return (long)(balde * LUGARES + lugar);
+            candidatos &= candidatos - 1;
+        }
+        balde = balde_alternativo(hash, balde, etiqueta);
+    }
+    return ERROR;
+}
+
+//Busca la clave calculando su largo y su hash
+static long buscar_clave(hash_cuckoo_t* hash, const char* clave){
+    size_t largo = strlen(clave);
+    return buscar(hash, clave, largo, hash->nucleos->hashear(clave, largo));
+}
+
+//Guarda la entrada en un lugar libre del balde; devuelve false si esta lleno
+static bool guardar_en(hash_cuckoo_t* hash, size_t balde, entrada_t* entrada){
+    for(size_t lugar = 0; lugar < LUGARES; lugar++){
+        if(hash->baldes[balde].etiquetas[lugar])
+            continue;
+        hash->baldes[balde].etiquetas[lugar] = entrada->etiqueta;
+        hash->baldes[balde].largos[lugar] = entrada->largo;
+        hash->baldes[balde].claves[lugar] = entrada->clave;
+        hash->elementos[balde * LUGARES + lugar] = entrada->elemento;
+        return true;
+    }
+    return false;
+}
+
+//Intercambia la entrada con la que esta en la posicion dada
+static void intercambiar(hash_cuckoo_t* hash, size_t posicion, entrada_t* entrada){
+    balde_t* balde = &hash->baldes[posicion / LUGARES];
+    size_t lugar = posicion % LUGARES;
+    entrada_t desplazada = {balde->claves[lugar], hash->elementos[posicion], balde->etiquetas[lugar], posicion / LUGARES, balde->largos[lugar]};
+    balde->etiquetas[lugar] = entrada->etiqueta;
+    balde->largos[lugar] = entrada->largo;
+    balde->claves[lugar] = entrada->clave;
+    hash->elementos[posicion] = entrada->elemento;
+    *entrada = desplazada;
+}
+
+/*
+ * Ubica la entrada en alguno de sus dos baldes, desplazando claves a su
+ * otro balde si hace falta. Si llega al limite de desplazamientos deshace
+ * los desplazamientos, dejando la tabla y la entrada como estaban, y
+ * devuelve false.
+ */
+static bool ubicar(hash_cuckoo_t* hash, entrada_t* entrada){
+    if(guardar_en(hash, entrada->balde, entrada))
+        return true;
+    size_t alternativo = balde_alternativo(hash, entrada->balde, entrada->etiqueta);
+    if(guardar_en(hash, alternativo, entrada))
+        return true;
+    size_t camino[MAX_DESPLAZAMIENTOS];
+    size_t balde = azar(hash) & 1 ? alternativo : entrada->balde;
+    for(size_t i = 0; i < MAX_DESPLAZAMIENTOS; i++){
+        camino[i] = balde * LUGARES + azar(hash) % LUGARES;
+        intercambiar(hash, camino[i], entrada);
+        balde = balde_alternativo(hash, entrada->balde, entrada->etiqueta);
+        entrada->balde = balde;
+        if(guardar_en(hash, balde, entrada))
+            return true;
+    }
+    for(size_t i = MAX_DESPLAZAMIENTOS; i > 0; i--)
+        intercambiar(hash, camino[i - 1], entrada);
+    return false;
+}
+
+/*
+ * Intenta reubicar todas las claves, junto con la entrada que habia
+ * quedado sin lugar (si hay una), en una tabla con la cantidad de baldes
+ * dada. Las claves se vuelven a hashear porque su primer balde depende
+ * de la cantidad de baldes.
+ *
+ * Devuelve EXITO si pudo, ERROR si no pudo reservar memoria o
+ * SIN_LUGAR si alguna clave no entro, y en esos casos el hash queda
+ * intacto.
+ */
+static int reconstruir(hash_cuckoo_t* hash, size_t cant_baldes, entrada_t* sin_lugar){
+    hash_cuckoo_t nuevo = *hash;
+    nuevo.cant_baldes = cant_baldes;
+    nuevo.baldes = reserva_obtener(&hash->reserva, cant_baldes * sizeof(balde_t));
+    nuevo.elementos = reserva_obtener(&hash->reserva, cant_baldes * LUGARES * sizeof(void*));
+    if(!nuevo.baldes || !nuevo.elementos){
+        reserva_liberar(nuevo.baldes);
+        reserva_liberar(nuevo.elementos);
+        return ERROR;
+    }
+    bool ubicadas = true;
+    for(size_t balde = 0; balde < hash->cant_baldes && ubicadas; balde++){
+        for(size_t lugar = 0; lugar < LUGARES && ubicadas; lugar++){
+            if(!hash->baldes[balde].etiquetas[lugar])
+                continue;
+            entrada_t entrada = {hash->baldes[balde].claves[lugar], hash->elementos[balde * LUGARES + lugar], 0, 0, hash->baldes[balde].largos[lugar]};
+            entrada.balde = balde_y_etiqueta(&nuevo, hash->nucleos->hashear(entrada.clave, entrada.largo), &entrada.etiqueta);
+            ubicadas = ubicar(&nuevo, &entrada);
+        }
+    }
+    if(ubicadas && sin_lugar){
+        entrada_t entrada = *sin_lugar;
+        entrada.balde = balde_y_etiqueta(&nuevo, hash->nucleos->hashear(entrada.clave, entrada.largo), &entrada.etiqueta);
+        ubicadas = ubicar(&nuevo, &entrada);
+    }
+    if(!ubicadas){
+        reserva_liberar(nuevo.baldes);
+        reserva_liberar(nuevo.elementos);
+        return SIN_LUGAR;
+    }
+    reserva_liberar(hash->baldes);
+    reserva_liberar(hash->elementos);
+    *hash = nuevo;
+    return EXITO;
+}
+
+//Agranda la tabla hasta que entren todas las claves
+static int agrandar(hash_cuckoo_t* hash, entrada_t* sin_lugar){
+    size_t cant_baldes = hash->cant_baldes * 2;
+    int retorno;
+    while((retorno = reconstruir(hash, cant_baldes, sin_lugar)) == SIN_LUGAR)
+        cant_baldes *= 2;
+    return retorno;
+}
+
+int hash_cuckoo_insertar(hash_cuckoo_t* hash, const char* clave, void* elemento){
+    if(!hash || !clave)
+        return ERROR;
+    size_t largo = strlen(clave);
+    if(largo > UINT32_MAX)
+        return ERROR;
+    uint64_t valor = hash->nucleos->hashear(clave, largo);
+    long posicion = buscar(hash, clave, largo, valor);
+    if(posicion != ERROR){
+        void* anterior = hash->elementos[posicion];
+        hash->elementos[posicion] = elemento;
+        if(hash->destructor && anterior != elemento)
+            hash->destructor(anterior);
+        return EXITO;
+    }
+    if((hash->cantidad + 1) * 100 > hash->cant_baldes * LUGARES * MAX_CARGA && agrandar(hash, NULL) == ERROR)
+        return ERROR;
+    entrada_t entrada = {malloc(largo + 1), elemento, 0, 0, (uint32_t)largo};
+    if(!entrada.clave)
+        return ERROR;
+    memcpy(entrada.clave, clave, largo + 1);
+    entrada.balde = balde_y_etiqueta(hash, valor, &entrada.etiqueta);
+    if(!ubicar(hash, &entrada) && agrandar(hash, &entrada) == ERROR){
+        free(entrada.clave);
+        return ERROR;
+    }
+    hash->cantidad++;
+    return EXITO;
+}
+
+int hash_cuckoo_quitar(hash_cuckoo_t* hash, const char* clave){
+    if(!hash || !clave)
+        return ERROR;
+    long posicion = buscar_clave(hash, clave);
+    if(posicion == ERROR)
+        return ERROR;
+    balde_t* balde = &hash->baldes[(size_t)posicion / LUGARES];
+    size_t lugar = (size_t)posicion % LUGARES;
+    free(balde->claves[lugar]);
+    if(hash->destructor)
+        hash->destructor(hash->elementos[posicion]);
+    balde->etiquetas[lugar] = 0;
+    balde->claves[lugar] = NULL;
+    hash->elementos[posicion] = NULL;
+    hash->cantidad--;
+    return EXITO;
+}
+
+void* hash_cuckoo_obtener(hash_cuckoo_t* hash, const char* clave){
+    if(!hash || !clave)
+        return NULL;
+    long posicion = buscar_clave(hash, clave);
+    if(posicion == ERROR)
+        return NULL;
+    return hash->elementos[posicion];
+}
+
+bool hash_cuckoo_contiene(hash_cuckoo_t* hash, const char* clave){
+    if(!hash || !clave)
+        return false;
+    return buscar_clave(hash, clave) != ERROR;
+}
+
+size_t hash_cuckoo_cantidad(hash_cuckoo_t* hash){
+    if(!hash)
+        return VACIO;
+    return hash->cantidad;
+}
+
+size_t hash_cuckoo_capacidad(hash_cuckoo_t* hash){
+    if(!hash)
+        return VACIO;
+    return hash->cant_baldes * LUGARES;
+}
+
+size_t hash_cuckoo_con_cada_clave(hash_cuckoo_t* hash, bool (*funcion)(hash_cuckoo_t* hash, const char* clave, void* aux), void* aux){
+    if(!hash || !funcion)
+        return VACIO;
+    size_t cantidad = 0;
+    bool corte = false;
+    for(size_t balde = 0; balde < hash->cant_baldes && !corte; balde++){
+        for(size_t lugar = 0; lugar < LUGARES && !corte; lugar++){
+            if(!hash->baldes[balde].etiquetas[lugar])
+                continue;
+            corte = funcion(hash, hash->baldes[balde].claves[lugar], aux);
+            cantidad++;
+        }
+    }
+    return cantidad;
+}
+
+void hash_cuckoo_destruir(hash_cuckoo_t* hash){
+    if(!hash)
+        return;
+    for(size_t balde = 0; balde < hash->cant_baldes; balde++){
+        for(size_t lugar = 0; lugar < LUGARES; lugar++){
+            if(!hash->baldes[balde].etiquetas[lugar])
+                continue;
+            free(hash->baldes[balde].claves[lugar]);
+            if(hash->destructor)
+                hash->destructor(hash->elementos[balde * LUGARES + lugar]);
+        }
+    }
+    reserva_liberar(hash->baldes);
+    reserva_liberar(hash->elementos);
+    free(hash);
+}
@@ -0,0 +1,94 @@
+#ifndef __HASH_CUCKOO_H__
+#define __HASH_CUCKOO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hash.h"
+#include "reserva.h"
+
+/*
+ * Hash cuckoo con baldes de 4 lugares. Cada clave puede estar solo en
+ * uno de sus dos baldes posibles, por lo que una busqueda revisa a lo
+ * sumo dos baldes sin importar la carga. Cada balde ocupa una linea de
+ * cache alineada, asi que revisarlos lee a lo sumo dos lineas (mas la
+ * de la clave y la del elemento si la encuentra). Cada lugar guarda una
+ * etiqueta de 8 bits del hash de la clave, asi que casi nunca se
+ * compara una clave que no es la buscada.
+ *
+ * Al insertar en dos baldes llenos se desplaza una clave a su otro
+ * balde, y asi sucesivamente hasta un limite de desplazamientos; si se
+ * llega al limite la tabla se agranda.
+ *
+ * Tiene la misma interfaz que el hash abierto.
+ */
+typedef struct hash_cuckoo hash_cuckoo_t;
+
+/*
+ * Crea el hash reservando lugar para la capacidad dada de elementos
+ * (minimo 3). El destructor se invoca con cada elemento que se quite o
+ * reemplace.
+ *
+ * Devuelve el hash creado o NULL en caso de error.
+ */
+hash_cuckoo_t* hash_cuckoo_crear(hash_destruir_dato_t destruir_elemento, size_t capacidad);
+
+/*
+ * Igual que hash_cuckoo_crear, pero los baldes y los elementos se
+ * reservan al crear y al reconstruir la tabla segun las opciones de
+ * reserva (paginas grandes y ubicacion NUMA). Si reserva es NULL usa
+ * malloc.
+ *
+ * Devuelve el hash creado o NULL en caso de error.
+ */
+hash_cuckoo_t* hash_cuckoo_crear_con_reserva(hash_destruir_dato_t destruir_elemento, size_t capacidad, const reserva_t* reserva);
+
+/*
+ * Inserta el elemento asociado a una copia de la clave. Si la clave ya
+ * existia se reemplaza su elemento.
+ *
+ * Devuelve 0 si pudo guardarlo o -1 si no pudo.
+ */
+int hash_cuckoo_insertar(hash_cuckoo_t* hash, const char* clave, void* elemento);
+
+/*
+ * Quita el elemento de la clave e invoca al destructor.
+ * Devuelve 0 si pudo quitarlo o -1 si no pudo (o si no estaba).
+ */
+int hash_cuckoo_quitar(hash_cuckoo_t* hash, const char* clave);
+
+/*
+ * Devuelve el elemento de la clave o NULL si no esta (o en caso de
+ * error).
+ */
+void* hash_cuckoo_obtener(hash_cuckoo_t* hash, const char* clave);
+
+/*
+ * Devuelve true si el hash contiene la clave o false en caso contrario.
+ */
+bool hash_cuckoo_contiene(hash_cuckoo_t* hash, const char* clave);
+
+/*
+ * Devuelve la cantidad de elementos del hash o 0 en caso de error.
+ */
+size_t hash_cuckoo_cantidad(hash_cuckoo_t* hash);
+
+/*
+ * Devuelve la cantidad de lugares del hash (cuatro por balde) o 0 en
+ * caso de error.
+ */
+size_t hash_cuckoo_capacidad(hash_cuckoo_t* hash);
+
+/*
+ * Recorre las claves del hash invocando a la funcion con cada una, hasta
+ * que devuelva true. No se debe modificar el hash durante el recorrido.
+ *
+ * Devuelve la cantidad de claves recorridas.
+ */
+size_t hash_cuckoo_con_cada_clave(hash_cuckoo_t* hash, bool (*funcion)(hash_cuckoo_t* hash, const char* clave, void* aux), void* aux);
+
+/*
+ * Destruye el hash invocando al destructor con cada elemento.
+ */
+void hash_cuckoo_destruir(hash_cuckoo_t* hash);
+
+#endif /* __HASH_CUCKOO_H__ */
@@ -0,0 +1,62 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "lista.h"
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_estadisticas.h"
+
+#define ERROR -1
+#define EXITO 0
+#define NANOSEGUNDOS 1000000000ULL
+
+uint64_t hash_reloj_ns(void){
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (uint64_t)ahora.tv_sec * NANOSEGUNDOS + (uint64_t)ahora.tv_nsec;
+}
+
+//Suma los bytes de la clave del elemento al total recibido
+static void sumar_clave(void* dato, void* contexto){
+    *(size_t*)contexto += strlen(((ele_t*)dato)->clave) + 1;
+}
+
+int hash_estadisticas(hash_t* hash, hash_estadisticas_t* estadisticas){
+    if(!hash || !estadisticas)
+        return ERROR;
+    memset(estadisticas, 0, sizeof(hash_estadisticas_t));
+    estadisticas->cantidad = hash->cant_elementos;
+    estadisticas->capacidad = hash->capacidad;
+    estadisticas->factor_carga = (double)hash->cant_elementos / (double)hash->capacidad;
+    estadisticas->rehashes = hash->rehashes;
+    estadisticas->tiempo_rehash_ns = hash->tiempo_rehash_ns;
+    estadisticas->contadores = hash->contadores;
+    estadisticas->bytes_baldes = HASH_BYTES_PAGINAS(hash->capacidad);
+    estadisticas->bytes_entradas = hash->cant_elementos * (sizeof(ele_t) + hash->extra_entrada);
+
+    size_t ocupados = 0;
+    for(size_t i = 0; i < hash->capacidad; i++){
+        lista_t* lista = HASH_BALDE(hash, i)->lista;
+        size_t largo = lista_elementos(lista);
+        if(lista){
+            estadisticas->bytes_baldes += lista_tamanio_estructura();
+            estadisticas->bytes_entradas += lista_tamanio_nodos(lista);
+            if(!hash->pool)
+                lista_con_cada_elemento(lista, sumar_clave, &estadisticas->bytes_claves);
+        }
+        if(!largo)
+            estadisticas->baldes_vacios++;
+        else
+            ocupados++;
+        if(largo > estadisticas->cadena_maxima)
+            estadisticas->cadena_maxima = largo;
+        estadisticas->histograma[largo < HASH_COLUMNAS_HISTOGRAMA ? largo : HASH_COLUMNAS_HISTOGRAMA - 1]++;
+    }
+    if(ocupados)
+        estadisticas->cadena_promedio = (double)hash->cant_elementos / (double)ocupados;
+    return EXITO;
+}
@@ -0,0 +1,65 @@
+#ifndef __HASH_ESTADISTICAS_H__
+#define __HASH_ESTADISTICAS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hash.h"
+
+/*
+ * Cantidad de columnas del histograma de largos de cadena. La ultima
+ * columna acumula los baldes con ese largo o mas.
+ */
+#define HASH_COLUMNAS_HISTOGRAMA 16
+
+/*
+ * Contadores por operacion. Solo se actualizan si la biblioteca se
+ * compila con -DHASH_CONTADORES; si no, quedan siempre en 0 y no
+ * cuestan nada.
+ */
+typedef struct hash_contadores{
+    size_t inserciones;
+    size_t reemplazos;
+    size_t busquedas;
+    size_t aciertos;
+    size_t fallos;
+    size_t descartes_filtro;
+    size_t quitados;
+    size_t paginas_copiadas;
+}hash_contadores_t;
+
+typedef struct hash_estadisticas{
+    size_t cantidad;
+    size_t capacidad;
+    double factor_carga;
+    size_t baldes_vacios;
+    size_t histograma[HASH_COLUMNAS_HISTOGRAMA];
+    size_t cadena_maxima;
+    double cadena_promedio;
+    size_t rehashes;
+    uint64_t tiempo_rehash_ns;
+    size_t bytes_baldes;
+    size_t bytes_entradas;
+    size_t bytes_claves;
+    hash_contadores_t contadores;
+}hash_estadisticas_t;
+
+/*
+ * Completa las estadisticas del hash:
+ *  - cantidad y capacidad, y el factor de carga real (elementos sobre
+ *    baldes, a diferencia del umbral de rehash que usa baldes ocupados).
+ *  - baldes vacios, histograma de largos de cadena, cadena maxima y
+ *    largo promedio de las cadenas no vacias.
+ *  - cantidad de rehash y tiempo total pasado en ellos.
+ *  - bytes usados por los baldes (paginas y listas), por las entradas
+ *    (nodos y elementos de la tabla) y por las claves (salvo que sean
+ *    de un pool).
+ *  - los contadores por operacion, si se compilaron.
+ *
+ * Recorre toda la tabla, por lo que su costo es proporcional a la
+ * capacidad mas la cantidad de elementos.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo.
+ */
+int hash_estadisticas(hash_t* hash, hash_estadisticas_t* estadisticas);
+
+#endif /* __HASH_ESTADISTICAS_H__ */
@@ -0,0 +1,46 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "lista.h"
+#include "hash.h"
+#include "hash_interno.h"
+#include "filtro.h"
+#include "hash_filtro.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+
+//Agrega la clave del elemento al filtro recibido
+static void agregar_al_filtro(void* dato, void* contexto){
+    filtro_agregar(contexto, ((ele_t*)dato)->clave);
+}
+
+int hash_filtro_reconstruir(hash_t* hash){
+    size_t dimension = hash->capacidad > hash->cant_elementos ? hash->capacidad : hash->cant_elementos;
+    filtro_t* filtro = filtro_crear(dimension, hash->bits_filtro);
+    if(!filtro)
+        return ERROR;
+    for(size_t i = 0; i < hash->capacidad; i++)
+        lista_con_cada_elemento(HASH_BALDE(hash, i)->lista, agregar_al_filtro, filtro);
+    filtro_destruir(hash->filtro);
+    hash->filtro = filtro;
+    return EXITO;
+}
+
+int hash_activar_filtro(hash_t* hash, size_t bits_por_clave){
+    if(!hash || !bits_por_clave)
+        return ERROR;
+    size_t anterior = hash->bits_filtro;
+    hash->bits_filtro = bits_por_clave;
+    if(hash_filtro_reconstruir(hash) == ERROR){
+        hash->bits_filtro = anterior;
+        return ERROR;
+    }
+    return EXITO;
+}
+
+size_t hash_exportar_filtro(hash_t* hash, void* buffer, size_t tamanio){
+    if(!hash || !hash->filtro)
+        return VACIO;
+    return filtro_exportar(hash->filtro, buffer, tamanio);
+}
@@ -0,0 +1,31 @@
+#ifndef __HASH_FILTRO_H__
+#define __HASH_FILTRO_H__
+
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Activa un filtro de pertenencia delante del hash, con bits_por_clave
+ * posiciones por clave. Mientras el filtro este activo, las busquedas
+ * de claves que seguro no estan (hash_obtener, hash_contiene y
+ * hash_quitar) se resuelven sin recorrer la tabla. El filtro se
+ * mantiene al insertar y quitar y se reconstruye en cada rehash.
+ *
+ * Si el hash ya tenia un filtro, se reemplaza por uno nuevo.
+ *
+ * Devuelve 0 si pudo activarlo o -1 si no pudo.
+ */
+int hash_activar_filtro(hash_t* hash, size_t bits_por_clave);
+
+/*
+ * Escribe en el buffer el filtro del hash en el formato de
+ * filtro_exportar, para que otros procesos puedan descartar claves
+ * antes de consultar. Si el buffer es NULL o no alcanza no se escribe
+ * nada.
+ *
+ * Devuelve la cantidad de bytes que ocupa el filtro exportado o 0 si
+ * el hash no tiene filtro (o en caso de error).
+ */
+size_t hash_exportar_filtro(hash_t* hash, void* buffer, size_t tamanio);
+
+#endif /* __HASH_FILTRO_H__ */
@@ -0,0 +1,24 @@
+#include <stddef.h>
+#include <stdint.h>
+#include "hash_funciones.h"
+
+#define FNV_BASE 0xcbf29ce484222325ULL
+#define FNV_PRIMO 0x100000001b3ULL
+
+uint64_t hash_fnv1a(const char* clave, size_t largo, uint64_t semilla){
+    uint64_t numero = FNV_BASE ^ semilla;
+    for(size_t i = 0; i < largo; i++){
+        numero ^= (uint8_t)clave[i];
+        numero *= FNV_PRIMO;
+    }
+    return numero;
+}
+
+uint64_t hash_mezclar(uint64_t valor){
+    valor ^= valor >> 33;
+    valor *= 0xff51afd7ed558ccdULL;
+    valor ^= valor >> 33;
+    valor *= 0xc4ceb9fe1a85ec53ULL;
+    valor ^= valor >> 33;
+    return valor;
+}
@@ -0,0 +1,29 @@
+#ifndef __HASH_FUNCIONES_H__
+#define __HASH_FUNCIONES_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Funciones de hash de uso interno compartidas por las distintas
+ * estructuras de la biblioteca. A diferencia del hasheador del hash
+ * abierto, estas funciones dan el mismo resultado en todas las
+ * ejecuciones y plataformas, por lo que pueden usarse en formatos
+ * que se guardan en disco.
+ */
+
+/*
+ * Calcula el hash FNV-1a de 64 bits de los primeros largo bytes de
+ * clave, partiendo de la semilla dada. Con semillas distintas se
+ * obtienen funciones de hash independientes entre si.
+ */
+uint64_t hash_fnv1a(const char* clave, size_t largo, uint64_t semilla);
+
+/*
+ * Mezcla los bits de un valor de 64 bits de forma que cada bit de
+ * entrada afecte a todos los de salida. Sirve para derivar hashes
+ * secundarios a partir de uno ya calculado.
+ */
+uint64_t hash_mezclar(uint64_t valor);
+
+#endif /* __HASH_FUNCIONES_H__ */
@@ -0,0 +1,455 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "hash.h"
+#include "hash_simd.h"
+#include "hash_hamt.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+#define MARCA_NODO 1
+#define BITS_POR_NIVEL 5
+#define NIVELES 13
+#define MASCARA_NIVEL 31
+
+/*
+ * Clave del hash con su elemento. Las versiones comparten las hojas;
+ * la clave y el elemento se liberan cuando se suelta la ultima
+ * referencia.
+ */
+typedef struct hoja{
+    size_t referencias;
+    char* clave;
+    void* elemento;
+    uint64_t hash;
+    size_t largo;
+}hoja_t;
+
+/*
+ * Nodo interno del trie. Los hijos son hojas o nodos marcados con
+ * MARCA_NODO en el bit mas bajo del puntero, ordenados segun los bits
+ * del mapa. Debajo del ultimo nivel estan los nodos de colisiones, con
+ * el mapa en 0 y al menos dos hojas de claves con el mismo hash.
+ */
+typedef struct nodo{
+    size_t referencias;
+    uint32_t mapa;
+    uint32_t cantidad;
+    void* hijos[];
+}nodo_t;
+
+struct hash_hamt{
+    void* raiz;
+    size_t cantidad;
+    hash_destruir_dato_t destructor;
+    const hash_nucleos_t* nucleos;
+};
+
+typedef struct buscada{
+    const char* clave;
+    size_t largo;
+    uint64_t hash;
+}buscada_t;
+
+static bool es_nodo(void* hijo){
+    return (uintptr_t)hijo & MARCA_NODO;
+}
+
+static nodo_t* nodo_de(void* hijo){
+    return (nodo_t*)((uintptr_t)hijo - MARCA_NODO);
+}
+
+static void* marcar(nodo_t* nodo){
+    return (void*)((uintptr_t)nodo + MARCA_NODO);
+}
+
+//Devuelve el bit del mapa que le corresponde al hash en ese nivel
+static uint32_t bit_de(uint64_t hash, size_t nivel){
+    return (uint32_t)1 << ((hash >> (nivel * BITS_POR_NIVEL)) & MASCARA_NIVEL);
+}
+
+//Devuelve la posicion en el nodo del hijo de ese bit
+static uint32_t posicion_de(nodo_t* nodo, uint32_t bit){
+    return (uint32_t)__builtin_popcount(nodo->mapa & (bit - 1));
+}
+
+static buscada_t preparar(hash_hamt_t* hash, const char* clave){
+    buscada_t buscada;
+    buscada.clave = clave;
+    buscada.largo = strlen(clave);
+    buscada.hash = hash->nucleos->hashear(clave, buscada.largo);
+    return buscada;
+}
+
+static bool coincide(hash_hamt_t* hash, hoja_t* hoja, const buscada_t* buscada){
+    return hoja->hash == buscada->hash && hoja->largo == buscada->largo && hash->nucleos->iguales(hoja->clave, buscada->clave, buscada->largo);
+}
+
+static void retener(void* hijo){
+    if(es_nodo(hijo))
+        nodo_de(hijo)->referencias++;
+    else
+        ((hoja_t*)hijo)->referencias++;
+}
+
+/*
+ * Suelta una referencia al hijo. Si era la ultima lo libera, soltando
+ * sus hijos si es un nodo o su clave y su elemento si es una hoja.
+ */
+static void soltar(hash_hamt_t* hash, void* hijo){
+    if(es_nodo(hijo)){
+        nodo_t* nodo = nodo_de(hijo);
+        if(--nodo->referencias)
+            return;
+        for(uint32_t i = 0; i < nodo->cantidad; i++)
+            soltar(hash, nodo->hijos[i]);
+        free(nodo);
+        return;
+    }
+    hoja_t* hoja = hijo;
+    if(--hoja->referencias)
+        return;
+    if(hash->destructor)
+        hash->destructor(hoja->elemento);
+    free(hoja->clave);
+    free(hoja);
+}
+
+static nodo_t* crear_nodo(uint32_t mapa, uint32_t cantidad){
+    nodo_t* nodo = malloc(sizeof(nodo_t) + cantidad * sizeof(void*));
+    if(!nodo)
+        return NULL;
+    nodo->referencias = 1;
+    nodo->mapa = mapa;
+    nodo->cantidad = cantidad;
+    return nodo;
+}
+
+/*
+ * El nodo deja de estar en el lugar de donde se saco y lo reemplaza
+ * otro que tiene sus mismos hijos. Si el nodo era solo de ese lugar se
+ * libera y sus referencias pasan al nuevo; si no, el nuevo toma
+ * referencias propias.
+ */
+static void heredar(nodo_t* nodo){
+    if(nodo->referencias == 1){
+        free(nodo);
+        return;
+    }
+    nodo->referencias--;
+    for(uint32_t i = 0; i < nodo->cantidad; i++)
+        retener(nodo->hijos[i]);
+}
+
+/*
+ * Devuelve el nodo listo para modificarlo en el lugar: el mismo si es
+ * solo de quien llama, o una copia si lo comparte con otra version.
+ * Devuelve NULL en caso de error, en cuyo caso el nodo queda intacto.
+ */
+static nodo_t* propio(nodo_t* nodo){
+    if(nodo->referencias == 1)
+        return nodo;
+    nodo_t* copia = crear_nodo(nodo->mapa, nodo->cantidad);
+    if(!copia)
+        return NULL;
+    memcpy(copia->hijos, nodo->hijos, nodo->cantidad * sizeof(void*));
+    heredar(nodo);
+    return copia;
+}
+
+/*
+ * Devuelve un nodo con los hijos del dado y el hijo nuevo en la
+ * posicion, que reemplaza al dado, o NULL en caso de error, en cuyo caso
+ * el nodo queda intacto.
+ */
+static nodo_t* con_hijo(nodo_t* nodo, uint32_t bit, uint32_t posicion, void* hijo){
+    nodo_t* nuevo = crear_nodo(nodo->mapa | bit, nodo->cantidad + 1);
+    if(!nuevo)
+        return NULL;
+    memcpy(nuevo->hijos, nodo->hijos, posicion * sizeof(void*));
+    nuevo->hijos[posicion] = hijo;
+    memcpy(nuevo->hijos + posicion + 1, nodo->hijos + posicion, (nodo->cantidad - posicion) * sizeof(void*));
+    heredar(nodo);
+    return nuevo;
+}
+
+//Libera los nodos que armo unir, sin las hojas
+static void deshacer(nodo_t* nodo){
+    for(uint32_t i = 0; i < nodo->cantidad; i++)
+        if(es_nodo(nodo->hijos[i]))
+            deshacer(nodo_de(nodo->hijos[i]));
+    free(nodo);
+}
+
+/*
+ * Arma el subarbol de ese nivel con las dos hojas, de claves distintas.
+ * Devuelve su nodo o NULL en caso de error.
+ */
+static nodo_t* unir(hoja_t* a, hoja_t* b, size_t nivel){
+    if(nivel == NIVELES){
+        nodo_t* colisiones = crear_nodo(VACIO, 2);
+        if(!colisiones)
+            return NULL;
+        colisiones->hijos[0] = a;
+        colisiones->hijos[1] = b;
+        return colisiones;
+    }
+    uint32_t bit_a = bit_de(a->hash, nivel), bit_b = bit_de(b->hash, nivel);
+    if(bit_a == bit_b){
+        nodo_t* hijo = unir(a, b, nivel + 1);
+        if(!hijo)
+            return NULL;
+        nodo_t* nodo = crear_nodo(bit_a, 1);
+        if(!nodo){
+            deshacer(hijo);
+            return NULL;
+        }
+        nodo->hijos[0] = marcar(hijo);
+        return nodo;
+    }
+    nodo_t* nodo = crear_nodo(bit_a | bit_b, 2);
+    if(!nodo)
+        return NULL;
+    nodo->hijos[bit_a < bit_b ? 0 : 1] = a;
+    nodo->hijos[bit_a < bit_b ? 1 : 0] = b;
+    return nodo;
+}
+
+/*
+ * Pone la hoja en el subarbol de ese nivel que esta en lugar, que es la
+ * raiz de la version o un hijo de un nodo que es solo de ella. Si la
+ * clave ya estaba deja su hoja en anterior, y quien llama debe soltarla.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso el subarbol tiene
+ * las mismas claves que antes.
+ */
+static int insertar_en(hash_hamt_t* hash, void** lugar, hoja_t* hoja, size_t nivel, hoja_t** anterior){
+    buscada_t buscada = {hoja->clave, hoja->largo, hoja->hash};
+    if(!*lugar){
+        *lugar = hoja;
+        return EXITO;
+    }
+    if(!es_nodo(*lugar)){
+        hoja_t* otra = *lugar;
+        if(coincide(hash, otra, &buscada)){
+            *anterior = otra;
+            *lugar = hoja;
+            return EXITO;
+        }
+        nodo_t* nodo = unir(otra, hoja, nivel);
+        if(!nodo)
+            return ERROR;
+        *lugar = marcar(nodo);
+        return EXITO;
+    }
+    nodo_t* nodo = nodo_de(*lugar);
+    uint32_t posicion = 0, bit = 0;
+    if(nodo->mapa){
+        bit = bit_de(hoja->hash, nivel);
+        posicion = posicion_de(nodo, bit);
+    }else{
+        while(posicion < nodo->cantidad && !coincide(hash, nodo->hijos[posicion], &buscada))
+            posicion++;
+    }
+    if(nodo->mapa ? !(nodo->mapa & bit) : posicion == nodo->cantidad){
+        nodo_t* nuevo = con_hijo(nodo, bit, posicion, hoja);
+        if(!nuevo)
+            return ERROR;
+        *lugar = marcar(nuevo);
+        return EXITO;
+    }
+    nodo = propio(nodo);
+    if(!nodo)
+        return ERROR;
+    *lugar = marcar(nodo);
+    return insertar_en(hash, &nodo->hijos[posicion], hoja, nivel + 1, anterior);
+}
+
+/*
+ * Saca la hoja de la clave, que tiene que estar, del subarbol de ese
+ * nivel que esta en lugar. Los nodos que quedan con una sola hoja se
+ * reemplazan por ella. Devuelve la hoja, cuya referencia pasa a quien
+ * llama, o NULL en caso de error, en cuyo caso el subarbol tiene las
+ * mismas claves que antes.
+ */
+static hoja_t* quitar_en(hash_hamt_t* hash, void** lugar, const buscada_t* buscada, size_t nivel){
+    if(!es_nodo(*lugar)){
+        hoja_t* hoja = *lugar;
+        *lugar = NULL;
+        return hoja;
+    }
+    nodo_t* nodo = propio(nodo_de(*lugar));
+    if(!nodo)
+        return NULL;
+    *lugar = marcar(nodo);
+    uint32_t posicion = 0, bit = 0;
+    if(nodo->mapa){
+        bit = bit_de(buscada->hash, nivel);
+        posicion = posicion_de(nodo, bit);
+    }else{
+        while(!coincide(hash, nodo->hijos[posicion], buscada))
+            posicion++;
+    }
+    hoja_t* hoja = quitar_en(hash, &nodo->hijos[posicion], buscada, nivel + 1);
+    if(!hoja)
+        return NULL;
+    if(!nodo->hijos[posicion]){
+        memmove(nodo->hijos + posicion, nodo->hijos + posicion + 1, (nodo->cantidad - posicion - 1) * sizeof(void*));
+        nodo->cantidad--;
+        nodo->mapa &= ~bit;
+    }
+    if(nodo->cantidad == 1 && !es_nodo(nodo->hijos[0])){
+        *lugar = nodo->hijos[0];
+        free(nodo);
+    }else if(!nodo->cantidad){
+        *lugar = NULL;
+        free(nodo);
+    }
+    return hoja;
+}
+
+//Devuelve la hoja de la clave o NULL si no esta
+static hoja_t* buscar(hash_hamt_t* hash, const buscada_t* buscada){
+    void* actual = hash->raiz;
+    size_t nivel = 0;
+    while(actual && es_nodo(actual)){
+        nodo_t* nodo = nodo_de(actual);
+        if(!nodo->mapa){
+            for(uint32_t i = 0; i < nodo->cantidad; i++)
+                if(coincide(hash, nodo->hijos[i], buscada))
+                    return nodo->hijos[i];
+            return NULL;
+        }
+        uint32_t bit = bit_de(buscada->hash, nivel++);
+        if(!(nodo->mapa & bit))
+            return NULL;
+        actual = nodo->hijos[posicion_de(nodo, bit)];
+    }
+    if(!actual || !coincide(hash, actual, buscada))
+        return NULL;
+    return actual;
+}
+
+hash_hamt_t* hash_hamt_crear(hash_destruir_dato_t destruir_elemento){
+    hash_hamt_t* hash = calloc(1, sizeof(hash_hamt_t));
+    if(!hash)
+        return NULL;
+    hash->destructor = destruir_elemento;
+    hash->nucleos = hash_simd_nucleos();
+    return hash;
+}
+
+hash_hamt_t* hash_hamt_version(hash_hamt_t* hash){
+    if(!hash)
+        return NULL;
+    hash_hamt_t* version = malloc(sizeof(hash_hamt_t));
+    if(!version)
+        return NULL;
+    *version = *hash;
+    if(version->raiz)
+        retener(version->raiz);
+    return version;
+}
+
+int hash_hamt_insertar(hash_hamt_t* hash, const char* clave, void* elemento){
+    if(!hash || !clave)
+        return ERROR;
+    buscada_t buscada = preparar(hash, clave);
+    hoja_t* existente = buscar(hash, &buscada);
+    if(existente && existente->elemento == elemento)
+        return EXITO;
+    hoja_t* hoja = malloc(sizeof(hoja_t));
+    char* copia = malloc(buscada.largo + 1);
+    if(!hoja || !copia){
+        free(hoja);
+        free(copia);
+        return ERROR;
+    }
+    memcpy(copia, clave, buscada.largo + 1);
+    hoja->referencias = 1;
+    hoja->clave = copia;
+    hoja->elemento = elemento;
+    hoja->hash = buscada.hash;
+    hoja->largo = buscada.largo;
+    hoja_t* anterior = NULL;
+    if(insertar_en(hash, &hash->raiz, hoja, 0, &anterior) == ERROR){
+        free(copia);
+        free(hoja);
+        return ERROR;
+    }
+    if(anterior)
+        soltar(hash, anterior);
+    else
+        hash->cantidad++;
+    return EXITO;
+}
+
+int hash_hamt_quitar(hash_hamt_t* hash, const char* clave){
+    if(!hash || !clave)
+        return ERROR;
+    buscada_t buscada = preparar(hash, clave);
+    if(!buscar(hash, &buscada))
+        return ERROR;
+    hoja_t* hoja = quitar_en(hash, &hash->raiz, &buscada, 0);
+    if(!hoja)
+        return ERROR;
+    soltar(hash, hoja);
+    hash->cantidad--;
+    return EXITO;
+}
+
+void* hash_hamt_obtener(hash_hamt_t* hash, const char* clave){
+    if(!hash || !clave)
+        return NULL;
+    buscada_t buscada = preparar(hash, clave);
+    hoja_t* hoja = buscar(hash, &buscada);
+    return hoja ? hoja->elemento : NULL;
+}
+
+bool hash_hamt_contiene(hash_hamt_t* hash, const char* clave){
+    if(!hash || !clave)
+        return false;
+    buscada_t buscada = preparar(hash, clave);
+    return buscar(hash, &buscada) != NULL;
+}
+
+size_t hash_hamt_cantidad(hash_hamt_t* hash){
+    if(!hash)
+        return VACIO;
+    return hash->cantidad;
+}
+
+/*
+ * Invoca a la funcion con cada clave del subarbol mientras devuelva
+ * false, sumando las claves recorridas. Devuelve true si se corto.
+ */
+static bool recorrer(hash_hamt_t* hash, void* hijo, bool (*funcion)(hash_hamt_t* hash, const char* clave, void* aux), void* aux, size_t* cantidad){
+    if(!es_nodo(hijo)){
+        (*cantidad)++;
+        return funcion(hash, ((hoja_t*)hijo)->clave, aux);
+    }
+    nodo_t* nodo = nodo_de(hijo);
+    bool corte = false;
+    for(uint32_t i = 0; i < nodo->cantidad && !corte; i++)
+        corte = recorrer(hash, nodo->hijos[i], funcion, aux, cantidad);
+    return corte;
+}
+
+size_t hash_hamt_con_cada_clave(hash_hamt_t* hash, bool (*funcion)(hash_hamt_t* hash, const char* clave, void* aux), void* aux){
+    if(!hash || !funcion || !hash->raiz)
+        return VACIO;
+    size_t cantidad = 0;
+    recorrer(hash, hash->raiz, funcion, aux, &cantidad);
+    return cantidad;
+}
+
+void hash_hamt_destruir(hash_hamt_t* hash){
+    if(!hash)
+        return;
+    if(hash->raiz)
+        soltar(hash, hash->raiz);
+    free(hash);
+}
@@ -0,0 +1,94 @@
+#ifndef __HASH_HAMT_H__
+#define __HASH_HAMT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Hash persistente sobre un trie de arreglos (HAMT). Cada nivel del
+ * trie consume 5 bits del hash de 64 bits de la clave: un nodo guarda
+ * un mapa de 32 bits con los hijos presentes y solo esos hijos, y la
+ * posicion de un hijo es la cantidad de bits prendidos del mapa antes
+ * del suyo. Buscar recorre a lo sumo 13 niveles (log32 n en promedio) y
+ * el trie nunca se redimensiona: insertar y quitar solo tocan el camino
+ * de la clave, asi que no hay pausas de rehash.
+ *
+ * Los nodos y las hojas cuentan referencias, lo que permite tener
+ * varias versiones del hash que comparten todo lo que no cambio. Una
+ * version se toma en O(1) y despues las dos se modifican por separado:
+ * cada modificacion copia los nodos del camino que comparte con otra
+ * version y modifica en el lugar los que son solo suyos.
+ *
+ * Tiene la misma interfaz que el hash abierto, salvo que no necesita
+ * capacidad inicial.
+ */
+typedef struct hash_hamt hash_hamt_t;
+
+/*
+ * Crea el hash vacio. El destructor se invoca con cada elemento que se
+ * quite o reemplace, cuando ya no lo tiene ninguna version.
+ *
+ * Devuelve el hash creado o NULL en caso de error.
+ */
+hash_hamt_t* hash_hamt_crear(hash_destruir_dato_t destruir_elemento);
+
+/*
+ * Devuelve una version nueva del hash con las mismas claves, que
+ * comparte toda la memoria con el original hasta que alguno de los dos
+ * se modifique, o NULL en caso de error. Cada version se destruye por
+ * separado.
+ *
+ * Las versiones se pueden leer desde varios hilos a la vez, pero las
+ * modificaciones de todas las versiones que comparten memoria tienen
+ * que hacerse desde un mismo hilo.
+ */
+hash_hamt_t* hash_hamt_version(hash_hamt_t* hash);
+
+/*
+ * Inserta el elemento asociado a una copia de la clave. Si la clave ya
+ * existia se reemplaza su elemento.
+ *
+ * Devuelve 0 si pudo guardarlo o -1 si no pudo, en cuyo caso el hash
+ * queda como estaba.
+ */
+int hash_hamt_insertar(hash_hamt_t* hash, const char* clave, void* elemento);
+
+/*
+ * Quita el elemento de la clave e invoca al destructor si ninguna otra
+ * version lo tiene.
+ * Devuelve 0 si pudo quitarlo o -1 si no pudo (o si no estaba).
+ */
+int hash_hamt_quitar(hash_hamt_t* hash, const char* clave);
+
+/*
+ * Devuelve el elemento de la clave o NULL si no esta (o en caso de
+ * error).
+ */
+void* hash_hamt_obtener(hash_hamt_t* hash, const char* clave);
+
+/*
+ * Devuelve true si el hash contiene la clave o false en caso contrario.
+ */
+bool hash_hamt_contiene(hash_hamt_t* hash, const char* clave);
+
+/*
+ * Devuelve la cantidad de elementos del hash o 0 en caso de error.
+ */
+size_t hash_hamt_cantidad(hash_hamt_t* hash);
+
+/*
+ * Recorre las claves del hash invocando a la funcion con cada una, hasta
+ * que devuelva true. No se debe modificar el hash durante el recorrido.
+ *
+ * Devuelve la cantidad de claves recorridas.
+ */
+size_t hash_hamt_con_cada_clave(hash_hamt_t* hash, bool (*funcion)(hash_hamt_t* hash, const char* clave, void* aux), void* aux);
+
+/*
+ * Destruye la version del hash. Los elementos que no tiene ninguna otra
+ * version se destruyen con el destructor.
+ */
+void hash_hamt_destruir(hash_hamt_t* hash);
+
+#endif /* __HASH_HAMT_H__ */
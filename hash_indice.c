@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "lista.h"
+#include "hash.h"
+#include "hash_interno.h"
+#include "indice.h"
+#include "hash_indice.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+
+typedef struct consulta{
+    hash_t* hash;
+    bool (*funcion)(hash_t* hash, const char* clave, void* aux);
+    void* aux;
+}consulta_t;
+
+//Devuelve la clave de una entrada del hash
+static const char* clave_de_entrada(void* dato){
+    return ((ele_t*)dato)->clave;
+}
+
+//Agrega la entrada al indice recibido
+static void agregar_al_indice(void* dato, void* contexto){
+    indice_agregar(contexto, dato);
+}
+
+int hash_activar_indice(hash_t* hash){
+    if(!hash)
+        return ERROR;
+    if(hash->indice)
+        return EXITO;
+    indice_t* indice = indice_crear(clave_de_entrada);
+    if(!indice)
+        return ERROR;
+    for(size_t i = 0; i < hash->capacidad; i++)
+        lista_con_cada_elemento(HASH_BALDE(hash, i)->lista, agregar_al_indice, indice);
+    //Si falto memoria para alguna entrada, el indice quedo incompleto
+    if(indice_cantidad(indice) != hash->cant_elementos){
+        indice_destruir(indice);
+        return ERROR;
+    }
+    hash->indice = indice;
+    return EXITO;
+}
+
+//Invoca a la funcion de la consulta con la clave de la entrada
+static bool visitar(void* dato, void* aux){
+    consulta_t* consulta = aux;
+    return consulta->funcion(consulta->hash, ((ele_t*)dato)->clave, consulta->aux);
+}
+
+size_t hash_con_cada_prefijo(hash_t* hash, const char* prefijo, bool (*funcion)(hash_t* hash, const char* clave, void* aux), void* aux){
+    if(!hash || !hash->indice || !funcion)
+        return VACIO;
+    consulta_t consulta = {hash, funcion, aux};
+    return indice_con_cada_prefijo(hash->indice, prefijo, visitar, &consulta);
+}
+
+size_t hash_con_cada_en_rango(hash_t* hash, const char* desde, const char* hasta, bool (*funcion)(hash_t* hash, const char* clave, void* aux), void* aux){
+    if(!hash || !hash->indice || !funcion)
+        return VACIO;
+    consulta_t consulta = {hash, funcion, aux};
+    return indice_con_cada_en_rango(hash->indice, desde, hasta, visitar, &consulta);
+}
@@ -0,0 +1,42 @@
+#ifndef __HASH_INDICE_H__
+#define __HASH_INDICE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Activa un indice ordenado de las claves del hash, que permite
+ * recorrerlas por prefijo o por rango sin recorrer toda la tabla. El
+ * indice apunta a las mismas entradas de la tabla (no copia las claves)
+ * y se mantiene al insertar y quitar. Con el indice activo, insertar una
+ * clave nueva reserva ademas un nodo del indice.
+ *
+ * No hace nada si el hash ya tenia un indice.
+ *
+ * Devuelve 0 si pudo activarlo o -1 si no pudo.
+ */
+int hash_activar_indice(hash_t* hash);
+
+/*
+ * Recorre en orden (el de strcmp) las claves del hash que empiezan con
+ * el prefijo, invocando a la funcion con cada una hasta que devuelva
+ * true. No se debe modificar el hash durante el recorrido.
+ *
+ * Devuelve la cantidad de claves recorridas, o 0 si el hash no tiene
+ * indice (o en caso de error).
+ */
+size_t hash_con_cada_prefijo(hash_t* hash, const char* prefijo, bool (*funcion)(hash_t* hash, const char* clave, void* aux), void* aux);
+
+/*
+ * Recorre en orden (el de strcmp) las claves del hash mayores o iguales
+ * que desde y menores que hasta, invocando a la funcion con cada una
+ * hasta que devuelva true. Un limite NULL no limita. No se debe
+ * modificar el hash durante el recorrido.
+ *
+ * Devuelve la cantidad de claves recorridas, o 0 si el hash no tiene
+ * indice (o en caso de error).
+ */
+size_t hash_con_cada_en_rango(hash_t* hash, const char* desde, const char* hasta, bool (*funcion)(hash_t* hash, const char* clave, void* aux), void* aux);
+
+#endif /* __HASH_INDICE_H__ */
@@ -0,0 +1,408 @@
+#ifndef __HASH_INTERNO_H__
+#define __HASH_INTERNO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lista.h"
+#include "hash.h"
+#include "filtro.h"
+#include "indice.h"
+#include "rueda_temporizadores.h"
+#include "hash_ttl.h"
+#include "hash_estadisticas.h"
+#include "hash_traza.h"
+#include "hash_pool.h"
+#include "hash_claves.h"
+#include "hash_simd.h"
+#include "hash_snapshot.h"
+#include "reserva.h"
+
+#ifdef HASH_TRAZAS_USDT
+#include <sys/sdt.h>
+#endif
+
+/*
+ * Estructuras internas del hash abierto. Solo deben incluirlas los
+ * modulos de la biblioteca que necesitan recorrer la tabla sin pasar
+ * por la interfaz publica.
+ */
+
+/*
+ * De donde viene la clave de una entrada, para saber como liberarla.
+ * Las claves de un hash con pool son siempre del pool.
+ */
+typedef enum origen_clave{
+    CLAVE_COPIADA,
+    CLAVE_PROPIA,
+    CLAVE_PRESTADA
+}origen_clave_t;
+
+/*
+ * Entrada de la tabla. Guarda el hash y el largo de la clave para no
+ * recalcularlos al rehashear y para descartar sin comparar bytes las
+ * claves distintas de la buscada. Si la clave tiene varios valores,
+ * elemento apunta al bloque valores_t que los guarda.
+ */
+typedef struct elemento{
+    char* clave;
+    void* elemento;
+    temporizador_t* temporizador;
+    size_t hash;
+    size_t largo;
+    origen_clave_t origen;
+    bool multiple;
+    bool clave_compartida;
+    bool elemento_compartido;
+}ele_t;
+
+/*
+ * Valores de una clave con varios valores, contiguos y en el orden en
+ * que se agregaron. El bloque crece duplicando su capacidad.
+ */
+typedef struct valores{
+    size_t cantidad;
+    size_t capacidad;
+    void* elementos[];
+}valores_t;
+
+typedef struct vector{
+    lista_t* lista;
+}vector_t;
+
+#define BALDES_POR_PAGINA 512
+
+/*
+ * Bloque de memoria con las paginas que se crearon juntas, una detras
+ * de otra. Se libera cuando se libera la ultima de sus paginas.
+ */
+typedef struct bloque{
+    size_t paginas;
+}bloque_t;
+
+/*
+ * Pagina de baldes de la tabla. Los snapshots comparten las paginas con
+ * el hash contando referencias; una pagina con mas de una referencia no
+ * se modifica, y antes de escribir en ella el hash la copia (junto con
+ * sus listas y entradas). Las copias no tienen bloque.
+ */
+typedef struct pagina{
+    size_t referencias;
+    size_t cantidad;
+    bloque_t* bloque;
+    vector_t baldes[];
+}pagina_t;
+
+/*
+ * Valor que una entrada compartida con un snapshot dejo de usar. Se
+ * libera cuando ya no queda ningun snapshot tomado antes de la
+ * generacion en la que se descarto.
+ */
+typedef struct diferido{
+    uint64_t generacion;
+    ele_t entrada;
+}diferido_t;
+
+/*
+ * Log de escritura anticipada del hash, definido en hash_wal.c.
+ */
+typedef struct hash_wal hash_wal_t;
+
+#define HASH_PAGINAS(capacidad) (((capacidad) + BALDES_POR_PAGINA - 1) / BALDES_POR_PAGINA)
+#define PAGINA_BALDE(paginas, pos) (&(paginas)[(pos) / BALDES_POR_PAGINA]->baldes[(pos) % BALDES_POR_PAGINA])
+#define HASH_BALDE(hash, pos) PAGINA_BALDE((hash)->paginas, pos)
+#define HASH_BYTES_PAGINAS(capacidad) (HASH_PAGINAS(capacidad) * (sizeof(pagina_t*) + sizeof(pagina_t)) + (capacidad) * sizeof(vector_t))
+
+struct hash{
+    pagina_t** paginas;
+    reserva_t reserva;
+    hash_destruir_dato_t destructor;
+    hash_destruir_clave_t destructor_clave;
+    size_t capacidad;
+    size_t cant_elementos;
+    size_t pos_habilitadas;
+    filtro_t* filtro;
+    size_t bits_filtro;
+    rueda_t* rueda;
+    hash_reloj_t reloj;
+    size_t rehashes;
+    uint64_t tiempo_rehash_ns;
+    hash_contadores_t contadores;
+    hash_trazador_t trazador;
+    void* aux_trazador;
+    hash_pool_t* pool;
+    const hash_nucleos_t* nucleos;
+    size_t multiples;
+    indice_t* indice;
+    hash_snapshot_t* snapshots;
+    uint64_t generacion;
+    diferido_t* diferidos;
+    size_t cant_diferidos;
+    size_t cap_diferidos;
+    hash_wal_t* wal;
+    size_t recorridos;
+    size_t extra_entrada;
+};
+
+/*
+ * Espacio de extra_entrada bytes que se reserva a continuacion de cada
+ * entrada, para que un modulo construido sobre el hash guarde ahi sus
+ * datos sin otra reserva por clave. Se fija con el hash vacio, y un
+ * hash con espacio extra no toma snapshots porque las copias de las
+ * entradas no lo llevan.
+ */
+#define HASH_EXTRA(entrada) ((void*)((entrada) + 1))
+
+/*
+ * Cuenta una operacion en los contadores del hash, solo si se compila
+ * con -DHASH_CONTADORES.
+ */
+#ifdef HASH_CONTADORES
+#define HASH_CONTAR(hash, contador) ((hash)->contadores.contador++)
+#else
+#define HASH_CONTAR(hash, contador) ((void)0)
+#endif
+
+/*
+ * Emite un evento de traza (HASH_TRAZA_<evento>), solo si se compila
+ * con -DHASH_TRAZAS.
+ */
+#ifdef HASH_TRAZAS_USDT
+#define HASH_SONDA(evento, hash, clave, dato) DTRACE_PROBE3(tda_hash, evento, hash, clave, dato)
+#else
+#define HASH_SONDA(evento, hash, clave, dato) ((void)0)
+#endif
+
+#ifdef HASH_TRAZAS
+#define HASH_TRAZAR(hash, evento, clave, dato) do{ \
+        HASH_SONDA(evento, hash, clave, dato); \
+        if((hash)->trazador) \
+            (hash)->trazador((hash), HASH_TRAZA_##evento, (clave), (size_t)(dato), (hash)->aux_trazador); \
+    }while(0)
+#else
+#define HASH_TRAZAR(hash, evento, clave, dato) ((void)0)
+#endif
+
+/*
+ * Funcion de hash del hash abierto. Se expone para las herramientas que
+ * analizan su calidad.
+ */
+size_t hasheador(const char* clave);
+
+/*
+ * Devuelve la capacidad a la que crece el hash al rehashear desde la
+ * capacidad dada.
+ */
+size_t proximo_primo(size_t capacidad);
+
+/*
+ * Crea las paginas de baldes vacios para la capacidad dada, en un solo
+ * bloque reservado segun las opciones de reserva.
+ * Devuelve las paginas o NULL en caso de error.
+ */
+pagina_t** hash_crear_paginas(const reserva_t* reserva, size_t capacidad);
+
+/*
+ * Libera una pagina sin liberar sus listas.
+ */
+void hash_liberar_pagina(pagina_t* pagina);
+
+/*
+ * Libera las paginas de la capacidad dada y sus listas, sin liberar las
+ * entradas que contienen.
+ */
+void hash_liberar_paginas(pagina_t** paginas, size_t capacidad);
+
+/*
+ * Mueve todas las entradas a paginas nuevas de la capacidad dada,
+ * creando listas nuevas solo para los baldes ocupados. Las entradas y
+ * sus claves no cambian de lugar. Si no puede, el hash queda intacto.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo.
+ */
+int hash_redimensionar(hash_t* hash, size_t capacidad);
+
+/*
+ * Inserta el elemento con la clave segun su origen: la copia, se queda
+ * con ella o la toma prestada. Si la clave es propia y el hash no la
+ * guarda (porque ya existia o porque la interna en su pool), la libera
+ * con el destructor de claves.
+ *
+ * Si entrada no es NULL deja en ella la entrada de la clave, nueva o
+ * reemplazada, para no tener que volver a buscarla.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso la clave sigue
+ * siendo de quien llama.
+ */
+int hash_insertar_entrada(hash_t* hash, char* clave, void* elemento, origen_clave_t origen, ele_t** entrada);
+
+/*
+ * Busca la entrada de la clave en el hash. La entrada (y su clave)
+ * sigue siendo la misma mientras la clave este en el hash, aunque la
+ * tabla se rehashee.
+ *
+ * Devuelve la entrada o NULL si la clave no esta.
+ */
+ele_t* hash_buscar_entrada(hash_t* hash, const char* clave);
+
+/*
+ * Busca en el hash la entrada con la misma clave que una entrada de
+ * otro hash, sin volver a calcular su hash ni su largo.
+ *
+ * Devuelve la entrada o NULL si la clave no esta.
+ */
+ele_t* hash_buscar_igual(hash_t* hash, const ele_t* entrada);
+
+/*
+ * Igual que hash_buscar_igual, pero no quita del hash las claves
+ * vencidas: las toma como ausentes y las deja para otra busqueda.
+ */
+ele_t* hash_buscar_igual_vigente(hash_t* hash, const ele_t* entrada);
+
+/*
+ * Saca del hash la entrada que esta en la posicion dada de la lista del
+ * balde, sin liberarla, y descarta su vencimiento si tenia. El elemento
+ * y la clave siguen en la entrada.
+ *
+ * Devuelve la entrada o NULL si no habia una en esa posicion.
+ */
+ele_t* hash_desenganchar_entrada(hash_t* hash, size_t balde, size_t posicion);
+
+/*
+ * Guarda en el hash una entrada ya armada, sin copiar su clave ni
+ * rehashear. La clave no debe estar en el hash.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso la entrada sigue
+ * siendo de quien llama.
+ */
+int hash_enganchar_entrada(hash_t* hash, ele_t* entrada);
+
+/*
+ * Libera el elemento de la entrada, o todos sus valores si tiene
+ * varios, con el destructor del hash.
+ */
+void hash_liberar_dato(hash_t* hash, ele_t* entrada);
+
+/*
+ * Libera el elemento de la entrada antes de reemplazarlo, salvo que un
+ * snapshot lo siga usando, en cuyo caso queda diferido.
+ */
+void hash_soltar_dato(hash_t* hash, ele_t* entrada);
+
+/*
+ * Libera la clave de la entrada segun su origen, o la suelta si es del
+ * pool del hash.
+ */
+void hash_liberar_clave(hash_t* hash, ele_t* entrada);
+
+/*
+ * Libera una entrada que ya no esta en el hash: su clave segun su
+ * origen, su elemento, su temporizador y la entrada misma. La clave y
+ * el elemento que comparte con un snapshot quedan diferidos.
+ */
+void hash_liberar_entrada(hash_t* hash, ele_t* entrada);
+
+/*
+ * Vuelve a crear el filtro del hash dimensionado para su capacidad
+ * actual y le agrega todas las claves. Si no puede, conserva el filtro
+ * anterior, que sigue siendo correcto.
+ *
+ * Devuelve 0 si pudo reconstruirlo o -1 si no pudo.
+ */
+int hash_filtro_reconstruir(hash_t* hash);
+
+/*
+ * Devuelve true si la entrada tiene vencimiento y ya vencio.
+ */
+bool hash_ttl_vencida(hash_t* hash, ele_t* entrada);
+
+/*
+ * Quita el vencimiento de la entrada, si tenia, y libera su
+ * temporizador.
+ */
+void hash_ttl_descartar(hash_t* hash, ele_t* entrada);
+
+/*
+ * Crea la rueda de temporizadores del hash si todavia no tiene.
+ * Devuelve 0 si el hash tiene rueda o -1 si no pudo crearla.
+ */
+int hash_ttl_preparar(hash_t* hash);
+
+/*
+ * Pasa el vencimiento de una entrada del origen (si tenia) a una entrada
+ * del destino, que no debe tener vencimiento. El destino tiene que
+ * tener rueda y los dos hashes el mismo reloj.
+ */
+void hash_ttl_transferir(hash_t* origen, ele_t* entrada, hash_t* destino, ele_t* nueva);
+
+/*
+ * Invoca al destructor con cada valor de una entrada con varios valores,
+ * salvo con el valor conservado (NULL si no se conserva ninguno), y
+ * libera su bloque. La entrada queda sin elemento y deja de ser
+ * multiple.
+ */
+void hash_multi_liberar(hash_t* hash, ele_t* entrada, void* conservado);
+
+/*
+ * Deja la pagina del balde lista para modificarla: si la comparte con
+ * un snapshot la copia, y reserva lugar para diferir lo que se descarte.
+ * Hay que llamarla antes de tomar punteros a las entradas del balde que
+ * se van a modificar o quitar.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso el hash queda como
+ * estaba.
+ */
+int hash_preparar_balde(hash_t* hash, size_t pos);
+
+/*
+ * Copia todas las paginas que el hash comparte con snapshots.
+ * Devuelve 0 si pudo o -1 si no pudo.
+ */
+int hash_separar(hash_t* hash);
+
+/*
+ * Si algun snapshot puede seguir usando la clave (con_clave) o el
+ * elemento de la entrada, los anota para liberarlos cuando ya no haga
+ * falta y deja marcados como compartidos los que anoto; los que no hace
+ * falta diferir quedan desmarcados. Necesita el lugar reservado por
+ * hash_preparar_balde.
+ */
+void hash_diferir(hash_t* hash, ele_t* entrada, bool con_clave);
+
+/*
+ * Libera los snapshots ya soltados y lo que ya no usa ningun snapshot.
+ * Devuelve true si queda algun snapshot vivo.
+ */
+bool hash_con_snapshots(hash_t* hash);
+
+/*
+ * Libera todos los snapshots del hash y todo lo diferido.
+ */
+void hash_snapshots_destruir(hash_t* hash);
+
+/*
+ * Agregan al log del hash el registro de la operacion que se esta por
+ * aplicar. Solo se invocan si el hash tiene log.
+ * Devuelven 0 si pudieron o -1 si no pudieron (o si hay otro registro
+ * sin terminar), y entonces la operacion no se tiene que aplicar.
+ */
+int hash_wal_anotar_insercion(hash_t* hash, const char* clave, void* elemento);
+int hash_wal_anotar_quitado(hash_t* hash, const char* clave);
+
+/*
+ * Cierra el registro anotado: si la operacion se aplico cuenta para el
+ * grupo y, si no, se descarta.
+ */
+void hash_wal_terminar(hash_t* hash, bool aplicada);
+
+/*
+ * Sincroniza lo pendiente y cierra el log del hash, si tiene.
+ */
+void hash_wal_cerrar(hash_t* hash);
+
+/*
+ * Devuelve el tiempo del reloj monotono del sistema en nanosegundos.
+ */
+uint64_t hash_reloj_ns(void);
+
+#endif /* __HASH_INTERNO_H__ */
@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "lista.h"
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_memoria.h"
+
+#define ERROR -1
+#define EXITO 0
+#define CAPACIDAD_MIN 3
+#define MAX_CARGA 75
+#define MAX_DIVISOR_EVITADO 7
+
+typedef struct conteo{
+    hash_memoria_t* memoria;
+    bool con_pool;
+}conteo_t;
+
+//Suma los bytes de la clave y de los valores del elemento a la memoria
+static void sumar_entrada(void* dato, void* contexto){
+    ele_t* entrada = dato;
+    conteo_t* conteo = contexto;
+    if(!conteo->con_pool)
+        conteo->memoria->claves += entrada->largo + 1;
+    if(entrada->multiple)
+        conteo->memoria->valores += sizeof(valores_t) + ((valores_t*)entrada->elemento)->capacidad * sizeof(void*);
+}
+
+int hash_memoria(hash_t* hash, hash_memoria_t* memoria){
+    if(!hash || !memoria)
+        return ERROR;
+    memset(memoria, 0, sizeof(hash_memoria_t));
+    memoria->vector = HASH_BYTES_PAGINAS(hash->capacidad);
+    memoria->entradas = hash->cant_elementos * (sizeof(ele_t) + hash->extra_entrada);
+    memoria->indice = indice_bytes(hash->indice);
+    conteo_t conteo = {memoria, hash->pool != NULL};
+    for(size_t i = 0; i < hash->capacidad; i++){
+        lista_t* lista = HASH_BALDE(hash, i)->lista;
+        if(!lista)
+            continue;
+        memoria->listas += lista_tamanio_estructura();
+        memoria->nodos += lista_tamanio_nodos(lista);
+        lista_con_cada_elemento(lista, sumar_entrada, &conteo);
+    }
+    memoria->total = memoria->vector + memoria->listas + memoria->nodos + memoria->entradas + memoria->claves + memoria->valores + memoria->indice;
+    return EXITO;
+}
+
+/*
+ * Devuelve la menor capacidad con la que la cantidad de elementos queda
+ * por debajo de la carga maxima, evitando divisores chicos como lo hace
+ * el rehash.
+ */
+static size_t capacidad_justa(size_t cantidad){
+    size_t capacidad = (cantidad * 100) / MAX_CARGA + 1;
+    if(capacidad <= CAPACIDAD_MIN)
+        return CAPACIDAD_MIN;
+    while(capacidad % 2 == 0 || capacidad % 3 == 0 || capacidad % 5 == 0 || capacidad % MAX_DIVISOR_EVITADO == 0)
+        capacidad++;
+    return capacidad;
+}
+
+int hash_compactar(hash_t* hash){
+    if(!hash)
+        return ERROR;
+    size_t capacidad = capacidad_justa(hash->cant_elementos);
+    if(capacidad > hash->capacidad)
+        capacidad = hash->capacidad;
+    return hash_redimensionar(hash, capacidad);
+}
+
+int hash_reservar(hash_t* hash, size_t cantidad){
+    if(!hash)
+        return ERROR;
+    size_t capacidad = capacidad_justa(cantidad);
+    if(capacidad <= hash->capacidad)
+        return EXITO;
+    return hash_redimensionar(hash, capacidad);
+}
@@ -0,0 +1,57 @@
+#ifndef __HASH_MEMORIA_H__
+#define __HASH_MEMORIA_H__
+
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Bytes usados por el hash, separados por categoria. No incluyen el
+ * desperdicio propio de malloc ni los elementos guardados.
+ */
+typedef struct hash_memoria{
+    size_t vector;
+    size_t listas;
+    size_t nodos;
+    size_t entradas;
+    size_t claves;
+    size_t valores;
+    size_t indice;
+    size_t total;
+}hash_memoria_t;
+
+/*
+ * Completa los bytes que usa el hash en las paginas de baldes, en las
+ * estructuras de las listas, en los nodos de las listas, en las
+ * entradas de la tabla, en las claves, en los bloques de las claves
+ * con varios valores y en el indice ordenado, junto con el total. Las
+ * claves de un hash creado con un pool son del pool y no se cuentan
+ * aca.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo.
+ */
+int hash_memoria(hash_t* hash, hash_memoria_t* memoria);
+
+/*
+ * Achica la capacidad del hash a la minima que necesita para la
+ * cantidad de elementos que tiene y vuelve a crear sus listas, de forma
+ * que se devuelve la memoria de los baldes que quedo reservada despues
+ * de quitar muchos elementos. Cada nodo de las listas se sigue
+ * reservando por separado, asi que no quedan juntos en memoria; las
+ * entradas y sus claves no cambian de lugar.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso el hash queda como
+ * estaba.
+ */
+int hash_compactar(hash_t* hash);
+
+/*
+ * Agranda el hash, con un unico rehash, para que entre la cantidad de
+ * elementos dada sin volver a rehashear. No hace nada si ya tiene
+ * lugar.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso el hash queda como
+ * estaba.
+ */
+int hash_reservar(hash_t* hash, size_t cantidad);
+
+#endif /* __HASH_MEMORIA_H__ */
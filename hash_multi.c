@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_multi.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+#define VALORES_INICIALES 4
+
+/*
+ * Crea un bloque de valores con lugar para capacidad valores.
+ * Devuelve el bloque o NULL en caso de error.
+ */
+static valores_t* crear_valores(size_t capacidad){
+    valores_t* valores = malloc(sizeof(valores_t) + capacidad * sizeof(void*));
+    if(!valores)
+        return NULL;
+    valores->cantidad = VACIO;
+    valores->capacidad = capacidad;
+    return valores;
+}
+
+/*
+ * Convierte la entrada de un unico valor en una entrada con varios,
+ * cuyo primer valor es el que tenia.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso la entrada queda
+ * intacta.
+ */
+static int volver_multiple(hash_t* hash, ele_t* entrada){
+    valores_t* valores = crear_valores(VALORES_INICIALES);
+    if(!valores)
+        return ERROR;
+    valores->elementos[valores->cantidad++] = entrada->elemento;
+    entrada->elemento = valores;
+    entrada->multiple = true;
+    hash->multiples++;
+    return EXITO;
+}
+
+void hash_multi_liberar(hash_t* hash, ele_t* entrada, void* conservado){
+    valores_t* valores = entrada->elemento;
+    for(size_t i = 0; i < valores->cantidad && hash->destructor; i++){
+        if(!conservado || valores->elementos[i] != conservado)
+            hash->destructor(valores->elementos[i]);
+    }
+    free(valores);
+    entrada->elemento = NULL;
+    entrada->multiple = false;
+    hash->multiples--;
+}
+
+int hash_agregar(hash_t* hash, const char* clave, void* elemento){
+    if(!hash || !clave || hash->wal || hash_con_snapshots(hash))
+        return ERROR;
+    ele_t* entrada = hash_buscar_entrada(hash, clave);
+    if(!entrada)
+        return hash_insertar(hash, clave, elemento);
+    if(!entrada->multiple && volver_multiple(hash, entrada) == ERROR)
+        return ERROR;
+    valores_t* valores = entrada->elemento;
+    if(valores->cantidad == valores->capacidad){
+        valores_t* nuevos = realloc(valores, sizeof(valores_t) + 2 * valores->capacidad * sizeof(void*));
+        if(!nuevos)
+            return ERROR;
+        nuevos->capacidad *= 2;
+        entrada->elemento = valores = nuevos;
+    }
+    valores->elementos[valores->cantidad++] = elemento;
+    return EXITO;
+}
+
+void** hash_obtener_todos(hash_t* hash, const char* clave, size_t* cantidad){
+    if(cantidad)
+        *cantidad = VACIO;
+    if(!hash || !clave || !cantidad)
+        return NULL;
+    ele_t* entrada = hash_buscar_entrada(hash, clave);
+    if(!entrada)
+        return NULL;
+    if(!entrada->multiple){
+        *cantidad = 1;
+        return &entrada->elemento;
+    }
+    valores_t* valores = entrada->elemento;
+    *cantidad = valores->cantidad;
+    return valores->elementos;
+}
+
+int hash_quitar_valor(hash_t* hash, const char* clave, void* elemento){
+    if(!hash || !clave)
+        return ERROR;
+    ele_t* entrada = hash_buscar_entrada(hash, clave);
+    if(!entrada)
+        return ERROR;
+    if(!entrada->multiple)
+        return entrada->elemento == elemento ? hash_quitar(hash, clave) : ERROR;
+    valores_t* valores = entrada->elemento;
+    size_t i = 0;
+    while(i < valores->cantidad && valores->elementos[i] != elemento)
+        i++;
+    if(i == valores->cantidad)
+        return ERROR;
+    if(valores->cantidad == 1)
+        return hash_quitar(hash, clave);
+    valores->cantidad--;
+    memmove(&valores->elementos[i], &valores->elementos[i + 1], (valores->cantidad - i) * sizeof(void*));
+    if(hash->destructor)
+        hash->destructor(elemento);
+    return EXITO;
+}
@@ -0,0 +1,47 @@
+#ifndef __HASH_MULTI_H__
+#define __HASH_MULTI_H__
+
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Claves con varios valores. Los valores de cada clave se guardan
+ * contiguos en un unico bloque junto a su entrada, en el orden en que se
+ * agregaron, asi que recorrerlos no reserva memoria ni salta de nodo en
+ * nodo.
+ *
+ * hash_obtener devuelve el primer valor de la clave; hash_insertar la
+ * deja con un unico valor y hash_quitar la quita con todos sus valores.
+ * En todos los casos se invoca al destructor con cada valor descartado.
+ */
+
+/*
+ * Agrega el elemento a los valores de la clave, creandola si no estaba.
+ * Si la clave tenia un unico valor, ese valor pasa a ser el primero.
+ * No se puede mientras el hash tenga snapshots sin soltar o el log
+ * activo (hash_wal.h).
+ *
+ * Devuelve 0 si pudo agregarlo o -1 si no pudo.
+ */
+int hash_agregar(hash_t* hash, const char* clave, void* elemento);
+
+/*
+ * Devuelve los valores de la clave, contiguos y en el orden en que se
+ * agregaron, y guarda su cantidad en cantidad. El vector es del hash y
+ * deja de ser valido al modificar la clave o el hash.
+ *
+ * Devuelve NULL (y cantidad 0) si la clave no esta o en caso de error.
+ */
+void** hash_obtener_todos(hash_t* hash, const char* clave, size_t* cantidad);
+
+/*
+ * Quita de los valores de la clave el primero que sea igual a elemento
+ * (comparando punteros) e invoca al destructor con el. Los demas valores
+ * conservan su orden. Si era el ultimo valor, quita la clave.
+ *
+ * Devuelve 0 si pudo quitarlo o -1 si la clave no esta o no tiene ese
+ * valor.
+ */
+int hash_quitar_valor(hash_t* hash, const char* clave, void* elemento);
+
+#endif /* __HASH_MULTI_H__ */
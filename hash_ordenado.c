@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "hash.h"
+#include "hash_simd.h"
+#include "hash_ordenado.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+#define CAPACIDAD_MIN 8
+#define LIBRE UINT32_MAX
+#define BORRADO (UINT32_MAX - 1)
+
+/*
+ * Entrada del vector denso. La clave es NULL si la entrada se quito; el
+ * lugar se recupera al reorganizar la tabla.
+ */
+typedef struct entrada{
+    char* clave;
+    void* elemento;
+    uint64_t hash;
+    size_t largo;
+}entrada_t;
+
+/*
+ * Cada casillero de la tabla es LIBRE, BORRADO o la posicion de una
+ * entrada. El vector denso tiene lugar para dos tercios de los
+ * casilleros, asi que la tabla nunca pasa esa carga contando las marcas
+ * de borrado.
+ */
+struct hash_ordenado{
+    uint32_t* casilleros;
+    size_t capacidad;
+    entrada_t* entradas;
+    size_t usadas;
+    size_t reservadas;
+    size_t cantidad;
+    hash_destruir_dato_t destructor;
+    const hash_nucleos_t* nucleos;
+    reserva_t reserva;
+};
+
+//Devuelve la cantidad de entradas que entran en una tabla de la capacidad dada
+static size_t entradas_para(size_t capacidad){
+    return capacidad * 2 / 3;
+}
+
+//Devuelve la menor potencia de 2 cuya tabla tiene lugar para la cantidad de entradas
+static size_t capacidad_para(size_t cantidad){
+    size_t capacidad = CAPACIDAD_MIN;
+    while(entradas_para(capacidad) < cantidad)
+        capacidad *= 2;
+    return capacidad;
+}
+
+//Devuelve una tabla de la capacidad dada con todos sus casilleros libres
+static uint32_t* crear_casilleros(hash_ordenado_t* hash, size_t capacidad){
+    uint32_t* casilleros = reserva_obtener(&hash->reserva, capacidad * sizeof(uint32_t));
+    if(casilleros)
+        memset(casilleros, 0xff, capacidad * sizeof(uint32_t));
+    return casilleros;
+}
+
+hash_ordenado_t* hash_ordenado_crear(hash_destruir_dato_t destruir_elemento, size_t capacidad){
+    return hash_ordenado_crear_con_reserva(destruir_elemento, capacidad, NULL);
+}
+
+hash_ordenado_t* hash_ordenado_crear_con_reserva(hash_destruir_dato_t destruir_elemento, size_t capacidad, const reserva_t* reserva){
+    if(!capacidad || capacidad >= BORRADO)
+        return NULL;
+    hash_ordenado_t* hash = calloc(1, sizeof(hash_ordenado_t));
+    if(!hash)
+        return NULL;
+    if(reserva)
+        hash->reserva = *reserva;
+    hash->capacidad = capacidad_para(capacidad);
+    hash->reservadas = entradas_para(hash->capacidad);
+    hash->casilleros = crear_casilleros(hash, hash->capacidad);
+    hash->entradas = reserva_obtener(&hash->reserva, hash->reservadas * sizeof(entrada_t));
+    if(!hash->casilleros || !hash->entradas){
+        reserva_liberar(hash->casilleros);
+        reserva_liberar(hash->entradas);
+        free(hash);
+        return NULL;
+    }
+    hash->destructor = destruir_elemento;
+    hash->nucleos = hash_simd_nucleos();
+    return hash;
+}
+
+/*
+ * Devuelve la posicion en el vector denso de la clave o ERROR si no
+ * esta. Si recibe un puntero a casillero le asigna el casillero de la
+ * tabla que apunta a la entrada.
+ */
+static long buscar(hash_ordenado_t* hash, const char* clave, size_t largo, uint64_t valor, size_t* casillero){
+    size_t mascara = hash->capacidad - 1;
+    size_t i = (size_t)valor & mascara;
+    while(hash->casilleros[i] != LIBRE){
+        uint32_t posicion = hash->casilleros[i];
+        if(posicion != BORRADO){
+            entrada_t* entrada = &hash->entradas[posicion];
+            if(entrada->hash == valor && entrada->largo == largo && hash->nucleos->iguales(entrada->clave, clave, largo)){
+                if(casillero)
+                    *casillero = i;
+                return (long)posicion;
+            }
+        }
+        i = (i + 1) & mascara;
+    }
+    return ERROR;
+}
+
+//Busca la clave calculando su largo y su hash
+static long buscar_clave(hash_ordenado_t* hash, const char* clave, size_t* casillero){
+    size_t largo = strlen(clave);
+    return buscar(hash, clave, largo, hash->nucleos->hashear(clave, largo), casillero);
+}
+
+//Anota en el primer casillero libre de la tabla la posicion de la entrada
+static void ubicar(uint32_t* casilleros, size_t capacidad, uint64_t valor, size_t posicion){
+    size_t mascara = capacidad - 1;
+    size_t i = (size_t)valor & mascara;
+    while(casilleros[i] != LIBRE)
+        i = (i + 1) & mascara;
+    casilleros[i] = (uint32_t)posicion;
+}
+
+/*
+ * Rearma la tabla para la cantidad de entradas mas una, corriendo las
+ * entradas hacia el principio del vector denso para cerrar los huecos
+ * de las quitadas sin cambiar su orden. Puede agrandar o achicar la
+ * tabla.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso el hash queda como
+ * estaba.
+ */
+static int reorganizar(hash_ordenado_t* hash){
+    size_t capacidad = capacidad_para((hash->cantidad + 1) * 2);
+    size_t reservadas = entradas_para(capacidad);
+    if(reservadas >= BORRADO)
+        return ERROR;
+    uint32_t* casilleros = crear_casilleros(hash, capacidad);
+    if(!casilleros)
+        return ERROR;
+    if(reservadas > hash->reservadas){
+        entrada_t* entradas = reserva_redimensionar(&hash->reserva, hash->entradas, reservadas * sizeof(entrada_t));
+        if(!entradas){
+            reserva_liberar(casilleros);
+            return ERROR;
+        }
+        hash->entradas = entradas;
+    }
+    size_t destino = 0;
+    for(size_t i = 0; i < hash->usadas; i++){
+        if(!hash->entradas[i].clave)
+            continue;
+        hash->entradas[destino] = hash->entradas[i];
+        ubicar(casilleros, capacidad, hash->entradas[destino].hash, destino);
+        destino++;
+    }
+    if(reservadas < hash->reservadas){
+        entrada_t* entradas = reserva_redimensionar(&hash->reserva, hash->entradas, reservadas * sizeof(entrada_t));
+        if(entradas)
+            hash->entradas = entradas;
+    }
+    reserva_liberar(hash->casilleros);
+    hash->casilleros = casilleros;
+    hash->capacidad = capacidad;
+    hash->reservadas = reservadas;
+    hash->usadas = destino;
+    return EXITO;
+}
+
+int hash_ordenado_insertar(hash_ordenado_t* hash, const char* clave, void* elemento){
+    if(!hash || !clave)
+        return ERROR;
+    size_t largo = strlen(clave);
+    uint64_t valor = hash->nucleos->hashear(clave, largo);
+    long posicion = buscar(hash, clave, largo, valor, NULL);
+    if(posicion != ERROR){
+        void* anterior = hash->entradas[posicion].elemento;
+        hash->entradas[posicion].elemento = elemento;
+        if(hash->destructor && anterior != elemento)
+            hash->destructor(anterior);
+        return EXITO;
+    }
+    if(hash->usadas == hash->reservadas && reorganizar(hash) == ERROR)
+        return ERROR;
+    entrada_t* entrada = &hash->entradas[hash->usadas];
+    entrada->clave = malloc(largo + 1);
+    if(!entrada->clave)
+        return ERROR;
+    memcpy(entrada->clave, clave, largo + 1);
+    entrada->elemento = elemento;
+    entrada->hash = valor;
+    entrada->largo = largo;
+    ubicar(hash->casilleros, hash->capacidad, valor, hash->usadas);
+    hash->usadas++;
+    hash->cantidad++;
+    return EXITO;
+}
+
+int hash_ordenado_quitar(hash_ordenado_t* hash, const char* clave){
+    if(!hash || !clave)
+        return ERROR;
+    size_t casillero = 0;
+    long posicion = buscar_clave(hash, clave, &casillero);
+    if(posicion == ERROR)
+        return ERROR;
+    entrada_t* entrada = &hash->entradas[posicion];
+    hash->casilleros[casillero] = BORRADO;
+    free(entrada->clave);
+    if(hash->destructor)
+        hash->destructor(entrada->elemento);
+    entrada->clave = NULL;
+    hash->cantidad--;
+    return EXITO;
+}
+
+void* hash_ordenado_obtener(hash_ordenado_t* hash, const char* clave){
+    if(!hash || !clave)
+        return NULL;
+    long posicion = buscar_clave(hash, clave, NULL);
+    if(posicion == ERROR)
+        return NULL;
+    return hash->entradas[posicion].elemento;
+}
+
+bool hash_ordenado_contiene(hash_ordenado_t* hash, const char* clave){
+    if(!hash || !clave)
+        return false;
+    return buscar_clave(hash, clave, NULL) != ERROR;
+}
+
+size_t hash_ordenado_cantidad(hash_ordenado_t* hash){
+    if(!hash)
+        return VACIO;
+    return hash->cantidad;
+}
+
+size_t hash_ordenado_bytes(hash_ordenado_t* hash){
+    if(!hash)
+        return VACIO;
+    return sizeof(hash_ordenado_t) + hash->capacidad * sizeof(uint32_t) + hash->reservadas * sizeof(entrada_t);
+}
+
+size_t hash_ordenado_con_cada_clave(hash_ordenado_t* hash, bool (*funcion)(hash_ordenado_t* hash, const char* clave, void* elemento, void* aux), void* aux){
+    if(!hash || !funcion)
+        return VACIO;
+    size_t cantidad = 0;
+    bool corte = false;
+    for(size_t i = 0; i < hash->usadas && !corte; i++){
+        if(!hash->entradas[i].clave)
+            continue;
+        corte = funcion(hash, hash->entradas[i].clave, hash->entradas[i].elemento, aux);
+        cantidad++;
+    }
+    return cantidad;
+}
+
+void hash_ordenado_destruir(hash_ordenado_t* hash){
+    if(!hash)
+        return;
+    for(size_t i = 0; i < hash->usadas; i++){
+        if(!hash->entradas[i].clave)
+            continue;
+        free(hash->entradas[i].clave);
+        if(hash->destructor)
+            hash->destructor(hash->entradas[i].elemento);
+    }
+    reserva_liberar(hash->casilleros);
+    reserva_liberar(hash->entradas);
+    free(hash);
+}
@@ -0,0 +1,95 @@
+#ifndef __HASH_ORDENADO_H__
+#define __HASH_ORDENADO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hash.h"
+#include "reserva.h"
+
+/*
+ * Hash compacto que recuerda el orden de insercion. Las entradas se
+ * guardan contiguas en un vector denso, en el orden en que se
+ * insertaron, y la tabla de direccionamiento abierto solo guarda la
+ * posicion de cada entrada en ese vector (4 bytes por casillero).
+ *
+ * Recorrerlo es leer el vector denso de punta a punta, y el orden no
+ * cambia al agrandar o achicar la tabla. Reemplazar el elemento de una
+ * clave conserva su lugar; quitarla y volver a insertarla la manda al
+ * final.
+ *
+ * Tiene la misma interfaz que el hash abierto, salvo que el recorrido
+ * recibe tambien el elemento de cada clave.
+ */
+typedef struct hash_ordenado hash_ordenado_t;
+
+/*
+ * Crea el hash reservando lugar para la capacidad dada de elementos
+ * (minimo 3). El destructor se invoca con cada elemento que se quite o
+ * reemplace.
+ *
+ * Devuelve el hash creado o NULL en caso de error.
+ */
+hash_ordenado_t* hash_ordenado_crear(hash_destruir_dato_t destruir_elemento, size_t capacidad);
+
+/*
+ * Igual que hash_ordenado_crear, pero la tabla y el vector de entradas
+ * se reservan al crearlos y al reorganizarlos segun las opciones de
+ * reserva (paginas grandes y ubicacion NUMA). Si reserva es NULL usa
+ * malloc.
+ *
+ * Devuelve el hash creado o NULL en caso de error.
+ */
+hash_ordenado_t* hash_ordenado_crear_con_reserva(hash_destruir_dato_t destruir_elemento, size_t capacidad, const reserva_t* reserva);
+
+/*
+ * Inserta el elemento asociado a una copia de la clave al final del
+ * orden. Si la clave ya existia se reemplaza su elemento sin cambiarla
+ * de lugar.
+ *
+ * Devuelve 0 si pudo guardarlo o -1 si no pudo.
+ */
+int hash_ordenado_insertar(hash_ordenado_t* hash, const char* clave, void* elemento);
+
+/*
+ * Quita el elemento de la clave e invoca al destructor.
+ * Devuelve 0 si pudo quitarlo o -1 si no pudo (o si no estaba).
+ */
+int hash_ordenado_quitar(hash_ordenado_t* hash, const char* clave);
+
+/*
+ * Devuelve el elemento de la clave o NULL si no esta (o en caso de
+ * error).
+ */
+void* hash_ordenado_obtener(hash_ordenado_t* hash, const char* clave);
+
+/*
+ * Devuelve true si el hash contiene la clave o false en caso contrario.
+ */
+bool hash_ordenado_contiene(hash_ordenado_t* hash, const char* clave);
+
+/*
+ * Devuelve la cantidad de elementos del hash o 0 en caso de error.
+ */
+size_t hash_ordenado_cantidad(hash_ordenado_t* hash);
+
+/*
+ * Devuelve los bytes que ocupan la tabla y el vector de entradas, sin
+ * contar las claves ni los elementos, o 0 en caso de error.
+ */
+size_t hash_ordenado_bytes(hash_ordenado_t* hash);
+
+/*
+ * Recorre las claves del hash en el orden en que se insertaron,
+ * invocando a la funcion con cada una y su elemento hasta que devuelva
+ * true. No se debe modificar el hash durante el recorrido.
+ *
+ * Devuelve la cantidad de claves recorridas.
+ */
+size_t hash_ordenado_con_cada_clave(hash_ordenado_t* hash, bool (*funcion)(hash_ordenado_t* hash, const char* clave, void* elemento, void* aux), void* aux);
+
+/*
+ * Destruye el hash invocando al destructor con cada elemento.
+ */
+void hash_ordenado_destruir(hash_ordenado_t* hash);
+
+#endif /* __HASH_ORDENADO_H__ */
@@ -0,0 +1,387 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_funciones.h"
+#include "hash_persistencia.h"
+
+#define ERROR -1
+#define EXITO 0
+#define IGUAL 0
+#define VACIO 0
+#define MAGIA "TDAHASH1"
+#define LARGO_MAGIA 8
+#define VERSION 1
+#define MARCA_ORDEN 0x01020304U
+#define CAPACIDAD_MIN 8
+#define MAX_CARGA 75
+#define ALINEACION 8
+#define POSICION_VACIA UINT64_MAX
+#define SEMILLA 0
+
+/*
+ * Cabecera de la imagen. Todos los desplazamientos son relativos al
+ * inicio de la imagen. La marca de orden permite rechazar imagenes
+ * escritas en una maquina con otro orden de bytes.
+ */
+typedef struct cabecera{
+    char magia[LARGO_MAGIA];
+    uint32_t version;
+    uint32_t marca_orden;
+    uint64_t cantidad;
+    uint64_t capacidad;
+    uint64_t inicio_posiciones;
+    uint64_t inicio_claves;
+    uint64_t inicio_valores;
+    uint64_t tamanio;
+}cabecera_t;
+
+/*
+ * Posicion del vector de la imagen. Se resuelven las colisiones con
+ * sondeo lineal; una posicion libre tiene la clave en POSICION_VACIA.
+ * Las claves se guardan terminadas en '\0' y los valores precedidos
+ * por su tamaño en 64 bits.
+ */
+typedef struct posicion{
+    uint64_t hash;
+    uint64_t clave;
+    uint64_t valor;
+}posicion_t;
+
+struct hash_mapeado{
+    const char* base;
+    size_t tamanio;
+    const cabecera_t* cabecera;
+    const posicion_t* posiciones;
+};
+
+typedef struct entrada{
+    const char* clave;
+    void* elemento;
+    size_t posicion;
+}entrada_t;
+
+typedef struct recoleccion{
+    hash_t* hash;
+    entrada_t* entradas;
+    size_t cantidad;
+}recoleccion_t;
+
+/*
+ * Escribe todos los bytes pedidos en el descriptor, reintentando las
+ * escrituras parciales. Devuelve 0 si pudo o -1 si no pudo.
+ */
+static int escribir_todo(int fd, const void* datos, size_t tamanio){
+    const char* actual = datos;
+    while(tamanio > 0){
+        ssize_t escritos = write(fd, actual, tamanio);
+        if(escritos <= 0)
+            return ERROR;
+        actual += escritos;
+        tamanio -= (size_t)escritos;
+    }
+    return EXITO;
+}
+
+/*
+ * Escribe los bytes de relleno necesarios para que el desplazamiento
+ * quede alineado a 8 bytes.
+ */
+static int alinear(int fd, uint64_t* desplazamiento){
+    static const char relleno[ALINEACION] = {0};
+    size_t faltante = (size_t)((ALINEACION - (*desplazamiento % ALINEACION)) % ALINEACION);
+    if(escribir_todo(fd, relleno, faltante) == ERROR)
+        return ERROR;
+    *desplazamiento += faltante;
+    return EXITO;
+}
+
+//Guarda cada clave vigente del hash junto con su elemento
+static bool recolectar(hash_t* hash, const char* clave, void* aux){
+    recoleccion_t* recoleccion = aux;
+    ele_t* encontrada = hash_buscar_entrada(hash, clave);
+    if(!encontrada)
+        return false;
+    entrada_t* entrada = &recoleccion->entradas[recoleccion->cantidad++];
+    entrada->clave = clave;
+    entrada->elemento = encontrada->elemento;
+    return false;
+}
+
+/*
+ * Devuelve la menor potencia de 2 que permite guardar la cantidad de
+ * claves dada sin superar el factor de carga maximo.
+ */
+static size_t calcular_capacidad(size_t cantidad){
+    size_t capacidad = CAPACIDAD_MIN;
+    while(capacidad * MAX_CARGA / 100 <= cantidad)
+        capacidad *= 2;
+    return capacidad;
+}
+
+/*
+ * Busca una posicion libre para la clave en el vector en construccion
+ * y la ocupa con el hash y el desplazamiento de la clave.
+ */
+static size_t ubicar(posicion_t* posiciones, size_t capacidad, const char* clave, uint64_t desplazamiento){
+    uint64_t numero = hash_fnv1a(clave, strlen(clave), SEMILLA);
+    size_t mascara = capacidad - 1;
+    size_t i = (size_t)numero & mascara;
+    while(posiciones[i].clave != POSICION_VACIA)
+        i = (i + 1) & mascara;
+    posiciones[i].hash = numero;
+    posiciones[i].clave = desplazamiento;
+    return i;
+}
+
+/*
+ * Escribe las claves de las entradas a partir del desplazamiento dado,
+ * ubicando cada una en el vector de posiciones.
+ */
+static int escribir_claves(int fd, recoleccion_t* recoleccion, posicion_t* posiciones, size_t capacidad, uint64_t* desplazamiento){
+    for(size_t i = 0; i < recoleccion->cantidad; i++){
+        entrada_t* entrada = &recoleccion->entradas[i];
+        size_t largo = strlen(entrada->clave) + 1;
+        if(escribir_todo(fd, entrada->clave, largo) == ERROR)
+            return ERROR;
+        entrada->posicion = ubicar(posiciones, capacidad, entrada->clave, *desplazamiento);
+        *desplazamiento += largo;
+    }
+    return alinear(fd, desplazamiento);
+}
+
+/*
+ * Escribe los valores serializados de las entradas. El primer registro
+ * es un valor vacio que comparten todas las entradas sin valor.
+ */
+static int escribir_valores(int fd, recoleccion_t* recoleccion, posicion_t* posiciones, hash_serializador_t serializador, uint64_t* desplazamiento){
+    uint64_t vacio = *desplazamiento;
+    uint64_t largo = VACIO;
+    if(escribir_todo(fd, &largo, sizeof(largo)) == ERROR)
+        return ERROR;
+    *desplazamiento += sizeof(largo);
+    for(size_t i = 0; i < recoleccion->cantidad; i++){
+        entrada_t* entrada = &recoleccion->entradas[i];
+        size_t tamanio = VACIO;
+        const void* datos = serializador ? serializador(entrada->elemento, &tamanio) : NULL;
+        if(!datos || !tamanio){
+            posiciones[entrada->posicion].valor = vacio;
+            continue;
+        }
+        largo = tamanio;
+        posiciones[entrada->posicion].valor = *desplazamiento;
+        if(escribir_todo(fd, &largo, sizeof(largo)) == ERROR || escribir_todo(fd, datos, tamanio) == ERROR)
+            return ERROR;
+        *desplazamiento += sizeof(largo) + tamanio;
+        if(alinear(fd, desplazamiento) == ERROR)
+            return ERROR;
+    }
+    return EXITO;
+}
+
+/*
+ * Escribe toda la imagen salvo la cabecera, que se completa en la
+ * cabecera recibida para escribirla al final.
+ */
+static int escribir_imagen(int fd, recoleccion_t* recoleccion, hash_serializador_t serializador, cabecera_t* cabecera){
+    size_t capacidad = calcular_capacidad(recoleccion->cantidad);
+    posicion_t* posiciones = malloc(capacidad * sizeof(posicion_t));
+    if(!posiciones)
+        return ERROR;
+    memset(posiciones, 0xff, capacidad * sizeof(posicion_t));
+
+    uint64_t desplazamiento = sizeof(cabecera_t);
+    cabecera->inicio_claves = desplazamiento;
+    int retorno = escribir_claves(fd, recoleccion, posiciones, capacidad, &desplazamiento);
+    cabecera->inicio_valores = desplazamiento;
+    if(retorno == EXITO)
+        retorno = escribir_valores(fd, recoleccion, posiciones, serializador, &desplazamiento);
+    cabecera->inicio_posiciones = desplazamiento;
+    if(retorno == EXITO)
+        retorno = escribir_todo(fd, posiciones, capacidad * sizeof(posicion_t));
+    free(posiciones);
+
+    cabecera->cantidad = recoleccion->cantidad;
+    cabecera->capacidad = capacidad;
+    cabecera->tamanio = desplazamiento + capacidad * sizeof(posicion_t);
+    return retorno;
+}
+
+int hash_guardar(hash_t* hash, int fd, hash_serializador_t serializador){
+    if(!hash || fd < 0 || hash->multiples)
+        return ERROR;
+    off_t inicio = lseek(fd, 0, SEEK_CUR);
+    if(inicio < 0)
+        return ERROR;
+
+    recoleccion_t recoleccion = {hash, NULL, VACIO};
+    size_t cantidad = hash_cantidad(hash);
+    recoleccion.entradas = malloc((cantidad ? cantidad : 1) * sizeof(entrada_t));
+    if(!recoleccion.entradas)
+        return ERROR;
+    hash_con_cada_clave(hash, recolectar, &recoleccion);
+
+    cabecera_t cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    int retorno = escribir_todo(fd, &cabecera, sizeof(cabecera));
+    if(retorno == EXITO)
+        retorno = escribir_imagen(fd, &recoleccion, serializador, &cabecera);
+    free(recoleccion.entradas);
+    if(retorno == ERROR)
+        return ERROR;
+
+    memcpy(cabecera.magia, MAGIA, LARGO_MAGIA);
+    cabecera.version = VERSION;
+    cabecera.marca_orden = MARCA_ORDEN;
+    if(pwrite(fd, &cabecera, sizeof(cabecera), inicio) != (ssize_t)sizeof(cabecera))
+        return ERROR;
+    return EXITO;
+}
+
+/*
+ * Devuelve true si la cabecera describe una imagen completa que entra
+ * en el tamaño mapeado.
+ */
+static bool cabecera_valida(const cabecera_t* cabecera, size_t tamanio){
+    if(memcmp(cabecera->magia, MAGIA, LARGO_MAGIA) != IGUAL)
+        return false;
+    if(cabecera->version != VERSION || cabecera->marca_orden != MARCA_ORDEN)
+        return false;
+    if(cabecera->tamanio != tamanio || !cabecera->capacidad)
+        return false;
+    if(cabecera->capacidad & (cabecera->capacidad - 1) || cabecera->cantidad > cabecera->capacidad)
+        return false;
+    if(cabecera->inicio_posiciones % ALINEACION != 0 || cabecera->inicio_posiciones > tamanio)
+        return false;
+    return (tamanio - cabecera->inicio_posiciones) / sizeof(posicion_t) >= cabecera->capacidad;
+}
+
+hash_mapeado_t* hash_cargar_mmap(const char* ruta){
+    if(!ruta)
+        return NULL;
+    int fd = open(ruta, O_RDONLY);
+    if(fd < 0)
+        return NULL;
+    struct stat estado;
+    if(fstat(fd, &estado) == ERROR || (size_t)estado.st_size < sizeof(cabecera_t)){
+        close(fd);
+        return NULL;
+    }
+    size_t tamanio = (size_t)estado.st_size;
+    void* base = mmap(NULL, tamanio, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(base == MAP_FAILED)
+        return NULL;
+    if(!cabecera_valida(base, tamanio)){
+        munmap(base, tamanio);
+        return NULL;
+    }
+    hash_mapeado_t* mapa = calloc(1, sizeof(hash_mapeado_t));
+    if(!mapa){
+        munmap(base, tamanio);
+        return NULL;
+    }
+    mapa->base = base;
+    mapa->tamanio = tamanio;
+    mapa->cabecera = base;
+    mapa->posiciones = (const posicion_t*)(mapa->base + mapa->cabecera->inicio_posiciones);
+    return mapa;
+}
+
+/*
+ * Devuelve true si la clave y el valor de la posicion estan completos
+ * dentro de la imagen: la clave termina en '\0' antes del final y el
+ * valor entra con su tamaño. Una imagen truncada o corrupta puede tener
+ * desplazamientos que apuntan afuera.
+ */
+static bool posicion_valida(hash_mapeado_t* mapa, const posicion_t* posicion){
+    if(posicion->clave >= mapa->tamanio || !memchr(mapa->base + posicion->clave, '\0', mapa->tamanio - (size_t)posicion->clave))
+        return false;
+    if(posicion->valor > mapa->tamanio || mapa->tamanio - posicion->valor < sizeof(uint64_t))
+        return false;
+    uint64_t largo;
+    memcpy(&largo, mapa->base + posicion->valor, sizeof(largo));
+    return largo <= mapa->tamanio - posicion->valor - sizeof(uint64_t);
+}
+
+/*
+ * Busca la posicion de la clave en la imagen. Devuelve NULL si la
+ * clave no esta. Las posiciones invalidas se ignoran.
+ */
+static const posicion_t* buscar_posicion(hash_mapeado_t* mapa, const char* clave){
+    uint64_t numero = hash_fnv1a(clave, strlen(clave), SEMILLA);
+    size_t mascara = (size_t)mapa->cabecera->capacidad - 1;
+    size_t i = (size_t)numero & mascara;
+    for(size_t vistas = 0; vistas < mapa->cabecera->capacidad && mapa->posiciones[i].clave != POSICION_VACIA; vistas++){
+        const posicion_t* posicion = &mapa->posiciones[i];
+        if(posicion->hash == numero && posicion_valida(mapa, posicion) && strcmp(mapa->base + posicion->clave, clave) == IGUAL)
+            return posicion;
+        i = (i + 1) & mascara;
+    }
+    return NULL;
+}
+
+/*
+ * Devuelve los bytes del valor de la posicion y guarda su tamaño.
+ */
+static const void* leer_valor(hash_mapeado_t* mapa, const posicion_t* posicion, size_t* tamanio){
+    uint64_t largo;
+    memcpy(&largo, mapa->base + posicion->valor, sizeof(largo));
+    if(tamanio)
+        *tamanio = (size_t)largo;
+    return mapa->base + posicion->valor + sizeof(largo);
+}
+
+const void* hash_mapeado_obtener(hash_mapeado_t* mapa, const char* clave, size_t* tamanio){
+    if(!mapa || !clave)
+        return NULL;
+    const posicion_t* posicion = buscar_posicion(mapa, clave);
+    if(!posicion)
+        return NULL;
+    return leer_valor(mapa, posicion, tamanio);
+}
+
+bool hash_mapeado_contiene(hash_mapeado_t* mapa, const char* clave){
+    if(!mapa || !clave)
+        return false;
+    return buscar_posicion(mapa, clave) != NULL;
+}
+
+size_t hash_mapeado_cantidad(hash_mapeado_t* mapa){
+    if(!mapa)
+        return VACIO;
+    return (size_t)mapa->cabecera->cantidad;
+}
+
+size_t hash_mapeado_con_cada_clave(hash_mapeado_t* mapa, bool (*funcion)(const char* clave, const void* valor, size_t tamanio, void* aux), void* aux){
+    if(!mapa || !funcion)
+        return VACIO;
+    size_t cant = 0;
+    bool corte = false;
+    for(size_t i = 0; i < mapa->cabecera->capacidad && !corte; i++){
+        const posicion_t* posicion = &mapa->posiciones[i];
+        if(posicion->clave == POSICION_VACIA || !posicion_valida(mapa, posicion))
+            continue;
+        size_t tamanio = VACIO;
+        const void* valor = leer_valor(mapa, posicion, &tamanio);
+        corte = funcion(mapa->base + posicion->clave, valor, tamanio, aux);
+        cant++;
+    }
+    return cant;
+}
+
+void hash_mapeado_cerrar(hash_mapeado_t* mapa){
+    if(!mapa)
+        return;
+    munmap((void*)mapa->base, mapa->tamanio);
+    free(mapa);
+}
@@ -0,0 +1,90 @@
+#ifndef __HASH_PERSISTENCIA_H__
+#define __HASH_PERSISTENCIA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Imagen de un hash guardada en disco y abierta en memoria mediante
+ * mmap en modo de solo lectura. Las consultas se resuelven directamente
+ * sobre el archivo mapeado, sin reconstruir la tabla: el sistema
+ * operativo trae a memoria solo las paginas que se van tocando.
+ */
+typedef struct hash_mapeado hash_mapeado_t;
+
+/*
+ * Serializador de los datos almacenados en el hash. Recibe un elemento
+ * y devuelve un puntero a los bytes que lo representan, guardando en
+ * tamanio la cantidad de bytes. El puntero devuelto solo necesita ser
+ * valido hasta la proxima invocacion del serializador.
+ *
+ * Si devuelve NULL el elemento se guarda como un valor vacio.
+ */
+typedef const void* (*hash_serializador_t)(void* elemento, size_t* tamanio);
+
+/*
+ * Escribe en el descriptor fd, a partir de su posicion actual, una
+ * imagen compacta del hash: una cabecera, las claves, los valores
+ * serializados y el vector de posiciones. La imagen no contiene punteros,
+ * solo desplazamientos, por lo que puede mapearse en cualquier
+ * direccion. Si el serializador es NULL se guardan solo las claves.
+ *
+ * Para poder abrirla con hash_cargar_mmap, la imagen tiene que ocupar
+ * el archivo completo (fd debe estar al inicio de un archivo vacio).
+ * La imagen guarda un valor por clave, asi que no se pueden guardar
+ * hashes con claves de varios valores.
+ *
+ * Devuelve 0 si pudo guardarlo o -1 si no pudo.
+ */
+int hash_guardar(hash_t* hash, int fd, hash_serializador_t serializador);
+
+/*
+ * Abre la imagen guardada en la ruta dada y la mapea en memoria en
+ * modo de solo lectura. No se lee ni se procesa el contenido del
+ * archivo mas alla de validar la cabecera; las posiciones cuya clave o
+ * valor no entran en el archivo se ignoran al consultarlo.
+ *
+ * Devuelve la imagen abierta o NULL en caso de error o si el archivo
+ * no contiene una imagen valida.
+ */
+hash_mapeado_t* hash_cargar_mmap(const char* ruta);
+
+/*
+ * Devuelve los bytes del valor asociado a la clave dada y guarda su
+ * tamaño en tamanio (si no es NULL). Los bytes pertenecen a la imagen
+ * y son validos hasta que se cierre.
+ *
+ * Devuelve NULL si la clave no existe (o en caso de error). Un valor
+ * vacio se devuelve como un puntero valido de tamaño 0.
+ */
+const void* hash_mapeado_obtener(hash_mapeado_t* mapa, const char* clave, size_t* tamanio);
+
+/*
+ * Devuelve true si la imagen contiene la clave dada o false en caso
+ * contrario (o en caso de error).
+ */
+bool hash_mapeado_contiene(hash_mapeado_t* mapa, const char* clave);
+
+/*
+ * Devuelve la cantidad de claves guardadas en la imagen o 0 en caso de
+ * error.
+ */
+size_t hash_mapeado_cantidad(hash_mapeado_t* mapa);
+
+/*
+ * Recorre las claves de la imagen e invoca a la funcion con la clave,
+ * los bytes de su valor, su tamaño y el puntero auxiliar. La iteracion
+ * se corta cuando la funcion devuelve true.
+ *
+ * Devuelve la cantidad de veces que fue invocada la funcion o 0 en
+ * caso de error.
+ */
+size_t hash_mapeado_con_cada_clave(hash_mapeado_t* mapa, bool (*funcion)(const char* clave, const void* valor, size_t tamanio, void* aux), void* aux);
+
+/*
+ * Desmapea la imagen y libera la memoria reservada para manejarla.
+ */
+void hash_mapeado_cerrar(hash_mapeado_t* mapa);
+
+#endif /* __HASH_PERSISTENCIA_H__ */
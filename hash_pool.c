@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_funciones.h"
+#include "hash_pool.h"
+
+#define ERROR -1
+#define EXITO 0
+#define IGUAL 0
+#define VACIO 0
+#define CAPACIDAD_INICIAL 64
+#define SEMILLA_POOL 0x5bd1e9955bd1e995ULL
+
+/*
+ * Clave internada. La clave devuelta a los usuarios apunta al texto,
+ * del que se recupera el registro restando su desplazamiento.
+ */
+typedef struct cadena{
+    size_t referencias;
+    uint64_t hash;
+    size_t largo;
+    char texto[];
+}cadena_t;
+
+/*
+ * Tabla con direccionamiento abierto y sondeo lineal; la capacidad es
+ * siempre una potencia de 2 y se mantiene a lo sumo a la mitad de carga.
+ */
+struct hash_pool{
+    cadena_t** casilleros;
+    size_t capacidad;
+    size_t cantidad;
+    size_t bytes;
+};
+
+static cadena_t* cadena_de(const char* internada){
+    return (cadena_t*)(void*)(internada - offsetof(cadena_t, texto));
+}
+
+static uint64_t hash_de(const char* clave, size_t largo){
+    return hash_mezclar(hash_fnv1a(clave, largo, SEMILLA_POOL));
+}
+
+hash_pool_t* hash_pool_crear(){
+    hash_pool_t* pool = calloc(1, sizeof(hash_pool_t));
+    if(!pool)
+        return NULL;
+    pool->casilleros = calloc(CAPACIDAD_INICIAL, sizeof(cadena_t*));
+    if(!pool->casilleros){
+        free(pool);
+        return NULL;
+    }
+    pool->capacidad = CAPACIDAD_INICIAL;
+    return pool;
+}
+
+/*
+ * Devuelve el casillero donde esta la clave o, si no esta, el primer
+ * casillero vacio donde iria.
+ */
+static size_t buscar_casillero(hash_pool_t* pool, const char* clave, size_t largo, uint64_t hash){
+    size_t mascara = pool->capacidad - 1;
+    size_t i = (size_t)hash & mascara;
+    while(pool->casilleros[i]){
+        cadena_t* cadena = pool->casilleros[i];
+        if(cadena->hash == hash && cadena->largo == largo && memcmp(cadena->texto, clave, largo) == IGUAL)
+            return i;
+        i = (i + 1) & mascara;
+    }
+    return i;
+}
+
+//Duplica la capacidad del pool reubicando las claves
+static int agrandar(hash_pool_t* pool){
+    size_t capacidad = pool->capacidad * 2;
+    cadena_t** casilleros = calloc(capacidad, sizeof(cadena_t*));
+    if(!casilleros)
+        return ERROR;
+    for(size_t i = 0; i < pool->capacidad; i++){
+        cadena_t* cadena = pool->casilleros[i];
+        if(!cadena)
+            continue;
+        size_t j = (size_t)cadena->hash & (capacidad - 1);
+        while(casilleros[j])
+            j = (j + 1) & (capacidad - 1);
+        casilleros[j] = cadena;
+    }
+    free(pool->casilleros);
+    pool->casilleros = casilleros;
+    pool->capacidad = capacidad;
+    return EXITO;
+}
+
+const char* hash_pool_internar(hash_pool_t* pool, const char* clave){
+    if(!pool || !clave)
+        return NULL;
+    size_t largo = strlen(clave);
+    uint64_t hash = hash_de(clave, largo);
+    size_t i = buscar_casillero(pool, clave, largo, hash);
+    if(pool->casilleros[i]){
+        pool->casilleros[i]->referencias++;
+        return pool->casilleros[i]->texto;
+    }
+    if(2 * (pool->cantidad + 1) > pool->capacidad){
+        if(agrandar(pool) == ERROR)
+            return NULL;
+        i = buscar_casillero(pool, clave, largo, hash);
+    }
+    cadena_t* cadena = malloc(sizeof(cadena_t) + largo + 1);
+    if(!cadena)
+        return NULL;
+    cadena->referencias = 1;
+    cadena->hash = hash;
+    cadena->largo = largo;
+    memcpy(cadena->texto, clave, largo + 1);
+    pool->casilleros[i] = cadena;
+    pool->cantidad++;
+    pool->bytes += sizeof(cadena_t) + largo + 1;
+    return cadena->texto;
+}
+
+const char* hash_pool_buscar(hash_pool_t* pool, const char* clave){
+    if(!pool || !clave)
+        return NULL;
+    size_t largo = strlen(clave);
+    cadena_t* cadena = pool->casilleros[buscar_casillero(pool, clave, largo, hash_de(clave, largo))];
+    return cadena ? cadena->texto : NULL;
+}
+
+/*
+ * Vacia el casillero y corre hacia atras las claves que le siguen en la
+ * misma corrida, para que ninguna quede separada de su posicion ideal
+ * por un casillero vacio.
+ */
+static void vaciar_casillero(hash_pool_t* pool, size_t vacio){
+    size_t mascara = pool->capacidad - 1;
+    size_t i = (vacio + 1) & mascara;
+    while(pool->casilleros[i]){
+        size_t ideal = (size_t)pool->casilleros[i]->hash & mascara;
+        if(((i - ideal) & mascara) >= ((i - vacio) & mascara)){
+            pool->casilleros[vacio] = pool->casilleros[i];
+            vacio = i;
+        }
+        i = (i + 1) & mascara;
+    }
+    pool->casilleros[vacio] = NULL;
+}
+
+void hash_pool_soltar(hash_pool_t* pool, const char* internada){
+    if(!pool || !internada)
+        return;
+    cadena_t* cadena = cadena_de(internada);
+    if(--cadena->referencias > 0)
+        return;
+    size_t mascara = pool->capacidad - 1;
+    size_t i = (size_t)cadena->hash & mascara;
+    while(pool->casilleros[i] != cadena)
+        i = (i + 1) & mascara;
+    vaciar_casillero(pool, i);
+    pool->cantidad--;
+    pool->bytes -= sizeof(cadena_t) + cadena->largo + 1;
+    free(cadena);
+}
+
+size_t hash_pool_cantidad(hash_pool_t* pool){
+    if(!pool)
+        return VACIO;
+    return pool->cantidad;
+}
+
+size_t hash_pool_bytes(hash_pool_t* pool){
+    if(!pool)
+        return VACIO;
+    return pool->bytes;
+}
+
+hash_t* hash_crear_con_pool(hash_destruir_dato_t destruir_elemento, size_t capacidad, hash_pool_t* pool){
+    if(!pool)
+        return NULL;
+    hash_t* hash = hash_crear(destruir_elemento, capacidad);
+    if(!hash)
+        return NULL;
+    hash->pool = pool;
+    return hash;
+}
+
+void hash_pool_destruir(hash_pool_t* pool){
+    if(!pool)
+        return;
+    for(size_t i = 0; i < pool->capacidad; i++)
+        free(pool->casilleros[i]);
+    free(pool->casilleros);
+    free(pool);
+}
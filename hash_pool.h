@@ -0,0 +1,70 @@
+#ifndef __HASH_POOL_H__
+#define __HASH_POOL_H__
+
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Pool de claves internadas. Cada clave distinta se guarda una sola
+ * vez, con un contador de referencias, y todos los hash creados con el
+ * mismo pool la comparten. Dos claves internadas en el mismo pool son
+ * iguales si y solo si son el mismo puntero.
+ */
+typedef struct hash_pool hash_pool_t;
+
+/*
+ * Crea un pool vacio.
+ * Devuelve el pool creado o NULL en caso de error.
+ */
+hash_pool_t* hash_pool_crear();
+
+/*
+ * Devuelve la copia internada de la clave, guardandola si no estaba, y
+ * suma una referencia a ella. Cada llamada exitosa debe corresponderse
+ * con un hash_pool_soltar.
+ *
+ * Devuelve NULL en caso de error.
+ */
+const char* hash_pool_internar(hash_pool_t* pool, const char* clave);
+
+/*
+ * Devuelve la copia internada de la clave, sin sumarle referencias, o
+ * NULL si la clave no esta en el pool.
+ */
+const char* hash_pool_buscar(hash_pool_t* pool, const char* clave);
+
+/*
+ * Resta una referencia a una clave devuelta por hash_pool_internar. Al
+ * quedar sin referencias la clave se libera.
+ */
+void hash_pool_soltar(hash_pool_t* pool, const char* internada);
+
+/*
+ * Devuelve la cantidad de claves distintas en el pool o 0 en caso de
+ * error.
+ */
+size_t hash_pool_cantidad(hash_pool_t* pool);
+
+/*
+ * Devuelve los bytes que ocupan las claves del pool o 0 en caso de
+ * error.
+ */
+size_t hash_pool_bytes(hash_pool_t* pool);
+
+/*
+ * Crea un hash como hash_crear, pero cuyas claves se internan en el
+ * pool en lugar de copiarse. Las busquedas en ese hash buscan primero
+ * la clave en el pool y despues comparan solo punteros.
+ *
+ * El pool debe destruirse despues de todos los hash que lo usan.
+ *
+ * Devuelve el hash creado o NULL en caso de error.
+ */
+hash_t* hash_crear_con_pool(hash_destruir_dato_t destruir_elemento, size_t capacidad, hash_pool_t* pool);
+
+/*
+ * Libera el pool y todas las claves que contenga.
+ */
+void hash_pool_destruir(hash_pool_t* pool);
+
+#endif /* __HASH_POOL_H__ */
@@ -0,0 +1,22 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "lista.h"
+#include "hash.h"
+#include "hash_interno.h"
+#include "reserva.h"
+#include "hash_reserva.h"
+
+hash_t* hash_crear_con_reserva(hash_destruir_dato_t destruir_elemento, size_t capacidad, const reserva_t* reserva){
+    hash_t* hash = hash_crear(destruir_elemento, capacidad);
+    if(!hash || !reserva)
+        return hash;
+    pagina_t** paginas = hash_crear_paginas(reserva, hash->capacidad);
+    if(!paginas){
+        hash_destruir(hash);
+        return NULL;
+    }
+    hash_liberar_paginas(hash->paginas, hash->capacidad);
+    hash->paginas = paginas;
+    hash->reserva = *reserva;
+    return hash;
+}
@@ -0,0 +1,20 @@
+#ifndef __HASH_RESERVA_H__
+#define __HASH_RESERVA_H__
+
+#include <stddef.h>
+#include "hash.h"
+#include "reserva.h"
+
+/*
+ * Crea un hash como hash_crear, pero reserva las paginas de baldes
+ * segun las opciones de reserva (paginas grandes y ubicacion NUMA), al
+ * crearlo y en cada rehash. Las paginas que se crean juntas se reservan
+ * en un solo bloque, asi que las paginas grandes cubren toda la tabla.
+ * Las entradas y los nodos de las listas se siguen reservando con
+ * malloc. Si reserva es NULL es igual a hash_crear.
+ *
+ * Devuelve el hash creado o NULL en caso de error.
+ */
+hash_t* hash_crear_con_reserva(hash_destruir_dato_t destruir_elemento, size_t capacidad, const reserva_t* reserva);
+
+#endif /* __HASH_RESERVA_H__ */
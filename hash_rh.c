@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "hash.h"
+#include "hash_simd.h"
+#include "hash_rh.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+#define CAPACIDAD_MIN 4
+#define MAX_CARGA 90
+
+/*
+ * Casillero de la tabla. La distancia es 0 si el casillero esta vacio y
+ * si no es uno mas que la distancia de la clave a su posicion ideal. El
+ * largo de la clave permite compararla con los nucleos elegidos sin
+ * recorrerla buscando el final.
+ */
+typedef struct casillero{
+    char* clave;
+    void* elemento;
+    uint32_t hash;
+    uint32_t distancia;
+    size_t largo;
+}casillero_t;
+
+struct hash_rh{
+    casillero_t* casilleros;
+    size_t capacidad;
+    size_t cantidad;
+    hash_destruir_dato_t destructor;
+    const hash_nucleos_t* nucleos;
+    reserva_t reserva;
+};
+
+typedef struct buscada{
+    const char* clave;
+    size_t largo;
+    uint32_t hash;
+}buscada_t;
+
+static buscada_t preparar(hash_rh_t* hash, const char* clave){
+    buscada_t buscada;
+    buscada.clave = clave;
+    buscada.largo = strlen(clave);
+    buscada.hash = (uint32_t)hash->nucleos->hashear(clave, buscada.largo);
+    return buscada;
+}
+
+//Devuelve la menor potencia de 2 con lugar para la cantidad sin pasar la carga maxima
+static size_t capacidad_para(size_t cantidad){
+    size_t capacidad = CAPACIDAD_MIN;
+    while(capacidad * MAX_CARGA / 100 < cantidad)
+        capacidad *= 2;
+    return capacidad;
+}
+
+hash_rh_t* hash_rh_crear(hash_destruir_dato_t destruir_elemento, size_t capacidad){
+    return hash_rh_crear_con_reserva(destruir_elemento, capacidad, NULL);
+}
+
+hash_rh_t* hash_rh_crear_con_reserva(hash_destruir_dato_t destruir_elemento, size_t capacidad, const reserva_t* reserva){
+    if(!capacidad)
+        return NULL;
+    hash_rh_t* hash = calloc(1, sizeof(hash_rh_t));
+    if(!hash)
+        return NULL;
+    if(reserva)
+        hash->reserva = *reserva;
+    hash->capacidad = capacidad_para(capacidad);
+    hash->casilleros = reserva_obtener(&hash->reserva, hash->capacidad * sizeof(casillero_t));
+    if(!hash->casilleros){
+        free(hash);
+        return NULL;
+    }
+    hash->destructor = destruir_elemento;
+    hash->nucleos = hash_simd_nucleos();
+    return hash;
+}
+
+/*
+ * Ubica el casillero en la tabla con desplazamiento Robin Hood. La
+ * clave no debe estar en la tabla y tiene que haber lugar.
+ */
+static void ubicar(casillero_t* casilleros, size_t capacidad, casillero_t nuevo){
+    size_t mascara = capacidad - 1;
+    size_t i = nuevo.hash & mascara;
+    nuevo.distancia = 1;
+    while(casilleros[i].distancia){
+        if(casilleros[i].distancia < nuevo.distancia){
+            casillero_t desplazado = casilleros[i];
+            casilleros[i] = nuevo;
+            nuevo = desplazado;
+        }
+        nuevo.distancia++;
+        i = (i + 1) & mascara;
+    }
+    casilleros[i] = nuevo;
+}
+
+//Duplica la capacidad de la tabla reubicando las claves
+static int agrandar(hash_rh_t* hash){
+    size_t capacidad = hash->capacidad * 2;
+    casillero_t* casilleros = reserva_obtener(&hash->reserva, capacidad * sizeof(casillero_t));
+    if(!casilleros)
+        return ERROR;
+    for(size_t i = 0; i < hash->capacidad; i++)
+        if(hash->casilleros[i].distancia)
+            ubicar(casilleros, capacidad, hash->casilleros[i]);
+    reserva_liberar(hash->casilleros);
+    hash->casilleros = casilleros;
+    hash->capacidad = capacidad;
+    return EXITO;
+}
+
+/*
+ * Devuelve la posicion de la clave en la tabla o ERROR si no esta. La
+ * busqueda termina en cuanto la distancia recorrida supera la de la
+ * clave del casillero, porque si la clave buscada estuviera mas
+ * adelante la habria desplazado.
+ */
+static long buscar(hash_rh_t* hash, const buscada_t* buscada){
+    size_t mascara = hash->capacidad - 1;
+    size_t i = buscada->hash & mascara;
+    for(uint32_t distancia = 1; distancia <= hash->casilleros[i].distancia; distancia++){
+        casillero_t* casillero = &hash->casilleros[i];
+        if(casillero->hash == buscada->hash && casillero->largo == buscada->largo && hash->nucleos->iguales(casillero->clave, buscada->clave, buscada->largo))
+            return (long)i;
+        i = (i + 1) & mascara;
+    }
+    return ERROR;
+}
+
+int hash_rh_insertar(hash_rh_t* hash, const char* clave, void* elemento){
+    if(!hash || !clave)
+        return ERROR;
+    buscada_t buscada = preparar(hash, clave);
+    long posicion = buscar(hash, &buscada);
+    if(posicion != ERROR){
+        void* anterior = hash->casilleros[posicion].elemento;
+        hash->casilleros[posicion].elemento = elemento;
+        if(hash->destructor && anterior != elemento)
+            hash->destructor(anterior);
+        return EXITO;
+    }
+    if((hash->cantidad + 1) * 100 > hash->capacidad * MAX_CARGA && agrandar(hash) == ERROR)
+        return ERROR;
+    casillero_t nuevo;
+    nuevo.clave = malloc(buscada.largo + 1);
+    if(!nuevo.clave)
+        return ERROR;
+    memcpy(nuevo.clave, clave, buscada.largo + 1);
+    nuevo.elemento = elemento;
+    nuevo.hash = buscada.hash;
+    nuevo.largo = buscada.largo;
+    ubicar(hash->casilleros, hash->capacidad, nuevo);
+    hash->cantidad++;
+    return EXITO;
+}
+
+int hash_rh_quitar(hash_rh_t* hash, const char* clave){
+    if(!hash || !clave)
+        return ERROR;
+    buscada_t buscada = preparar(hash, clave);
+    long posicion = buscar(hash, &buscada);
+    if(posicion == ERROR)
+        return ERROR;
+    size_t i = (size_t)posicion, mascara = hash->capacidad - 1;
+    free(hash->casilleros[i].clave);
+    if(hash->destructor)
+        hash->destructor(hash->casilleros[i].elemento);
+    size_t siguiente = (i + 1) & mascara;
+    while(hash->casilleros[siguiente].distancia > 1){
+        hash->casilleros[i] = hash->casilleros[siguiente];
+        hash->casilleros[i].distancia--;
+        i = siguiente;
+        siguiente = (siguiente + 1) & mascara;
+    }
+    memset(&hash->casilleros[i], 0, sizeof(casillero_t));
+    hash->cantidad--;
+    return EXITO;
+}
+
+void* hash_rh_obtener(hash_rh_t* hash, const char* clave){
+    if(!hash || !clave)
+        return NULL;
+    buscada_t buscada = preparar(hash, clave);
+    long posicion = buscar(hash, &buscada);
+    if(posicion == ERROR)
+        return NULL;
+    return hash->casilleros[posicion].elemento;
+}
+
+bool hash_rh_contiene(hash_rh_t* hash, const char* clave){
+    if(!hash || !clave)
+        return false;
+    buscada_t buscada = preparar(hash, clave);
+    return buscar(hash, &buscada) != ERROR;
+}
+
+size_t hash_rh_cantidad(hash_rh_t* hash){
+    if(!hash)
+        return VACIO;
+    return hash->cantidad;
+}
+
+size_t hash_rh_distancia_maxima(hash_rh_t* hash){
+    if(!hash)
+        return VACIO;
+    size_t maxima = 0;
+    for(size_t i = 0; i < hash->capacidad; i++)
+        if(hash->casilleros[i].distancia > maxima + 1)
+            maxima = hash->casilleros[i].distancia - 1;
+    return maxima;
+}
+
+size_t hash_rh_con_cada_clave(hash_rh_t* hash, bool (*funcion)(hash_rh_t* hash, const char* clave, void* aux), void* aux){
+    if(!hash || !funcion)
+        return VACIO;
+    size_t cantidad = 0;
+    bool corte = false;
+    for(size_t i = 0; i < hash->capacidad && !corte; i++){
+        if(!hash->casilleros[i].distancia)
+            continue;
+        corte = funcion(hash, hash->casilleros[i].clave, aux);
+        cantidad++;
+    }
+    return cantidad;
+}
+
+void hash_rh_destruir(hash_rh_t* hash){
+    if(!hash)
+        return;
+    for(size_t i = 0; i < hash->capacidad; i++){
+        if(!hash->casilleros[i].distancia)
+            continue;
+        free(hash->casilleros[i].clave);
+        if(hash->destructor)
+            hash->destructor(hash->casilleros[i].elemento);
+    }
+    reserva_liberar(hash->casilleros);
+    free(hash);
+}
@@ -0,0 +1,89 @@
+#ifndef __HASH_RH_H__
+#define __HASH_RH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hash.h"
+#include "reserva.h"
+
+/*
+ * Hash con direccionamiento abierto y desplazamiento Robin Hood: al
+ * insertar, una clave que ya se alejo mas de su posicion ideal le quita
+ * el lugar a una que esta mas cerca de la suya, por lo que la distancia
+ * maxima se mantiene chica aun con la tabla cargada al 90%. Una busqueda
+ * fallida termina apenas encuentra una clave mas cerca de su posicion
+ * ideal que la buscada, y al quitar se corren hacia atras las claves
+ * siguientes en lugar de dejar marcas de borrado.
+ *
+ * Tiene la misma interfaz que el hash abierto.
+ */
+typedef struct hash_rh hash_rh_t;
+
+/*
+ * Crea el hash reservando lugar para la capacidad dada de elementos
+ * (minimo 3). El destructor se invoca con cada elemento que se quite o
+ * reemplace.
+ *
+ * Devuelve el hash creado o NULL en caso de error.
+ */
+hash_rh_t* hash_rh_crear(hash_destruir_dato_t destruir_elemento, size_t capacidad);
+
+/*
+ * Igual que hash_rh_crear, pero la tabla se reserva al crearla y al
+ * agrandarla segun las opciones de reserva (paginas grandes y ubicacion
+ * NUMA). Si reserva es NULL usa malloc.
+ *
+ * Devuelve el hash creado o NULL en caso de error.
+ */
+hash_rh_t* hash_rh_crear_con_reserva(hash_destruir_dato_t destruir_elemento, size_t capacidad, const reserva_t* reserva);
+
+/*
+ * Inserta el elemento asociado a una copia de la clave. Si la clave ya
+ * existia se reemplaza su elemento.
+ *
+ * Devuelve 0 si pudo guardarlo o -1 si no pudo.
+ */
+int hash_rh_insertar(hash_rh_t* hash, const char* clave, void* elemento);
+
+/*
+ * Quita el elemento de la clave e invoca al destructor.
+ * Devuelve 0 si pudo quitarlo o -1 si no pudo (o si no estaba).
+ */
+int hash_rh_quitar(hash_rh_t* hash, const char* clave);
+
+/*
+ * Devuelve el elemento de la clave o NULL si no esta (o en caso de
+ * error).
+ */
+void* hash_rh_obtener(hash_rh_t* hash, const char* clave);
+
+/*
+ * Devuelve true si el hash contiene la clave o false en caso contrario.
+ */
+bool hash_rh_contiene(hash_rh_t* hash, const char* clave);
+
+/*
+ * Devuelve la cantidad de elementos del hash o 0 en caso de error.
+ */
+size_t hash_rh_cantidad(hash_rh_t* hash);
+
+/*
+ * Devuelve la mayor distancia de una clave a su posicion ideal, o 0 si
+ * el hash esta vacio o en caso de error.
+ */
+size_t hash_rh_distancia_maxima(hash_rh_t* hash);
+
+/*
+ * Recorre las claves del hash invocando a la funcion con cada una, hasta
+ * que devuelva true. No se debe modificar el hash durante el recorrido.
+ *
+ * Devuelve la cantidad de claves recorridas.
+ */
+size_t hash_rh_con_cada_clave(hash_rh_t* hash, bool (*funcion)(hash_rh_t* hash, const char* clave, void* aux), void* aux);
+
+/*
+ * Destruye el hash invocando al destructor con cada elemento.
+ */
+void hash_rh_destruir(hash_rh_t* hash);
+
+#endif /* __HASH_RH_H__ */
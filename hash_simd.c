@@ -0,0 +1,270 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hash_funciones.h"
+#include "hash_simd.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define NUCLEOS_X86
+#include <immintrin.h>
+#define OBJETIVO(conjunto) __attribute__((target(conjunto)))
+#endif
+
+#define ERROR -1
+#define EXITO 0
+#define IGUAL 0
+#define SEMILLA_A 0x9e3779b9U
+#define SEMILLA_B 0x7f4a7c15U
+#define MULTIPLICADOR 0x9e3779b97f4a7c15ULL
+#define PALABRA 8
+#define BLOQUE_SSE2 16
+#define BLOQUE_AVX2 32
+#define BYTE 0xff
+#define BITS_BYTE 8
+#define MITAD 32
+#define GIRO 13
+#define MAX_ETIQUETAS 32
+
+/*
+ * Tabla del CRC32C (polinomio de Castagnoli reflejado 0x82f63b78) para
+ * la version sin SSE4.2.
+ */
+static const uint32_t tabla_crc[256] = {
+    0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
+    0x26a1e7e8, 0xd4ca64eb, 0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b,
+    0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24, 0x105ec76f, 0xe235446c,
+    0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+    0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc,
+    0xbc267848, 0x4e4dfb4b, 0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a,
+    0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35, 0xaa64d611, 0x580f5512,
+    0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+    0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad,
+    0x1642ae59, 0xe4292d5a, 0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a,
+    0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595, 0x417b1dbc, 0xb3109ebf,
+    0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+    0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f,
+    0xed03a29b, 0x1f682198, 0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927,
+    0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38, 0xdbfc821c, 0x2997011f,
+    0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+    0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e,
+    0x4767748a, 0xb50cf789, 0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859,
+    0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46, 0x7198540d, 0x83f3d70e,
+    0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+    0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de,
+    0xdde0eb2a, 0x2f8b6829, 0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c,
+    0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93, 0x082f63b7, 0xfa44e0b4,
+    0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+    0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b,
+    0xb4091bff, 0x466298fc, 0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c,
+    0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033, 0xa24bb5a6, 0x502036a5,
+    0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+    0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975,
+    0x0e330a81, 0xfc588982, 0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d,
+    0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622, 0x38cc2a06, 0xcaa7a905,
+    0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+    0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8,
+    0xe52cc12c, 0x1747422f, 0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff,
+    0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0, 0xd3d3e1ab, 0x21b862a8,
+    0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+    0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78,
+    0x7fab5e8c, 0x8dc0dd8f, 0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee,
+    0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1, 0x69e9f0d5, 0x9b8273d6,
+    0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+    0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69,
+    0xd5cf889d, 0x27a40b9e, 0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e,
+    0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
+};
+
+static const hash_nucleos_t* forzados = NULL;
+
+//Lee una palabra de 8 bytes sin importar la alineacion
+static inline uint64_t leer_palabra(const char* datos){
+    uint64_t palabra;
+    memcpy(&palabra, datos, PALABRA);
+    return palabra;
+}
+
+//Rota el valor de 32 bits la cantidad de bits dada hacia la izquierda
+static inline uint32_t rotar(uint32_t valor, unsigned bits){
+    return (valor << bits) | (valor >> (MITAD - bits));
+}
+
+/*
+ * Hash comun a todas las implementaciones, que solo difieren en como
+ * acumulan una palabra en el CRC32C. Se expande dentro de cada version
+ * para que el compilador pueda usar las instrucciones de esa version.
+ *
+ * Despues de cada bloque de 16 bytes los carriles se mezclan entre si,
+ * para que cada uno dependa de todo lo anterior. La palabra suelta del
+ * final entra a los dos carriles, como los bytes que sobran.
+ */
+#define CUERPO_HASHEAR(crc_palabra) \
+    uint32_t a = SEMILLA_A, b = SEMILLA_B; \
+    size_t i = 0; \
+    for(; i + 2 * PALABRA <= largo; i += 2 * PALABRA){ \
+        a = crc_palabra(a, leer_palabra(clave + i)); \
+        b = crc_palabra(b, leer_palabra(clave + i + PALABRA)); \
+        a += rotar(b, GIRO); \
+        b ^= rotar(a, MITAD - GIRO); \
+    } \
+    if(i + PALABRA <= largo){ \
+        uint64_t palabra = leer_palabra(clave + i); \
+        a = crc_palabra(a, palabra * MULTIPLICADOR); \
+        b = crc_palabra(b, palabra); \
+        i += PALABRA; \
+    } \
+    if(i < largo){ \
+        uint64_t resto = 0; \
+        memcpy(&resto, clave + i, largo - i); \
+        a = crc_palabra(a, resto * MULTIPLICADOR); \
+        b = crc_palabra(b, resto); \
+    } \
+    return hash_mezclar((((uint64_t)a << MITAD) | b) ^ (uint64_t)largo);
+
+//Acumula en el CRC32C los 8 bytes de la palabra, del menos significativo al mas
+static inline uint32_t crc_portable(uint32_t crc, uint64_t palabra){
+    for(int i = 0; i < PALABRA; i++){
+        crc = tabla_crc[(crc ^ (uint32_t)palabra) & BYTE] ^ (crc >> BITS_BYTE);
+        palabra >>= BITS_BYTE;
+    }
+    return crc;
+}
+
+static uint64_t hashear_portable(const char* clave, size_t largo){
+    CUERPO_HASHEAR(crc_portable)
+}
+
+static bool iguales_portable(const char* a, const char* b, size_t largo){
+    return memcmp(a, b, largo) == IGUAL;
+}
+
+static uint32_t coincidencias_portable(const uint8_t* etiquetas, size_t cantidad, uint8_t etiqueta){
+    uint32_t mascara = 0;
+    for(size_t i = 0; i < cantidad && i < MAX_ETIQUETAS; i++)
+        if(etiquetas[i] == etiqueta)
+            mascara |= (uint32_t)1 << i;
+    return mascara;
+}
+
+#ifdef NUCLEOS_X86
+OBJETIVO("sse4.2") static inline uint32_t crc_sse42(uint32_t crc, uint64_t palabra){
+    return (uint32_t)_mm_crc32_u64(crc, palabra);
+}
+
+OBJETIVO("sse4.2") static uint64_t hashear_sse42(const char* clave, size_t largo){
+    CUERPO_HASHEAR(crc_sse42)
+}
+
+static bool iguales_sse2(const char* a, const char* b, size_t largo){
+    while(largo >= BLOQUE_SSE2){
+        __m128i x = _mm_loadu_si128((const __m128i*)(const void*)a);
+        __m128i y = _mm_loadu_si128((const __m128i*)(const void*)b);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff)
+            return false;
+        a += BLOQUE_SSE2;
+        b += BLOQUE_SSE2;
+        largo -= BLOQUE_SSE2;
+    }
+    return memcmp(a, b, largo) == IGUAL;
+}
+
+static uint32_t coincidencias_sse2(const uint8_t* etiquetas, size_t cantidad, uint8_t etiqueta){
+    if(cantidad < BLOQUE_SSE2)
+        return coincidencias_portable(etiquetas, cantidad, etiqueta);
+    __m128i buscada = _mm_set1_epi8((char)etiqueta);
+    uint32_t mascara = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(const void*)etiquetas), buscada));
+    if(cantidad > BLOQUE_SSE2)
+        mascara |= coincidencias_sse2(etiquetas + BLOQUE_SSE2, cantidad - BLOQUE_SSE2, etiqueta) << BLOQUE_SSE2;
+    return mascara;
+}
+
+OBJETIVO("avx2") static bool iguales_avx2(const char* a, const char* b, size_t largo){
+    while(largo >= BLOQUE_AVX2){
+        __m256i x = _mm256_loadu_si256((const __m256i*)(const void*)a);
+        __m256i y = _mm256_loadu_si256((const __m256i*)(const void*)b);
+        if((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != 0xffffffffU)
+            return false;
+        a += BLOQUE_AVX2;
+        b += BLOQUE_AVX2;
+        largo -= BLOQUE_AVX2;
+    }
+    return iguales_sse2(a, b, largo);
+}
+
+OBJETIVO("avx2") static uint32_t coincidencias_avx2(const uint8_t* etiquetas, size_t cantidad, uint8_t etiqueta){
+    if(cantidad < BLOQUE_AVX2)
+        return coincidencias_sse2(etiquetas, cantidad, etiqueta);
+    __m256i buscada = _mm256_set1_epi8((char)etiqueta);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(const void*)etiquetas), buscada));
+}
+#endif
+
+static const hash_nucleos_t nucleos[] = {
+    {"portable", hashear_portable, iguales_portable, coincidencias_portable},
+#ifdef NUCLEOS_X86
+    {"sse42", hashear_sse42, iguales_sse2, coincidencias_sse2},
+    {"avx2", hashear_sse42, iguales_avx2, coincidencias_avx2},
+#endif
+};
+
+#define CANT_NUCLEOS (sizeof(nucleos) / sizeof(nucleos[0]))
+
+//Devuelve true si el procesador soporta el juego de nucleos
+static bool soportados(const hash_nucleos_t* juego){
+#ifdef NUCLEOS_X86
+    if(strcmp(juego->nombre, "sse42") == IGUAL)
+        return __builtin_cpu_supports("sse4.2");
+    if(strcmp(juego->nombre, "avx2") == IGUAL)
+        return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("avx2");
+#endif
+    return true;
+}
+
+const hash_nucleos_t* hash_simd_mejores(){
+    static const hash_nucleos_t* mejores = NULL;
+    if(mejores)
+        return mejores;
+    size_t i = CANT_NUCLEOS;
+    while(i > 1 && !soportados(&nucleos[i - 1]))
+        i--;
+    mejores = &nucleos[i - 1];
+    return mejores;
+}
+
+const hash_nucleos_t* hash_simd_buscar(const char* nombre){
+    if(!nombre)
+        return NULL;
+    for(size_t i = 0; i < CANT_NUCLEOS; i++)
+        if(strcmp(nucleos[i].nombre, nombre) == IGUAL)
+            return soportados(&nucleos[i]) ? &nucleos[i] : NULL;
+    return NULL;
+}
+
+const hash_nucleos_t* hash_simd_nucleos(){
+    if(forzados)
+        return forzados;
+    const hash_nucleos_t* del_entorno = hash_simd_buscar(getenv(HASH_NUCLEOS_ENTORNO));
+    return del_entorno ? del_entorno : hash_simd_mejores();
+}
+
+int hash_simd_forzar(const char* nombre){
+    if(!nombre){
+        forzados = NULL;
+        return EXITO;
+    }
+    const hash_nucleos_t* juego = hash_simd_buscar(nombre);
+    if(!juego)
+        return ERROR;
+    forzados = juego;
+    return EXITO;
+}
+
+uint64_t hash_simd_hashear(const char* clave, size_t largo){
+    return hash_simd_mejores()->hashear(clave, largo);
+}
+
+bool hash_simd_iguales(const char* a, const char* b, size_t largo){
+    return hash_simd_mejores()->iguales(a, b, largo);
+}
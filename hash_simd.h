@@ -0,0 +1,78 @@
+#ifndef __HASH_SIMD_H__
+#define __HASH_SIMD_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Nucleos vectorizados para hashear, comparar claves y buscar etiquetas.
+ *
+ * El hash usa CRC32C sobre palabras de 8 bytes en dos carriles, que
+ * se mezclan entre si despues de cada bloque de 16 bytes, y termina con
+ * la mezcla de hash_mezclar. La palabra y los bytes que sobran al final
+ * entran a ambos carriles, a uno de ellos multiplicados, para que las
+ * claves cortas tambien den 64 bits utiles. Dentro de un bloque cada
+ * palabra entra a un solo carril, asi que se pueden armar a proposito
+ * claves de un bloque con el mismo hash: no resiste colisiones
+ * buscadas. Todas las implementaciones dan exactamente el mismo hash.
+ *
+ * La biblioteca se compila sin flags de arquitectura: las versiones
+ * SSE4.2 y AVX2 se compilan aparte y se elige la mejor que soporta el
+ * procesador al crear cada tabla, consultando cpuid una sola vez.
+ */
+
+/*
+ * Juego de nucleos. Coincidencias devuelve una mascara con un bit en 1
+ * por cada una de las primeras cantidad etiquetas (a lo sumo 32) que es
+ * igual a la buscada.
+ */
+typedef struct hash_nucleos{
+    const char* nombre;
+    uint64_t (*hashear)(const char* clave, size_t largo);
+    bool (*iguales)(const char* a, const char* b, size_t largo);
+    uint32_t (*coincidencias)(const uint8_t* etiquetas, size_t cantidad, uint8_t etiqueta);
+}hash_nucleos_t;
+
+/*
+ * Variable de entorno con el nombre del juego de nucleos a usar en las
+ * tablas que se creen ("portable", "sse42" o "avx2"), para comparar
+ * implementaciones sin recompilar.
+ */
+#define HASH_NUCLEOS_ENTORNO "HASH_NUCLEOS"
+
+/*
+ * Devuelve el mejor juego de nucleos que soporta el procesador.
+ */
+const hash_nucleos_t* hash_simd_mejores();
+
+/*
+ * Devuelve el juego de nucleos con ese nombre o NULL si no existe o si
+ * el procesador no lo soporta.
+ */
+const hash_nucleos_t* hash_simd_buscar(const char* nombre);
+
+/*
+ * Devuelve el juego de nucleos que deben usar las tablas nuevas: el
+ * forzado con hash_simd_forzar, si no el de la variable de entorno
+ * HASH_NUCLEOS (si es valido) y si no el mejor.
+ */
+const hash_nucleos_t* hash_simd_nucleos();
+
+/*
+ * Fuerza el juego de nucleos de las tablas que se creen despues, o
+ * vuelve a la eleccion automatica con NULL. No es seguro llamarla
+ * mientras otro hilo crea tablas.
+ *
+ * Devuelve 0 si pudo o -1 si el juego no existe o no esta soportado.
+ */
+int hash_simd_forzar(const char* nombre);
+
+/*
+ * Devuelven el hash de los primeros largo bytes de la clave y si los
+ * primeros largo bytes de a y b son iguales, con los mejores nucleos.
+ */
+uint64_t hash_simd_hashear(const char* clave, size_t largo);
+bool hash_simd_iguales(const char* a, const char* b, size_t largo);
+
+#endif /* __HASH_SIMD_H__ */
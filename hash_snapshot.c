@@ -0,0 +1,339 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "lista.h"
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_snapshot.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+#define MIN_DIFERIDOS 16
+
+/*
+ * El snapshot guarda su propio arreglo de paginas, con una referencia a
+ * cada una. Liberado lo escribe cualquier hilo al soltarlo y lo lee el
+ * hilo que modifica el hash, que es el unico que libera memoria.
+ */
+struct hash_snapshot{
+    pagina_t** paginas;
+    size_t cant_paginas;
+    size_t capacidad;
+    size_t cantidad;
+    const hash_nucleos_t* nucleos;
+    uint64_t generacion;
+    bool liberado;
+    struct hash_snapshot* siguiente;
+};
+
+typedef struct copia{
+    lista_t* lista;
+    bool fallo;
+}copia_t;
+
+typedef struct recorrido{
+    bool (*funcion)(const char* clave, void* elemento, void* aux);
+    void* aux;
+    size_t cantidad;
+    bool corte;
+}recorrido_t;
+
+//Libera la entrada sin liberar su clave, elemento ni temporizador
+static void liberar_estructura(void* dato, void* contexto){
+    free(dato);
+}
+
+/*
+ * Libera una pagina que ya no usa nadie con sus listas y sus entradas,
+ * pero no las claves ni los elementos, que son de otra copia de las
+ * entradas o estan diferidos.
+ */
+static void liberar_casco(pagina_t* pagina){
+    for(size_t i = 0; i < pagina->cantidad; i++){
+        lista_con_cada_elemento(pagina->baldes[i].lista, liberar_estructura, NULL);
+        lista_destruir(pagina->baldes[i].lista);
+    }
+    hash_liberar_pagina(pagina);
+}
+
+//Agrega a la lista de la copia una copia de la entrada
+static void copiar_entrada(void* dato, void* contexto){
+    copia_t* copia = contexto;
+    if(copia->fallo)
+        return;
+    ele_t* entrada = malloc(sizeof(ele_t));
+    if(!entrada || lista_insertar(copia->lista, entrada) == ERROR){
+        free(entrada);
+        copia->fallo = true;
+        return;
+    }
+    *entrada = *(ele_t*)dato;
+    entrada->clave_compartida = true;
+    entrada->elemento_compartido = true;
+}
+
+//Hace que el temporizador y el indice del hash apunten a la copia
+static void apuntar_copia(void* dato, void* contexto){
+    hash_t* hash = contexto;
+    ele_t* entrada = dato;
+    if(entrada->temporizador)
+        entrada->temporizador->dato = entrada;
+    indice_reemplazar(hash->indice, entrada);
+}
+
+/*
+ * Reemplaza en el hash la pagina de ese numero, que comparte con algun
+ * snapshot, por una copia propia con copias de sus entradas. Las claves
+ * y los elementos quedan compartidos con las entradas originales.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso el hash queda como
+ * estaba.
+ */
+static int copiar_pagina(hash_t* hash, size_t numero){
+    pagina_t* vieja = hash->paginas[numero];
+    pagina_t* nueva = calloc(1, sizeof(pagina_t) + vieja->cantidad * sizeof(vector_t));
+    if(!nueva)
+        return ERROR;
+    nueva->referencias = 1;
+    nueva->cantidad = vieja->cantidad;
+    copia_t copia = {NULL, false};
+    for(size_t i = 0; i < vieja->cantidad && !copia.fallo; i++){
+        if(!vieja->baldes[i].lista)
+            continue;
+        copia.lista = nueva->baldes[i].lista = lista_crear();
+        if(!copia.lista)
+            copia.fallo = true;
+        else
+            lista_con_cada_elemento(vieja->baldes[i].lista, copiar_entrada, &copia);
+    }
+    if(copia.fallo){
+        liberar_casco(nueva);
+        return ERROR;
+    }
+    for(size_t i = 0; i < nueva->cantidad; i++)
+        lista_con_cada_elemento(nueva->baldes[i].lista, apuntar_copia, hash);
+    vieja->referencias--;
+    hash->paginas[numero] = nueva;
+    HASH_CONTAR(hash, paginas_copiadas);
+    return EXITO;
+}
+
+/*
+ * Se asegura de que entren cantidad diferidos mas sin agrandar el
+ * arreglo. Devuelve 0 si pudo o -1 si no pudo.
+ */
+static int reservar_diferidos(hash_t* hash, size_t cantidad){
+    size_t necesarios = hash->cant_diferidos + cantidad;
+    if(necesarios <= hash->cap_diferidos)
+        return EXITO;
+    size_t capacidad = hash->cap_diferidos ? hash->cap_diferidos : MIN_DIFERIDOS;
+    while(capacidad < necesarios)
+        capacidad *= 2;
+    diferido_t* diferidos = realloc(hash->diferidos, capacidad * sizeof(diferido_t));
+    if(!diferidos)
+        return ERROR;
+    hash->diferidos = diferidos;
+    hash->cap_diferidos = capacidad;
+    return EXITO;
+}
+
+//Libera lo que anoto el diferido
+static void liberar_diferido(hash_t* hash, diferido_t* diferido){
+    if(diferido->entrada.clave_compartida)
+        hash_liberar_clave(hash, &diferido->entrada);
+    if(diferido->entrada.elemento_compartido)
+        hash_liberar_dato(hash, &diferido->entrada);
+}
+
+/*
+ * Libera los diferidos que ya no puede usar ningun snapshot vivo: los
+ * que se descartaron antes de tomar el snapshot vivo mas viejo.
+ */
+static void liberar_diferidos(hash_t* hash){
+    uint64_t mas_viejo = UINT64_MAX;
+    for(hash_snapshot_t* snapshot = hash->snapshots; snapshot; snapshot = snapshot->siguiente)
+        if(snapshot->generacion < mas_viejo)
+            mas_viejo = snapshot->generacion;
+    size_t quedan = 0;
+    for(size_t i = 0; i < hash->cant_diferidos; i++){
+        if(hash->diferidos[i].generacion < mas_viejo)
+            liberar_diferido(hash, &hash->diferidos[i]);
+        else
+            hash->diferidos[quedan++] = hash->diferidos[i];
+    }
+    hash->cant_diferidos = quedan;
+    if(!hash->snapshots){
+        free(hash->diferidos);
+        hash->diferidos = NULL;
+        hash->cap_diferidos = VACIO;
+    }
+}
+
+//Suelta las paginas del snapshot, liberando las que nadie mas usa
+static void destruir_snapshot(hash_snapshot_t* snapshot){
+    for(size_t i = 0; i < snapshot->cant_paginas; i++)
+        if(--snapshot->paginas[i]->referencias == VACIO)
+            liberar_casco(snapshot->paginas[i]);
+    free(snapshot->paginas);
+    free(snapshot);
+}
+
+bool hash_con_snapshots(hash_t* hash){
+    if(!hash->snapshots)
+        return false;
+    bool solto = false;
+    hash_snapshot_t** lugar = &hash->snapshots;
+    while(*lugar){
+        hash_snapshot_t* snapshot = *lugar;
+        if(__atomic_load_n(&snapshot->liberado, __ATOMIC_ACQUIRE)){
+            *lugar = snapshot->siguiente;
+            destruir_snapshot(snapshot);
+            solto = true;
+        }else
+            lugar = &snapshot->siguiente;
+    }
+    if(solto)
+        liberar_diferidos(hash);
+    return hash->snapshots != NULL;
+}
+
+void hash_snapshots_destruir(hash_t* hash){
+    while(hash->snapshots){
+        hash_snapshot_t* snapshot = hash->snapshots;
+        hash->snapshots = snapshot->siguiente;
+        destruir_snapshot(snapshot);
+    }
+    liberar_diferidos(hash);
+}
+
+int hash_preparar_balde(hash_t* hash, size_t pos){
+    if(!hash_con_snapshots(hash))
+        return EXITO;
+    if(reservar_diferidos(hash, lista_elementos(HASH_BALDE(hash, pos)->lista)) == ERROR)
+        return ERROR;
+    size_t numero = pos / BALDES_POR_PAGINA;
+    if(hash->paginas[numero]->referencias == 1)
+        return EXITO;
+    return copiar_pagina(hash, numero);
+}
+
+int hash_separar(hash_t* hash){
+    if(!hash_con_snapshots(hash))
+        return EXITO;
+    for(size_t i = 0; i < HASH_PAGINAS(hash->capacidad); i++)
+        if(hash->paginas[i]->referencias > 1 && copiar_pagina(hash, i) == ERROR)
+            return ERROR;
+    return EXITO;
+}
+
+void hash_diferir(hash_t* hash, ele_t* entrada, bool con_clave){
+    bool clave = con_clave && entrada->clave_compartida;
+    if(!clave && !entrada->elemento_compartido)
+        return;
+    if(!hash_con_snapshots(hash)){
+        entrada->elemento_compartido = false;
+        if(con_clave)
+            entrada->clave_compartida = false;
+        return;
+    }
+    //Si no hay lugar se pierde la memoria antes que liberar algo en uso
+    if(reservar_diferidos(hash, 1) == ERROR)
+        return;
+    diferido_t* diferido = &hash->diferidos[hash->cant_diferidos++];
+    diferido->generacion = hash->generacion;
+    diferido->entrada = *entrada;
+    diferido->entrada.clave_compartida = clave;
+}
+
+hash_snapshot_t* hash_snapshot(hash_t* hash){
+    if(!hash || hash->multiples || hash->extra_entrada)
+        return NULL;
+    hash_con_snapshots(hash);
+    hash_snapshot_t* snapshot = malloc(sizeof(hash_snapshot_t));
+    if(!snapshot)
+        return NULL;
+    snapshot->cant_paginas = HASH_PAGINAS(hash->capacidad);
+    snapshot->paginas = malloc(snapshot->cant_paginas * sizeof(pagina_t*));
+    if(!snapshot->paginas){
+        free(snapshot);
+        return NULL;
+    }
+    for(size_t i = 0; i < snapshot->cant_paginas; i++){
+        snapshot->paginas[i] = hash->paginas[i];
+        snapshot->paginas[i]->referencias++;
+    }
+    snapshot->capacidad = hash->capacidad;
+    snapshot->cantidad = hash->cant_elementos;
+    snapshot->nucleos = hash->nucleos;
+    snapshot->generacion = ++hash->generacion;
+    snapshot->liberado = false;
+    snapshot->siguiente = hash->snapshots;
+    hash->snapshots = snapshot;
+    return snapshot;
+}
+
+//Devuelve la entrada de la clave en el snapshot o NULL si no esta
+static ele_t* buscar_en_snapshot(hash_snapshot_t* snapshot, const char* clave){
+    size_t largo = strlen(clave);
+    size_t numero = (size_t)snapshot->nucleos->hashear(clave, largo);
+    lista_t* lista = PAGINA_BALDE(snapshot->paginas, numero % snapshot->capacidad)->lista;
+    if(lista_vacia(lista))
+        return NULL;
+    lista_iterador_t* iterador = lista_iterador_crear(lista);
+    if(!iterador)
+        return NULL;
+    ele_t* encontrada = NULL;
+    while(!encontrada && lista_iterador_tiene_siguiente(iterador)){
+        ele_t* entrada = lista_iterador_siguiente(iterador);
+        if(entrada->hash == numero && entrada->largo == largo && snapshot->nucleos->iguales(entrada->clave, clave, largo))
+            encontrada = entrada;
+    }
+    lista_iterador_destruir(iterador);
+    return encontrada;
+}
+
+void* hash_snapshot_obtener(hash_snapshot_t* snapshot, const char* clave){
+    if(!snapshot || !clave)
+        return NULL;
+    ele_t* entrada = buscar_en_snapshot(snapshot, clave);
+    return entrada ? entrada->elemento : NULL;
+}
+
+bool hash_snapshot_contiene(hash_snapshot_t* snapshot, const char* clave){
+    if(!snapshot || !clave)
+        return false;
+    return buscar_en_snapshot(snapshot, clave) != NULL;
+}
+
+size_t hash_snapshot_cantidad(hash_snapshot_t* snapshot){
+    if(!snapshot)
+        return VACIO;
+    return snapshot->cantidad;
+}
+
+//Invoca a la funcion del recorrido con la entrada, salvo que ya se corto
+static void recorrer_entrada(void* dato, void* contexto){
+    recorrido_t* recorrido = contexto;
+    if(recorrido->corte)
+        return;
+    ele_t* entrada = dato;
+    recorrido->corte = recorrido->funcion(entrada->clave, entrada->elemento, recorrido->aux);
+    recorrido->cantidad++;
+}
+
+size_t hash_snapshot_con_cada_clave(hash_snapshot_t* snapshot, bool (*funcion)(const char* clave, void* elemento, void* aux), void* aux){
+    if(!snapshot || !funcion)
+        return VACIO;
+    recorrido_t recorrido = {funcion, aux, VACIO, false};
+    for(size_t i = 0; i < snapshot->capacidad && !recorrido.corte; i++)
+        lista_con_cada_elemento(PAGINA_BALDE(snapshot->paginas, i)->lista, recorrer_entrada, &recorrido);
+    return recorrido.cantidad;
+}
+
+void hash_snapshot_liberar(hash_snapshot_t* snapshot){
+    if(snapshot)
+        __atomic_store_n(&snapshot->liberado, true, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,72 @@
+#ifndef __HASH_SNAPSHOT_H__
+#define __HASH_SNAPSHOT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Vista inmutable del hash en el momento en que se tomo. Tomarla cuesta
+ * lo mismo que copiar un puntero por cada 512 baldes: el snapshot
+ * comparte las paginas de baldes con el hash, y el hash copia una pagina
+ * recien la primera vez que la modifica despues de tomar el snapshot.
+ * Las claves y elementos que el hash quita o reemplaza mientras un
+ * snapshot los puede estar usando se liberan recien cuando se suelta
+ * ese snapshot.
+ *
+ * Mientras el hash sigue modificandose desde un hilo, otros hilos
+ * pueden consultar y recorrer el snapshot y soltarlo sin sincronizarse
+ * con el. Los elementos no se copian, asi que el snapshot ve los cambios
+ * que se hagan adentro de cada elemento.
+ */
+typedef struct hash_snapshot hash_snapshot_t;
+
+/*
+ * Toma un snapshot del hash. Los vencimientos no corren en el snapshot:
+ * ve las claves que tenia el hash aunque despues venzan.
+ *
+ * Mientras haya snapshots sin soltar no se pueden agregar valores a
+ * una clave con hash_agregar, fusionar el hash como origen ni
+ * congelarlo; tampoco se pueden tomar snapshots de un hash con claves
+ * de varios valores.
+ *
+ * Devuelve el snapshot o NULL en caso de error.
+ */
+hash_snapshot_t* hash_snapshot(hash_t* hash);
+
+/*
+ * Devuelve el elemento asociado a la clave en el snapshot o NULL si la
+ * clave no estaba (o en caso de error).
+ */
+void* hash_snapshot_obtener(hash_snapshot_t* snapshot, const char* clave);
+
+/*
+ * Devuelve true si la clave estaba en el hash cuando se tomo el
+ * snapshot o false en caso contrario (o en caso de error).
+ */
+bool hash_snapshot_contiene(hash_snapshot_t* snapshot, const char* clave);
+
+/*
+ * Devuelve la cantidad de claves del snapshot o 0 en caso de error.
+ */
+size_t hash_snapshot_cantidad(hash_snapshot_t* snapshot);
+
+/*
+ * Recorre cada clave del snapshot invocando a la funcion con la clave,
+ * su elemento y el puntero auxiliar. El recorrido se corta cuando la
+ * funcion devuelve true.
+ *
+ * Devuelve la cantidad de claves recorridas.
+ */
+size_t hash_snapshot_con_cada_clave(hash_snapshot_t* snapshot, bool (*funcion)(const char* clave, void* elemento, void* aux), void* aux);
+
+/*
+ * Suelta el snapshot, que no debe volver a usarse. Se puede llamar desde
+ * cualquier hilo: la memoria la recupera el hilo que modifica el hash.
+ *
+ * Hay que soltar todos los snapshots antes de destruir el hash;
+ * hash_destruir libera los que queden y despues no pueden usarse.
+ */
+void hash_snapshot_liberar(hash_snapshot_t* snapshot);
+
+#endif /* __HASH_SNAPSHOT_H__ */
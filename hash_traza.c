@@ -0,0 +1,23 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_traza.h"
+
+#define ERROR -1
+#define EXITO 0
+
+int hash_establecer_trazador(hash_t* hash, hash_trazador_t trazador, void* aux){
+#ifdef HASH_TRAZAS
+    if(!hash)
+        return ERROR;
+    hash->trazador = trazador;
+    hash->aux_trazador = aux;
+    return EXITO;
+#else
+    (void)hash;
+    (void)trazador;
+    (void)aux;
+    return ERROR;
+#endif
+}
@@ -0,0 +1,50 @@
+#ifndef __HASH_TRAZA_H__
+#define __HASH_TRAZA_H__
+
+#include <stddef.h>
+#include "hash.h"
+
+/*
+ * Puntos de traza del hash. Solo existen si la biblioteca se compila
+ * con -DHASH_TRAZAS; si no, no queda ningun rastro de ellos en el
+ * camino de las operaciones.
+ *
+ * Con -DHASH_TRAZAS_USDT ademas se emite cada evento como una sonda
+ * USDT (proveedor tda_hash, requiere <sys/sdt.h>), que se puede seguir
+ * con perf, bpftrace o systemtap sin registrar ninguna funcion.
+ */
+typedef enum hash_evento{
+    HASH_TRAZA_INSERTAR,
+    HASH_TRAZA_BUSCAR,
+    HASH_TRAZA_QUITAR,
+    HASH_TRAZA_REHASH_INICIO,
+    HASH_TRAZA_REHASH_FIN,
+    HASH_TRAZA_SIN_MEMORIA
+}hash_evento_t;
+
+/*
+ * Funcion que recibe cada evento del hash. La clave es la de la
+ * operacion (NULL en los eventos de rehash) y el dato depende del
+ * evento:
+ *  - INSERTAR: 1 si la clave es nueva o 0 si se reemplazo su elemento.
+ *  - BUSCAR: 1 si la clave estaba o 0 si no.
+ *  - QUITAR: 1 si se quito la clave o 0 si no estaba.
+ *  - REHASH_INICIO: la capacidad actual.
+ *  - REHASH_FIN: la capacidad resultante (la misma si fallo).
+ *  - SIN_MEMORIA: la cantidad de bytes que no se pudieron reservar.
+ *
+ * Se invoca en medio de la operacion, por lo que no debe modificar el
+ * hash.
+ */
+typedef void (*hash_trazador_t)(hash_t* hash, hash_evento_t evento, const char* clave, size_t dato, void* aux);
+
+/*
+ * Registra la funcion que recibira los eventos del hash, junto con un
+ * puntero que se le pasa en cada llamada. Con NULL deja de trazar.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo (tambien si la biblioteca se
+ * compilo sin -DHASH_TRAZAS).
+ */
+int hash_establecer_trazador(hash_t* hash, hash_trazador_t trazador, void* aux);
+
+#endif /* __HASH_TRAZA_H__ */
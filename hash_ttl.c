@@ -0,0 +1,99 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "hash.h"
+#include "hash_interno.h"
+#include "rueda_temporizadores.h"
+#include "hash_ttl.h"
+
+#define ERROR -1
+#define EXITO 0
+#define VACIO 0
+#define MILISEGUNDOS 1000
+#define NANOSEGUNDOS_POR_MILISEGUNDO 1000000
+
+//Reloj por defecto: tiempo monotono del sistema en milisegundos
+static uint64_t reloj_monotonico(void){
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (uint64_t)ahora.tv_sec * MILISEGUNDOS + (uint64_t)ahora.tv_nsec / NANOSEGUNDOS_POR_MILISEGUNDO;
+}
+
+//Devuelve el tiempo actual segun el reloj del hash
+static uint64_t tiempo_actual(hash_t* hash){
+    return hash->reloj ? hash->reloj() : reloj_monotonico();
+}
+
+bool hash_ttl_vencida(hash_t* hash, ele_t* entrada){
+    return entrada->temporizador && tiempo_actual(hash) >= entrada->temporizador->vencimiento;
+}
+
+void hash_ttl_descartar(hash_t* hash, ele_t* entrada){
+    if(!entrada->temporizador)
+        return;
+    rueda_quitar(hash->rueda, entrada->temporizador);
+    free(entrada->temporizador);
+    entrada->temporizador = NULL;
+}
+
+int hash_ttl_preparar(hash_t* hash){
+    if(!hash->rueda)
+        hash->rueda = rueda_crear(tiempo_actual(hash));
+    return hash->rueda ? EXITO : ERROR;
+}
+
+void hash_ttl_transferir(hash_t* origen, ele_t* entrada, hash_t* destino, ele_t* nueva){
+    temporizador_t* temporizador = entrada->temporizador;
+    if(!temporizador)
+        return;
+    rueda_quitar(origen->rueda, temporizador);
+    entrada->temporizador = NULL;
+    temporizador->dato = nueva;
+    nueva->temporizador = temporizador;
+    rueda_agregar(destino->rueda, temporizador);
+}
+
+int hash_insertar_con_ttl(hash_t* hash, const char* clave, void* elemento, uint64_t ttl){
+    if(!hash || !clave)
+        return ERROR;
+    if(hash_ttl_preparar(hash) == ERROR)
+        return ERROR;
+    temporizador_t* temporizador = calloc(1, sizeof(temporizador_t));
+    if(!temporizador)
+        return ERROR;
+    if(hash_insertar(hash, clave, elemento) == ERROR){
+        free(temporizador);
+        return ERROR;
+    }
+    ele_t* entrada = hash_buscar_entrada(hash, clave);
+    temporizador->vencimiento = tiempo_actual(hash) + ttl;
+    temporizador->dato = entrada;
+    entrada->temporizador = temporizador;
+    rueda_agregar(hash->rueda, temporizador);
+    return EXITO;
+}
+
+/*
+ * Se invoca con cada temporizador vencido de la rueda. Quitar la clave
+ * libera tambien el temporizador.
+ */
+static void vencer(temporizador_t* temporizador, void* aux){
+    ele_t* entrada = temporizador->dato;
+    hash_quitar(aux, entrada->clave);
+}
+
+size_t hash_expirar(hash_t* hash, size_t presupuesto){
+    if(!hash || !hash->rueda)
+        return VACIO;
+    return rueda_avanzar(hash->rueda, tiempo_actual(hash), presupuesto, vencer, hash);
+}
+
+void hash_establecer_reloj(hash_t* hash, hash_reloj_t reloj){
+    if(!hash)
+        return;
+    hash->reloj = reloj;
+}
@@ -0,0 +1,45 @@
+#ifndef __HASH_TTL_H__
+#define __HASH_TTL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hash.h"
+
+/*
+ * Reloj del hash. Devuelve el tiempo actual en milisegundos desde un
+ * origen arbitrario; solo importa que nunca retroceda.
+ */
+typedef uint64_t (*hash_reloj_t)(void);
+
+/*
+ * Inserta un elemento en el hash asociado a la clave dada, que vence
+ * pasados ttl milisegundos. Una clave vencida se quita del hash (y se
+ * invoca al destructor con su elemento) la proxima vez que se la busca
+ * o cuando la encuentra hash_expirar, lo que ocurra primero. Las
+ * busquedas hechas durante hash_con_cada_clave no la quitan: la tratan
+ * como ausente.
+ *
+ * Si la clave ya existia se reemplaza su elemento y su vencimiento.
+ * Insertar la clave con hash_insertar le quita el vencimiento.
+ *
+ * Devuelve 0 si pudo guardarlo o -1 si no pudo.
+ */
+int hash_insertar_con_ttl(hash_t* hash, const char* clave, void* elemento, uint64_t ttl);
+
+/*
+ * Quita del hash las claves vencidas, invocando al destructor con cada
+ * elemento. Para no frenar a quien la llama, hace como mucho presupuesto
+ * pasos de trabajo; llamadas sucesivas continuan desde donde quedo la
+ * anterior.
+ *
+ * Devuelve la cantidad de claves quitadas.
+ */
+size_t hash_expirar(hash_t* hash, size_t presupuesto);
+
+/*
+ * Reemplaza el reloj del hash (por defecto, el reloj monotono del
+ * sistema). Debe llamarse antes de insertar claves con vencimiento.
+ */
+void hash_establecer_reloj(hash_t* hash, hash_reloj_t reloj);
+
+#endif /* __HASH_TTL_H__ */
@@ -0,0 +1,423 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "hash.h"
+#include "hash_interno.h"
+#include "hash_funciones.h"
+#include "hash_persistencia.h"
+#include "hash_wal.h"
+
+#define ERROR -1
+#define EXITO 0
+#define IGUAL 0
+#define VACIO 0
+#define MAGIA "TDAWAL01"
+#define LARGO_MAGIA 8
+#define EXTENSION_LOG ".log"
+#define EXTENSION_IMAGEN ".img"
+#define EXTENSION_TEMPORAL ".img.tmp"
+#define PERMISOS 0644
+#define CAPACIDAD_MIN 3
+#define CAPACIDAD_BUFFER 4096
+#define MAX_BUFFER (1024 * 1024)
+#define SEMILLA 0
+
+typedef enum tipo_registro{
+    REGISTRO_INSERTAR = 1,
+    REGISTRO_QUITAR = 2
+}tipo_registro_t;
+
+/*
+ * Cabecera de cada registro del log, seguida por los bytes de la clave
+ * (sin el '\0') y los del valor. La suma cubre todo el registro salvo
+ * ella misma y permite detectar un registro escrito a medias.
+ */
+typedef struct registro{
+    uint64_t suma;
+    uint64_t largo_valor;
+    uint32_t largo_clave;
+    uint32_t tipo;
+}registro_t;
+
+/*
+ * Los registros se acumulan en el buffer hasta que se sincroniza el
+ * grupo. El registro de la operacion en curso empieza en inicio_actual
+ * y se descarta si la operacion falla. Mientras esta abierto no se
+ * anota otro, para que uno anidado no lo pise ni se vuelque a medias.
+ */
+struct hash_wal{
+    int fd;
+    char* ruta_log;
+    char* ruta_imagen;
+    char* ruta_temporal;
+    hash_serializador_t serializador;
+    size_t grupo;
+    size_t pendientes;
+    char* buffer;
+    size_t largo;
+    size_t capacidad;
+    size_t inicio_actual;
+    bool abierto;
+    bool fallado;
+};
+
+static char* concatenar(const char* ruta, const char* extension){
+    char* resultado = malloc(strlen(ruta) + strlen(extension) + 1);
+    if(!resultado)
+        return NULL;
+    strcpy(resultado, ruta);
+    strcat(resultado, extension);
+    return resultado;
+}
+
+static int escribir_todo(int fd, const void* datos, size_t tamanio){
+    const char* actual = datos;
+    while(tamanio > 0){
+        ssize_t escritos = write(fd, actual, tamanio);
+        if(escritos <= 0)
+            return ERROR;
+        actual += escritos;
+        tamanio -= (size_t)escritos;
+    }
+    return EXITO;
+}
+
+/*
+ * Sincroniza el directorio de la ruta para que quede en disco el
+ * renombre de la imagen. Hay sistemas de archivos que no dejan
+ * sincronizar directorios; ahi el renombre queda como lo deje el
+ * sistema.
+ */
+static void sincronizar_directorio(const char* ruta){
+    const char* barra = strrchr(ruta, '/');
+    char* directorio = NULL;
+    if(barra){
+        size_t largo = barra == ruta ? 1 : (size_t)(barra - ruta);
+        directorio = malloc(largo + 1);
+        if(!directorio)
+            return;
+        memcpy(directorio, ruta, largo);
+        directorio[largo] = '\0';
+    }
+    int fd = open(directorio ? directorio : ".", O_RDONLY);
+    free(directorio);
+    if(fd < 0)
+        return;
+    fsync(fd);
+    close(fd);
+}
+
+static void destruir_wal(hash_wal_t* wal){
+    if(wal->fd >= 0)
+        close(wal->fd);
+    free(wal->ruta_log);
+    free(wal->ruta_imagen);
+    free(wal->ruta_temporal);
+    free(wal->buffer);
+    free(wal);
+}
+
+/*
+ * Escribe en el log los registros del buffer y, si sincronizar, espera
+ * a que esten en disco. Un error deja el log fallado.
+ */
+static int volcar(hash_wal_t* wal, bool sincronizar){
+    if(wal->fallado)
+        return ERROR;
+    if(escribir_todo(wal->fd, wal->buffer, wal->largo) == ERROR || (sincronizar && fdatasync(wal->fd) == ERROR)){
+        wal->fallado = true;
+        return ERROR;
+    }
+    wal->largo = VACIO;
+    wal->inicio_actual = VACIO;
+    if(sincronizar)
+        wal->pendientes = VACIO;
+    return EXITO;
+}
+
+/*
+ * Agrega al buffer un registro con la clave y el valor dados.
+ */
+static int anotar(hash_wal_t* wal, tipo_registro_t tipo, const char* clave, const void* valor, size_t largo_valor){
+    if(wal->fallado || wal->abierto)
+        return ERROR;
+    size_t largo_clave = strlen(clave);
+    if(largo_clave > UINT32_MAX)
+        return ERROR;
+    size_t tamanio = sizeof(registro_t) + largo_clave + largo_valor;
+    if(wal->largo + tamanio > wal->capacidad){
+        size_t capacidad = wal->capacidad ? wal->capacidad : CAPACIDAD_BUFFER;
+        while(capacidad < wal->largo + tamanio)
+            capacidad *= 2;
+        char* buffer = realloc(wal->buffer, capacidad);
+        if(!buffer)
+            return ERROR;
+        wal->buffer = buffer;
+        wal->capacidad = capacidad;
+    }
+    registro_t registro = {0, largo_valor, (uint32_t)largo_clave, tipo};
+    char* inicio = wal->buffer + wal->largo;
+    memcpy(inicio + sizeof(registro_t), clave, largo_clave);
+    if(largo_valor)
+        memcpy(inicio + sizeof(registro_t) + largo_clave, valor, largo_valor);
+    memcpy(inicio, &registro, sizeof(registro_t));
+    registro.suma = hash_fnv1a(inicio + sizeof(registro.suma), tamanio - sizeof(registro.suma), SEMILLA);
+    memcpy(inicio, &registro.suma, sizeof(registro.suma));
+    wal->inicio_actual = wal->largo;
+    wal->largo += tamanio;
+    wal->abierto = true;
+    return EXITO;
+}
+
+int hash_wal_anotar_insercion(hash_t* hash, const char* clave, void* elemento){
+    hash_wal_t* wal = hash->wal;
+    size_t largo_valor = VACIO;
+    const void* valor = wal->serializador ? wal->serializador(elemento, &largo_valor) : NULL;
+    return anotar(wal, REGISTRO_INSERTAR, clave, valor, valor ? largo_valor : VACIO);
+}
+
+int hash_wal_anotar_quitado(hash_t* hash, const char* clave){
+    return anotar(hash->wal, REGISTRO_QUITAR, clave, NULL, VACIO);
+}
+
+void hash_wal_terminar(hash_t* hash, bool aplicada){
+    hash_wal_t* wal = hash->wal;
+    wal->abierto = false;
+    if(!aplicada){
+        wal->largo = wal->inicio_actual;
+        return;
+    }
+    wal->pendientes++;
+    if(wal->grupo && wal->pendientes >= wal->grupo)
+        volcar(wal, true);
+    else if(wal->largo >= MAX_BUFFER)
+        volcar(wal, false);
+}
+
+void hash_wal_cerrar(hash_t* hash){
+    if(!hash->wal)
+        return;
+    volcar(hash->wal, true);
+    destruir_wal(hash->wal);
+    hash->wal = NULL;
+}
+
+int hash_wal_sincronizar(hash_t* hash){
+    if(!hash || !hash->wal)
+        return ERROR;
+    return volcar(hash->wal, true);
+}
+
+/*
+ * Guarda la imagen del hash en la ruta temporal y la pone en lugar de
+ * la imagen anterior.
+ */
+static int guardar_imagen(hash_t* hash, hash_wal_t* wal){
+    int fd = open(wal->ruta_temporal, O_WRONLY | O_CREAT | O_TRUNC, PERMISOS);
+    if(fd < 0)
+        return ERROR;
+    int retorno = hash_guardar(hash, fd, wal->serializador);
+    if(retorno == EXITO)
+        retorno = fdatasync(fd);
+    close(fd);
+    if(retorno == EXITO)
+        retorno = rename(wal->ruta_temporal, wal->ruta_imagen);
+    if(retorno != EXITO){
+        unlink(wal->ruta_temporal);
+        return ERROR;
+    }
+    sincronizar_directorio(wal->ruta_imagen);
+    return EXITO;
+}
+
+int hash_wal_checkpoint(hash_t* hash){
+    if(!hash || !hash->wal)
+        return ERROR;
+    hash_wal_t* wal = hash->wal;
+    if(guardar_imagen(hash, wal) == ERROR)
+        return ERROR;
+    wal->largo = wal->inicio_actual = wal->pendientes = VACIO;
+    if(ftruncate(wal->fd, 0) == ERROR || escribir_todo(wal->fd, MAGIA, LARGO_MAGIA) == ERROR || fdatasync(wal->fd) == ERROR){
+        wal->fallado = true;
+        return ERROR;
+    }
+    wal->fallado = false;
+    return EXITO;
+}
+
+int hash_activar_wal(hash_t* hash, const char* ruta, hash_serializador_t serializador, size_t grupo){
+    if(!hash || !ruta || hash->wal || hash->multiples)
+        return ERROR;
+    hash_wal_t* wal = calloc(1, sizeof(hash_wal_t));
+    if(!wal)
+        return ERROR;
+    wal->fd = ERROR;
+    wal->ruta_log = concatenar(ruta, EXTENSION_LOG);
+    wal->ruta_imagen = concatenar(ruta, EXTENSION_IMAGEN);
+    wal->ruta_temporal = concatenar(ruta, EXTENSION_TEMPORAL);
+    if(wal->ruta_log && wal->ruta_imagen && wal->ruta_temporal)
+        wal->fd = open(wal->ruta_log, O_WRONLY | O_CREAT | O_APPEND, PERMISOS);
+    if(wal->fd < 0){
+        destruir_wal(wal);
+        return ERROR;
+    }
+    wal->serializador = serializador;
+    wal->grupo = grupo;
+    hash->wal = wal;
+    if(hash_wal_checkpoint(hash) == ERROR){
+        hash->wal = NULL;
+        destruir_wal(wal);
+        return ERROR;
+    }
+    return EXITO;
+}
+
+/* ---------------------------------------------------------------- */
+/* Recuperacion                                                     */
+/* ---------------------------------------------------------------- */
+
+typedef struct carga{
+    hash_t* hash;
+    hash_deserializador_t deserializador;
+    bool fallo;
+}carga_t;
+
+static void* deserializar(carga_t* carga, const void* valor, size_t tamanio){
+    if(!carga->deserializador || !tamanio)
+        return NULL;
+    return carga->deserializador(valor, tamanio);
+}
+
+/*
+ * Inserta en el hash la clave con su elemento reconstruido. Si no puede
+ * destruye el elemento y marca la carga como fallada.
+ */
+static void cargar(carga_t* carga, const char* clave, const void* valor, size_t tamanio){
+    void* elemento = deserializar(carga, valor, tamanio);
+    if((tamanio && carga->deserializador && !elemento) || hash_insertar(carga->hash, clave, elemento) == ERROR){
+        if(elemento && carga->hash->destructor)
+            carga->hash->destructor(elemento);
+        carga->fallo = true;
+    }
+}
+
+static bool cargar_de_imagen(const char* clave, const void* valor, size_t tamanio, void* aux){
+    carga_t* carga = aux;
+    cargar(carga, clave, valor, tamanio);
+    return carga->fallo;
+}
+
+/*
+ * Crea el hash con el contenido de la imagen, si existe.
+ */
+static hash_t* cargar_imagen(const char* ruta, carga_t* carga, hash_destruir_dato_t destruir_elemento){
+    bool existe = access(ruta, F_OK) == EXITO;
+    hash_mapeado_t* mapa = existe ? hash_cargar_mmap(ruta) : NULL;
+    if(existe && !mapa)
+        return NULL;
+    size_t cantidad = hash_mapeado_cantidad(mapa);
+    carga->hash = hash_crear(destruir_elemento, cantidad > CAPACIDAD_MIN ? cantidad * 2 : CAPACIDAD_MIN);
+    if(carga->hash && mapa)
+        hash_mapeado_con_cada_clave(mapa, cargar_de_imagen, carga);
+    hash_mapeado_cerrar(mapa);
+    if(carga->hash && carga->fallo){
+        hash_destruir(carga->hash);
+        carga->hash = NULL;
+    }
+    return carga->hash;
+}
+
+/*
+ * Aplica el registro que empieza en la posicion dada del log y devuelve
+ * su tamanio, o 0 si el registro esta incompleto o no es valido, en
+ * cuyo caso ahi termina el log.
+ */
+static size_t aplicar_registro(carga_t* carga, const char* log, size_t largo, size_t posicion, char** clave, size_t* capacidad_clave){
+    registro_t registro;
+    if(largo - posicion < sizeof(registro_t))
+        return VACIO;
+    memcpy(&registro, log + posicion, sizeof(registro_t));
+    size_t disponible = largo - posicion - sizeof(registro_t);
+    if(registro.largo_clave > disponible || registro.largo_valor > disponible - registro.largo_clave)
+        return VACIO;
+    size_t tamanio = sizeof(registro_t) + registro.largo_clave + (size_t)registro.largo_valor;
+    if(hash_fnv1a(log + posicion + sizeof(registro.suma), tamanio - sizeof(registro.suma), SEMILLA) != registro.suma)
+        return VACIO;
+    if(registro.tipo != REGISTRO_INSERTAR && registro.tipo != REGISTRO_QUITAR)
+        return VACIO;
+    if(registro.largo_clave + 1 > *capacidad_clave){
+        char* nueva = realloc(*clave, registro.largo_clave + 1);
+        if(!nueva){
+            carga->fallo = true;
+            return VACIO;
+        }
+        *clave = nueva;
+        *capacidad_clave = registro.largo_clave + 1;
+    }
+    memcpy(*clave, log + posicion + sizeof(registro_t), registro.largo_clave);
+    (*clave)[registro.largo_clave] = '\0';
+    if(registro.tipo == REGISTRO_QUITAR)
+        hash_quitar(carga->hash, *clave);
+    else
+        cargar(carga, *clave, log + posicion + sizeof(registro_t) + registro.largo_clave, (size_t)registro.largo_valor);
+    return carga->fallo ? VACIO : tamanio;
+}
+
+/*
+ * Reaplica sobre el hash los registros del log, si existe, hasta el
+ * primero incompleto.
+ */
+static int reaplicar_log(const char* ruta, carga_t* carga){
+    int fd = open(ruta, O_RDONLY);
+    if(fd < 0)
+        return access(ruta, F_OK) == EXITO ? ERROR : EXITO;
+    struct stat estado;
+    if(fstat(fd, &estado) == ERROR){
+        close(fd);
+        return ERROR;
+    }
+    size_t largo = (size_t)estado.st_size;
+    if(largo < LARGO_MAGIA){
+        close(fd);
+        return EXITO;
+    }
+    const char* log = mmap(NULL, largo, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(log == MAP_FAILED)
+        return ERROR;
+    if(memcmp(log, MAGIA, LARGO_MAGIA) != IGUAL){
+        munmap((void*)log, largo);
+        return ERROR;
+    }
+    char* clave = NULL;
+    size_t capacidad_clave = VACIO;
+    size_t posicion = LARGO_MAGIA, tamanio = VACIO;
+    while((tamanio = aplicar_registro(carga, log, largo, posicion, &clave, &capacidad_clave)) != VACIO)
+        posicion += tamanio;
+    free(clave);
+    munmap((void*)log, largo);
+    return carga->fallo ? ERROR : EXITO;
+}
+
+hash_t* hash_recuperar(const char* ruta, hash_destruir_dato_t destruir_elemento, hash_deserializador_t deserializador){
+    if(!ruta)
+        return NULL;
+    char* ruta_imagen = concatenar(ruta, EXTENSION_IMAGEN);
+    char* ruta_log = concatenar(ruta, EXTENSION_LOG);
+    carga_t carga = {NULL, deserializador, false};
+    if(ruta_imagen && ruta_log && cargar_imagen(ruta_imagen, &carga, destruir_elemento) && reaplicar_log(ruta_log, &carga) == ERROR){
+        hash_destruir(carga.hash);
+        carga.hash = NULL;
+    }
+    free(ruta_imagen);
+    free(ruta_log);
+    return carga.hash;
+}
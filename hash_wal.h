@@ -0,0 +1,85 @@
+#ifndef __HASH_WAL_H__
+#define __HASH_WAL_H__
+
+#include <stddef.h>
+#include "hash.h"
+#include "hash_persistencia.h"
+
+/*
+ * Log de escritura anticipada (WAL) para que un hash sobreviva a una
+ * caida del proceso sin reconstruirlo desde otra fuente.
+ *
+ * Con el log activo, cada hash_insertar y hash_quitar que modifica el
+ * hash agrega un registro a <ruta>.log. Los registros se juntan en
+ * memoria y se escriben con un solo fsync por grupo de operaciones, asi
+ * que una operacion es durable recien cuando se sincroniza su grupo. Un
+ * checkpoint guarda una imagen del hash en <ruta>.img con el formato de
+ * hash_guardar y vacia el log.
+ *
+ * Para recuperar el hash se carga la ultima imagen y se reaplica el log
+ * encima. Reaplicar es idempotente (cada registro deja la clave con un
+ * valor o sin ella), por lo que si el proceso cae entre que se guarda la
+ * imagen y se vacia el log el resultado es el mismo. Un registro
+ * escrito a medias al final del log se descarta.
+ *
+ * Los vencimientos no se registran: las claves se recuperan sin
+ * vencimiento.
+ */
+
+/*
+ * Reconstruye un elemento a partir de los bytes que devolvio el
+ * serializador. Devuelve el elemento o NULL en caso de error.
+ */
+typedef void* (*hash_deserializador_t)(const void* datos, size_t tamanio);
+
+/*
+ * Activa el log del hash en la ruta dada, con el serializador para
+ * escribir los elementos (si es NULL se registran solo las claves). Al
+ * activarlo se hace un checkpoint, asi que la imagen y el log quedan
+ * con el contenido actual del hash y se pisa lo que hubiera en la ruta.
+ *
+ * grupo es la cantidad de operaciones que se sincronizan juntas; con 1
+ * cada operacion es durable al volver y con 0 solo se sincroniza con
+ * hash_wal_sincronizar o al hacer un checkpoint.
+ *
+ * Mientras el log este activo no se pueden agregar valores con
+ * hash_agregar ni fusionar el hash. hash_destruir sincroniza lo
+ * pendiente y cierra el log.
+ *
+ * Devuelve 0 si pudo activarlo o -1 si no pudo (o si ya estaba activo).
+ */
+int hash_activar_wal(hash_t* hash, const char* ruta, hash_serializador_t serializador, size_t grupo);
+
+/*
+ * Escribe y sincroniza las operaciones pendientes del log.
+ *
+ * Devuelve 0 si quedaron en disco o -1 si no pudo. Despues de un error
+ * de escritura el log deja de aceptar operaciones (las modificaciones
+ * del hash fallan) hasta el proximo checkpoint exitoso.
+ */
+int hash_wal_sincronizar(hash_t* hash);
+
+/*
+ * Guarda una imagen del hash, la reemplaza atomicamente por la anterior
+ * y vacia el log. Acota el largo del log y el tiempo de recuperacion.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso siguen valiendo la
+ * imagen y el log anteriores.
+ */
+int hash_wal_checkpoint(hash_t* hash);
+
+/*
+ * Crea un hash con el contenido de la ultima imagen de la ruta y las
+ * operaciones del log. Los elementos se reconstruyen con el
+ * deserializador; los valores vacios y todos si el deserializador es
+ * NULL se recuperan como NULL. Si no hay imagen ni log devuelve un hash
+ * vacio.
+ *
+ * El hash recuperado no tiene el log activo: para seguir registrando
+ * operaciones se activa de nuevo sobre la misma ruta.
+ *
+ * Devuelve el hash o NULL en caso de error.
+ */
+hash_t* hash_recuperar(const char* ruta, hash_destruir_dato_t destruir_elemento, hash_deserializador_t deserializador);
+
+#endif /* __HASH_WAL_H__ */
@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "indice.h"
+
+#define ERROR -1
+#define EXITO 0
+#define IGUAL 0
+#define VACIO 0
+#define MARCA_NODO 1
+
+/*
+ * Nodo interno del arbol. byte es la posicion del primer byte en que
+ * difieren las claves de sus dos hijos y otros_bits tiene en 1 todos los
+ * bits salvo el que las separa. Los hijos son datos o nodos internos
+ * marcados con MARCA_NODO en el bit mas bajo del puntero.
+ */
+typedef struct nodo{
+    void* hijos[2];
+    size_t byte;
+    uint8_t otros_bits;
+}nodo_t;
+
+struct indice{
+    void* raiz;
+    size_t cantidad;
+    indice_clave_t clave_de;
+};
+
+typedef struct recorrido{
+    bool (*funcion)(void* dato, void* aux);
+    void* aux;
+    size_t cantidad;
+}recorrido_t;
+
+static bool es_nodo(void* hijo){
+    return (uintptr_t)hijo & MARCA_NODO;
+}
+
+static nodo_t* nodo_de(void* hijo){
+    return (nodo_t*)((uintptr_t)hijo - MARCA_NODO);
+}
+
+/*
+ * Devuelve hacia que hijo del nodo va la clave de largo dado: 1 si
+ * tiene prendido el bit critico y 0 si no (o si es mas corta).
+ */
+static int direccion(nodo_t* nodo, const char* clave, size_t largo){
+    uint8_t c = nodo->byte < largo ? (uint8_t)clave[nodo->byte] : 0;
+    return (1 + (nodo->otros_bits | c)) >> 8;
+}
+
+indice_t* indice_crear(indice_clave_t clave_de){
+    if(!clave_de)
+        return NULL;
+    indice_t* indice = calloc(1, sizeof(indice_t));
+    if(!indice)
+        return NULL;
+    indice->clave_de = clave_de;
+    return indice;
+}
+
+//Devuelve el dato cuya clave comparte mas bits iniciales con la dada
+static void* mas_parecido(indice_t* indice, const char* clave, size_t largo){
+    void* actual = indice->raiz;
+    while(es_nodo(actual)){
+        nodo_t* nodo = nodo_de(actual);
+        actual = nodo->hijos[direccion(nodo, clave, largo)];
+    }
+    return actual;
+}
+
+int indice_agregar(indice_t* indice, void* dato){
+    if(!indice || !dato || es_nodo(dato))
+        return ERROR;
+    if(!indice->raiz){
+        indice->raiz = dato;
+        indice->cantidad++;
+        return EXITO;
+    }
+    const char* clave = indice->clave_de(dato);
+    size_t largo = strlen(clave);
+    const uint8_t* parecida = (const uint8_t*)indice->clave_de(mas_parecido(indice, clave, largo));
+    size_t byte = 0;
+    while(byte < largo && parecida[byte] == (uint8_t)clave[byte])
+        byte++;
+    uint32_t diferencia = parecida[byte] ^ (uint8_t)(byte < largo ? clave[byte] : 0);
+    if(!diferencia)
+        return ERROR;
+    while(diferencia & (diferencia - 1))
+        diferencia &= diferencia - 1;
+    nodo_t* nuevo = malloc(sizeof(nodo_t));
+    if(!nuevo)
+        return ERROR;
+    nuevo->byte = byte;
+    nuevo->otros_bits = (uint8_t)(diferencia ^ 0xff);
+    int lado = direccion(nuevo, clave, largo);
+    nuevo->hijos[lado] = dato;
+    void** lugar = &indice->raiz;
+    while(es_nodo(*lugar)){
+        nodo_t* nodo = nodo_de(*lugar);
+        if(nodo->byte > byte || (nodo->byte == byte && nodo->otros_bits > nuevo->otros_bits))
+            break;
+        lugar = &nodo->hijos[direccion(nodo, clave, largo)];
+    }
+    nuevo->hijos[1 - lado] = *lugar;
+    *lugar = (void*)((uintptr_t)nuevo + MARCA_NODO);
+    indice->cantidad++;
+    return EXITO;
+}
+
+void indice_quitar(indice_t* indice, const char* clave){
+    if(!indice || !clave || !indice->raiz)
+        return;
+    size_t largo = strlen(clave);
+    void** lugar = &indice->raiz;
+    void** lugar_padre = NULL;
+    nodo_t* padre = NULL;
+    int lado = 0;
+    while(es_nodo(*lugar)){
+        lugar_padre = lugar;
+        padre = nodo_de(*lugar);
+        lado = direccion(padre, clave, largo);
+        lugar = &padre->hijos[lado];
+    }
+    if(strcmp(indice->clave_de(*lugar), clave) != IGUAL)
+        return;
+    if(!padre)
+        indice->raiz = NULL;
+    else{
+        *lugar_padre = padre->hijos[1 - lado];
+        free(padre);
+    }
+    indice->cantidad--;
+}
+
+void indice_reemplazar(indice_t* indice, void* dato){
+    if(!indice || !dato || es_nodo(dato) || !indice->raiz)
+        return;
+    const char* clave = indice->clave_de(dato);
+    size_t largo = strlen(clave);
+    void** lugar = &indice->raiz;
+    while(es_nodo(*lugar)){
+        nodo_t* nodo = nodo_de(*lugar);
+        lugar = &nodo->hijos[direccion(nodo, clave, largo)];
+    }
+    if(strcmp(indice->clave_de(*lugar), clave) == IGUAL)
+        *lugar = dato;
+}
+
+size_t indice_cantidad(indice_t* indice){
+    if(!indice)
+        return VACIO;
+    return indice->cantidad;
+}
+
+size_t indice_bytes(indice_t* indice){
+    if(!indice)
+        return VACIO;
+    size_t nodos = indice->cantidad ? indice->cantidad - 1 : 0;
+    return sizeof(indice_t) + nodos * sizeof(nodo_t);
+}
+
+/*
+ * Recorre en orden el subarbol. Devuelve true si la funcion pidio
+ * cortar el recorrido.
+ */
+static bool recorrer(void* actual, recorrido_t* recorrido){
+    if(es_nodo(actual)){
+        nodo_t* nodo = nodo_de(actual);
+        return recorrer(nodo->hijos[0], recorrido) || recorrer(nodo->hijos[1], recorrido);
+    }
+    recorrido->cantidad++;
+    return recorrido->funcion(actual, recorrido->aux);
+}
+
+size_t indice_con_cada_prefijo(indice_t* indice, const char* prefijo, bool (*funcion)(void* dato, void* aux), void* aux){
+    if(!indice || !prefijo || !funcion || !indice->raiz)
+        return VACIO;
+    size_t largo = strlen(prefijo);
+    void* actual = indice->raiz;
+    void* subarbol = actual;
+    while(es_nodo(actual)){
+        nodo_t* nodo = nodo_de(actual);
+        actual = nodo->hijos[direccion(nodo, prefijo, largo)];
+        if(nodo->byte < largo)
+            subarbol = actual;
+    }
+    if(strncmp(indice->clave_de(actual), prefijo, largo) != IGUAL)
+        return VACIO;
+    recorrido_t recorrido = {funcion, aux, VACIO};
+    recorrer(subarbol, &recorrido);
+    return recorrido.cantidad;
+}
+
+//Devuelve el dato de menor (lado 0) o mayor (lado 1) clave del subarbol
+static void* extremo(void* actual, int lado){
+    while(es_nodo(actual))
+        actual = nodo_de(actual)->hijos[lado];
+    return actual;
+}
+
+/*
+ * Recorre en orden los datos del subarbol que estan en el rango. Un
+ * limite que ya cubre todo el subarbol se deja de comparar en sus
+ * descendientes, asi que solo los caminos de los bordes del rango
+ * buscan los extremos. Devuelve true si hay que cortar el recorrido.
+ */
+static bool recorrer_rango(indice_t* indice, void* actual, const char* desde, const char* hasta, recorrido_t* recorrido){
+    if(desde){
+        if(strcmp(indice->clave_de(extremo(actual, 1)), desde) < 0)
+            return false;
+        if(strcmp(indice->clave_de(extremo(actual, 0)), desde) >= 0)
+            desde = NULL;
+    }
+    if(hasta){
+        if(strcmp(indice->clave_de(extremo(actual, 0)), hasta) >= 0)
+            return true;
+        if(strcmp(indice->clave_de(extremo(actual, 1)), hasta) < 0)
+            hasta = NULL;
+    }
+    if(!desde && !hasta)
+        return recorrer(actual, recorrido);
+    nodo_t* nodo = nodo_de(actual);
+    return recorrer_rango(indice, nodo->hijos[0], desde, hasta, recorrido) || recorrer_rango(indice, nodo->hijos[1], desde, hasta, recorrido);
+}
+
+size_t indice_con_cada_en_rango(indice_t* indice, const char* desde, const char* hasta, bool (*funcion)(void* dato, void* aux), void* aux){
+    if(!indice || !funcion || !indice->raiz)
+        return VACIO;
+    recorrido_t recorrido = {funcion, aux, VACIO};
+    recorrer_rango(indice, indice->raiz, desde, hasta, &recorrido);
+    return recorrido.cantidad;
+}
+
+//Libera los nodos internos del subarbol
+static void liberar_nodos(void* actual){
+    if(!es_nodo(actual))
+        return;
+    nodo_t* nodo = nodo_de(actual);
+    liberar_nodos(nodo->hijos[0]);
+    liberar_nodos(nodo->hijos[1]);
+    free(nodo);
+}
+
+void indice_destruir(indice_t* indice){
+    if(!indice)
+        return;
+    liberar_nodos(indice->raiz);
+    free(indice);
+}
@@ -0,0 +1,85 @@
+#ifndef __INDICE_H__
+#define __INDICE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Indice ordenado (arbol crit-bit) sobre datos que ya guardan su clave.
+ * El indice no copia las claves: guarda punteros a los datos y obtiene
+ * la clave de cada uno con la funcion que recibe al crearse, asi que la
+ * clave de un dato no debe cambiar mientras este en el indice.
+ *
+ * Cada nodo interno separa las claves por el primer bit en que
+ * difieren, por lo que la altura depende del largo de las claves y no
+ * de su cantidad, y las claves con un prefijo comun forman un subarbol.
+ * Las claves se recorren en el orden de strcmp.
+ */
+typedef struct indice indice_t;
+
+/*
+ * Devuelve la clave del dato.
+ */
+typedef const char* (*indice_clave_t)(void* dato);
+
+/*
+ * Crea un indice vacio que obtiene la clave de cada dato con la funcion
+ * dada. Los datos tienen que estar alineados al menos a 2 bytes.
+ *
+ * Devuelve el indice creado o NULL en caso de error.
+ */
+indice_t* indice_crear(indice_clave_t clave_de);
+
+/*
+ * Agrega el dato al indice. Su clave no puede estar ya en el indice.
+ *
+ * Devuelve 0 si pudo agregarlo o -1 si no pudo.
+ */
+int indice_agregar(indice_t* indice, void* dato);
+
+/*
+ * Quita del indice el dato con la clave dada. No hace nada si la clave
+ * no esta.
+ */
+void indice_quitar(indice_t* indice, const char* clave);
+
+/*
+ * Pone el dato en el lugar del que tiene su misma clave. No hace nada
+ * si la clave no esta.
+ */
+void indice_reemplazar(indice_t* indice, void* dato);
+
+/*
+ * Devuelve la cantidad de datos del indice o 0 en caso de error.
+ */
+size_t indice_cantidad(indice_t* indice);
+
+/*
+ * Devuelve los bytes que ocupan los nodos del indice o 0 en caso de
+ * error.
+ */
+size_t indice_bytes(indice_t* indice);
+
+/*
+ * Recorre en orden los datos cuya clave empieza con el prefijo,
+ * invocando a la funcion con cada uno hasta que devuelva true.
+ *
+ * Devuelve la cantidad de datos recorridos.
+ */
+size_t indice_con_cada_prefijo(indice_t* indice, const char* prefijo, bool (*funcion)(void* dato, void* aux), void* aux);
+
+/*
+ * Recorre en orden los datos cuya clave es mayor o igual que desde y
+ * menor que hasta, invocando a la funcion con cada uno hasta que
+ * devuelva true. Un limite NULL no limita.
+ *
+ * Devuelve la cantidad de datos recorridos.
+ */
+size_t indice_con_cada_en_rango(indice_t* indice, const char* desde, const char* hasta, bool (*funcion)(void* dato, void* aux), void* aux);
+
+/*
+ * Libera el indice. Los datos no se liberan.
+ */
+void indice_destruir(indice_t* indice);
+
+#endif /* __INDICE_H__ */
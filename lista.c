@@ -291,6 +291,17 @@ void* lista_primero(lista_t* lista){
   return (void*)(lista->inicio->dato);
 }
 
+size_t lista_tamanio_estructura(){
+  return sizeof(lista_t);
+}
+
+size_t lista_tamanio_nodos(lista_t* lista){
+  if(!lista){
+    return 0;
+  }
+  return (size_t)(lista->cantidad) * sizeof(nodo_t);
+}
+
 void destruir_nodos(nodo_t* borrado, int cantidad){
   nodo_t* auxiliar;
   for(int i = 0; i < cantidad; i++){
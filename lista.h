@@ -104,6 +104,18 @@ int lista_desencolar(lista_t* lista);
  */
 void* lista_primero(lista_t* lista);
 
+/*
+ * Devuelve la cantidad de bytes que ocupa la estructura de una lista,
+ * sin contar sus nodos ni sus elementos.
+ */
+size_t lista_tamanio_estructura();
+
+/*
+ * Devuelve la cantidad de bytes que ocupan los nodos de la lista, sin
+ * contar los elementos que guardan.
+ */
+size_t lista_tamanio_nodos(lista_t* lista);
+
 /*
  * Libera la memoria reservada por la lista.
  */
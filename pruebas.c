@@ -1,8 +1,34 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "hash.h"
 #include "hash_iterador.h"
+#include "hash_persistencia.h"
+#include "hash_congelado.h"
+#include "hash_filtro.h"
+#include "filtro.h"
+#include "hash_cache.h"
+#include "hash_ttl.h"
+#include "hash_estadisticas.h"
+#include "hash_traza.h"
+#include "hash_memoria.h"
+#include "hash_pool.h"
+#include "hash_claves.h"
+#include "hash_rh.h"
+#include "hash_cuckoo.h"
+#include "hash_simd.h"
+#include "hash_multi.h"
+#include "hash_ordenado.h"
+#include "hash_indice.h"
+#include "hash_conjuntos.h"
+#include "hash_snapshot.h"
+#include "hash_hamt.h"
+#include "hash_reserva.h"
+#include "reserva.h"
+#include "hash_wal.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #define ERROR -1
 #define EXITO 0
@@ -12,6 +38,9 @@
 #define RESET "\x1b[0m"
 #define VERDE "\x1b[1;32m"
 
+#define RUTA_IMAGEN "garage.img"
+#define RUTA_WAL "garage_wal"
+
 //strdup no lo podemos usar porque es POSIX pero no es C99
 char *duplicar_string(const char *s){
     if (!s)
@@ -201,9 +230,1119 @@ void pruebas_funcionamiento(){
     hash_destruir(garage);
 }
 
+const void* serializar_string(void* elemento, size_t* tamanio){
+    if (!elemento)
+        return NULL;
+    *tamanio = strlen(elemento) + 1;
+    return elemento;
+}
+
+bool contar_mapeadas(const char* clave, const void* valor, size_t tamanio, void* aux){
+    return false;
+}
+
+void pruebas_persistencia(){
+    printf("\nPruebo guardar el hash en disco y abrirlo con mmap\n");
+    hash_t* garage = hash_crear(destruir_string, 3);
+    guardar_vehiculo(garage, "AC123BD", "Auto de Mariano");
+    guardar_vehiculo(garage, "OPQ976", "Auto de Lucas");
+    guardar_vehiculo(garage, "A421ACB", "Moto de Manu");
+    printf("Guardo un vehiculo sin descripcion: %s\n", hash_insertar(garage, "SINVALOR", NULL) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    FILE* archivo = fopen(RUTA_IMAGEN, "wb");
+    int retorno = archivo ? hash_guardar(garage, fileno(archivo), serializar_string) : ERROR;
+    if (archivo)
+        fclose(archivo);
+    printf("Guardo la imagen del garage: %s\n", retorno == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    hash_mapeado_t* mapa = hash_cargar_mmap(RUTA_IMAGEN);
+    printf("Abro la imagen con mmap: %s\n", mapa != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("La imagen tiene la misma cantidad de claves: %s\n", hash_mapeado_cantidad(mapa) == hash_cantidad(garage) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    size_t tamanio = 0;
+    const char* valor = hash_mapeado_obtener(mapa, "OPQ976", &tamanio);
+    printf("Busco un vehiculo en la imagen: %s\n", (valor && strcmp(valor, "Auto de Lucas") == 0) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Un vehiculo sin descripcion tiene valor vacio: %s\n", (hash_mapeado_obtener(mapa, "SINVALOR", &tamanio) && tamanio == 0) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Busco un vehiculo que no esta en la imagen (FALLA): %s\n", hash_mapeado_contiene(mapa, "NOEXISTE") == false ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Abro una imagen que no existe (FALLA): %s\n", hash_cargar_mmap("no_existe.img") == NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    hash_mapeado_cerrar(mapa);
+
+    //Pisa el vector de posiciones, que esta al final, con desplazamientos fuera del archivo
+    archivo = fopen(RUTA_IMAGEN, "r+b");
+    if (archivo){
+        unsigned char basura[8 * 3 * sizeof(uint64_t)];
+        memset(basura, 0x7f, sizeof(basura));
+        fseek(archivo, -(long)sizeof(basura), SEEK_END);
+        fwrite(basura, 1, sizeof(basura), archivo);
+        fclose(archivo);
+    }
+    mapa = hash_cargar_mmap(RUTA_IMAGEN);
+    size_t leidas = hash_mapeado_con_cada_clave(mapa, contar_mapeadas, NULL);
+    printf("Ignoro las posiciones corruptas de la imagen: %s\n", mapa && leidas == 0 && !hash_mapeado_contiene(mapa, "OPQ976") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_mapeado_cerrar(mapa);
+    remove(RUTA_IMAGEN);
+    hash_destruir(garage);
+}
+
+void pruebas_congelado(){
+    printf("\nPruebo congelar el hash\n");
+    hash_t* garage = hash_crear(destruir_string, 3);
+    guardar_vehiculo(garage, "AC123BD", "Auto de Mariano");
+    guardar_vehiculo(garage, "OPQ976", "Auto de Lucas");
+    guardar_vehiculo(garage, "A421ACB", "Moto de Manu");
+    guardar_vehiculo(garage, "AA442CD", "Auto de Guido");
+    guardar_vehiculo(garage, "AC152AD", "Auto de Agustina");
+    guardar_vehiculo(garage, "DZE443", "Auto de Jonathan");
+
+    hash_congelado_t* congelado = hash_congelar(garage);
+    printf("Congelo el garage: %s\n", congelado != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El garage congelado tiene 6 autos: %s\n", hash_congelado_cantidad(congelado) == 6 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    const char* vehiculo = hash_congelado_obtener(congelado, "AA442CD");
+    printf("Busco un vehiculo en el garage congelado: %s\n", (vehiculo && strcmp(vehiculo, "Auto de Guido") == 0) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Verifico el vehiculo patente DZE443 congelado: %s\n", hash_congelado_contiene(congelado, "DZE443") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Busco un vehiculo que no esta en el garage congelado (FALLA): %s\n", hash_congelado_contiene(congelado, "NOEXISTE") == false ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Congelo un hash NULL (FALLA): %s\n", hash_congelar(NULL) == NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_congelado_destruir(congelado);
+}
+
+void pruebas_filtro(){
+    printf("\nPruebo el filtro de pertenencia\n");
+    hash_t* garage = hash_crear(destruir_string, 3);
+    printf("Activo el filtro en el garage: %s\n", hash_activar_filtro(garage, 10) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    guardar_vehiculo(garage, "AC123BD", "Auto de Mariano");
+    guardar_vehiculo(garage, "OPQ976", "Auto de Lucas");
+    guardar_vehiculo(garage, "A421ACB", "Moto de Manu");
+    guardar_vehiculo(garage, "AA442CD", "Auto de Guido");
+    guardar_vehiculo(garage, "AC152AD", "Auto de Agustina");
+    verificar_vehiculo(garage, "AC123BD", true);
+    verificar_vehiculo(garage, "AC152AD", true);
+    verificar_vehiculo(garage, "NOEXISTE", false);
+    quitar_vehiculo(garage, "OPQ976");
+    verificar_vehiculo(garage, "OPQ976", false);
+    verificar_vehiculo(garage, "A421ACB", true);
+
+    size_t tamanio = hash_exportar_filtro(garage, NULL, 0);
+    void* exportado = malloc(tamanio);
+    hash_exportar_filtro(garage, exportado, tamanio);
+    filtro_t* remoto = filtro_importar(exportado, tamanio);
+    printf("Importo el filtro exportado: %s\n", remoto != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El filtro importado reconoce una patente guardada: %s\n", filtro_puede_contener(remoto, "AA442CD") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Activo un filtro sin bits (FALLA): %s\n", hash_activar_filtro(garage, 0) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    filtro_destruir(remoto);
+    free(exportado);
+    hash_destruir(garage);
+}
+
+void pruebas_cache(){
+    printf("\nPruebo el hash como cache acotada\n");
+    hash_cache_t* cache = hash_cache_crear(destruir_string, 3, 0);
+    printf("Creo una cache de 3 vehiculos: %s\n", cache != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cache_insertar(cache, "AC123BD", duplicar_string("Auto de Mariano"), 1);
+    hash_cache_insertar(cache, "OPQ976", duplicar_string("Auto de Lucas"), 1);
+    hash_cache_insertar(cache, "A421ACB", duplicar_string("Moto de Manu"), 1);
+    printf("Uso el vehiculo mas antiguo: %s\n", hash_cache_obtener(cache, "AC123BD") != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cache_insertar(cache, "AA442CD", duplicar_string("Auto de Guido"), 1);
+    printf("Se desaloja el vehiculo usado hace mas tiempo: %s\n", !hash_cache_contiene(cache, "OPQ976") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El vehiculo usado recien sigue en la cache: %s\n", hash_cache_contiene(cache, "AC123BD") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Busco un vehiculo desalojado (FALLA): %s\n", hash_cache_obtener(cache, "OPQ976") == NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("La cache cuenta 1 acierto, 1 fallo y 1 desalojo: %s\n", (hash_cache_aciertos(cache) == 1 && hash_cache_fallos(cache) == 1 && hash_cache_desalojos(cache) == 1) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cache_insertar(cache, "A421ACB", duplicar_string("Moto de Lucas"), 1);
+    hash_cache_insertar(cache, "OPQ976", duplicar_string("Auto de Lucas"), 1);
+    printf("Reemplazar un vehiculo lo vuelve el mas reciente: %s\n", hash_cache_cantidad(cache) == 3 && hash_cache_bytes(cache) == 3 && hash_cache_contiene(cache, "A421ACB") && !hash_cache_contiene(cache, "AC123BD") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quito un vehiculo de la cache: %s\n", hash_cache_quitar(cache, "A421ACB") == EXITO && hash_cache_cantidad(cache) == 2 && hash_cache_bytes(cache) == 2 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quito un vehiculo que no esta (FALLA): %s\n", hash_cache_quitar(cache, "A421ACB") == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cache_destruir(cache);
+
+    hash_cache_t* por_bytes = hash_cache_crear(destruir_string, 0, 10);
+    printf("Inserto un vehiculo mas grande que la cache (FALLA): %s\n", hash_cache_insertar(por_bytes, "ZZ999ZZ", "Auto de Hector", 11) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cache_insertar(por_bytes, "FFV976", duplicar_string("Auto de Valentina"), 6);
+    hash_cache_insertar(por_bytes, "HSG098", duplicar_string("Auto de Macarena"), 6);
+    printf("La cache por bytes respeta el limite: %s\n", (hash_cache_bytes(por_bytes) == 6 && hash_cache_contiene(por_bytes, "HSG098")) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cache_destruir(por_bytes);
+}
+
+uint64_t tiempo_de_prueba = 0;
+
+uint64_t reloj_de_prueba(){
+    return tiempo_de_prueba;
+}
+
+void pruebas_ttl(){
+    printf("\nPruebo los vencimientos de las claves\n");
+    hash_t* garage = hash_crear(destruir_string, 3);
+    hash_establecer_reloj(garage, reloj_de_prueba);
+    printf("Guardo un vehiculo por 10 ms: %s\n", hash_insertar_con_ttl(garage, "AC123BD", duplicar_string("Auto de Mariano"), 10) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_insertar_con_ttl(garage, "OPQ976", duplicar_string("Auto de Lucas"), 100);
+    hash_insertar_con_ttl(garage, "A421ACB", duplicar_string("Moto de Manu"), 5000);
+    guardar_vehiculo(garage, "AA442CD", "Auto de Guido");
+    hash_insertar_con_ttl(garage, "AC152AD", duplicar_string("Auto de Agustina"), 10);
+    guardar_vehiculo(garage, "AC152AD", "Auto de Agustina sin vencimiento");
+
+    tiempo_de_prueba = 50;
+    verificar_vehiculo(garage, "AC123BD", false);
+    verificar_vehiculo(garage, "OPQ976", true);
+    verificar_vehiculo(garage, "AC152AD", true);
+
+    tiempo_de_prueba = 200;
+    printf("Expiro las claves vencidas: %s\n", hash_expirar(garage, 100) == 1 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quedan los vehiculos sin vencer: %s\n", hash_cantidad(garage) == 3 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    tiempo_de_prueba = 1000000;
+    printf("Expiro con presupuesto limitado: %s\n", hash_expirar(garage, 1) <= 1 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_expirar(garage, 100);
+    verificar_vehiculo(garage, "A421ACB", false);
+    verificar_vehiculo(garage, "AA442CD", true);
+    printf("Expiro en un hash NULL (FALLA): %s\n", hash_expirar(NULL, 10) == VACIO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    hash_insertar_con_ttl(garage, "DZE443", duplicar_string("Auto de Jonathan"), 10);
+    tiempo_de_prueba = 2000000;
+    FILE* archivo = fopen(RUTA_IMAGEN, "wb");
+    int retorno = archivo ? hash_guardar(garage, fileno(archivo), serializar_string) : ERROR;
+    if (archivo)
+        fclose(archivo);
+    hash_mapeado_t* mapa = hash_cargar_mmap(RUTA_IMAGEN);
+    printf("Guardo el garage sin el vehiculo vencido: %s\n", retorno == EXITO && hash_mapeado_cantidad(mapa) == 2 && !hash_mapeado_contiene(mapa, "DZE443") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_mapeado_cerrar(mapa);
+    remove(RUTA_IMAGEN);
+    hash_congelado_t* congelado = hash_congelar(garage);
+    printf("Congelo el garage sin el vehiculo vencido: %s\n", congelado && hash_congelado_cantidad(congelado) == 2 && !hash_congelado_obtener(congelado, "DZE443") && hash_congelado_obtener(congelado, "AA442CD") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_congelado_destruir(congelado);
+}
+
+void pruebas_estadisticas(){
+    printf("\nPruebo las estadisticas del hash\n");
+    hash_t* garage = hash_crear(destruir_string, 3);
+    hash_estadisticas_t estadisticas;
+    printf("Pido estadisticas de un hash NULL (FALLA): %s\n", hash_estadisticas(NULL, &estadisticas) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Pido estadisticas sin donde guardarlas (FALLA): %s\n", hash_estadisticas(garage, NULL) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    guardar_vehiculo(garage, "AC123BD", "Auto de Mariano");
+    guardar_vehiculo(garage, "OPQ976", "Auto de Lucas");
+    guardar_vehiculo(garage, "A421ACB", "Moto de Manu");
+    guardar_vehiculo(garage, "AA442CD", "Auto de Guido");
+    guardar_vehiculo(garage, "AC152AD", "Auto de Agustina");
+    hash_obtener(garage, "AC123BD");
+    hash_obtener(garage, "ZZ999ZZ");
+
+    printf("Pido las estadisticas del garage: %s\n", hash_estadisticas(garage, &estadisticas) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    size_t baldes = 0, elementos = 0;
+    for(size_t i = 0; i < HASH_COLUMNAS_HISTOGRAMA; i++){
+        baldes += estadisticas.histograma[i];
+        elementos += i * estadisticas.histograma[i];
+    }
+    printf("El histograma cubre todos los baldes: %s\n", (baldes == estadisticas.capacidad && estadisticas.histograma[0] == estadisticas.baldes_vacios) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El histograma cuenta todos los vehiculos: %s\n", (elementos == 5 && estadisticas.cantidad == 5) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El factor de carga es el real: %s\n", estadisticas.factor_carga == 5.0 / (double)estadisticas.capacidad ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El garage crecio con al menos un rehash: %s\n", (estadisticas.rehashes > 0 && estadisticas.capacidad > 3) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Las claves ocupan sus bytes: %s\n", estadisticas.bytes_claves == 8 + 7 + 8 + 8 + 8 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("La cadena maxima es al menos 1: %s\n", (estadisticas.cadena_maxima >= 1 && estadisticas.cadena_promedio >= 1.0) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+#ifdef HASH_CONTADORES
+    printf("Se cuentan las operaciones: %s\n", (estadisticas.contadores.inserciones == 5 && estadisticas.contadores.aciertos == 1 && estadisticas.contadores.fallos == 1) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+#else
+    printf("Sin contadores compilados quedan en 0: %s\n", estadisticas.contadores.inserciones == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+#endif
+    hash_destruir(garage);
+}
+
+typedef struct eventos{
+    size_t cantidad[HASH_TRAZA_SIN_MEMORIA + 1];
+    size_t capacidad_final;
+}eventos_t;
+
+void contar_evento(hash_t* hash, hash_evento_t evento, const char* clave, size_t dato, void* aux){
+    eventos_t* eventos = aux;
+    eventos->cantidad[evento]++;
+    if(evento == HASH_TRAZA_REHASH_FIN)
+        eventos->capacidad_final = dato;
+}
+
+void pruebas_trazas(){
+    printf("\nPruebo las trazas del hash\n");
+    hash_t* garage = hash_crear(destruir_string, 3);
+    eventos_t eventos = {{0}, 0};
+#ifdef HASH_TRAZAS
+    printf("Registro un trazador: %s\n", hash_establecer_trazador(garage, contar_evento, &eventos) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Registro un trazador en un hash NULL (FALLA): %s\n", hash_establecer_trazador(NULL, contar_evento, &eventos) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    guardar_vehiculo(garage, "AC123BD", "Auto de Mariano");
+    guardar_vehiculo(garage, "OPQ976", "Auto de Lucas");
+    guardar_vehiculo(garage, "A421ACB", "Moto de Manu");
+    guardar_vehiculo(garage, "AC123BD", "Auto de Mariano reemplazado");
+    char patente[10];
+    for(int i = 0; i < 20; i++){
+        sprintf(patente, "AB%03iCD", i);
+        hash_insertar(garage, patente, duplicar_string(patente));
+    }
+    hash_obtener(garage, "OPQ976");
+    hash_contiene(garage, "ZZ999ZZ");
+    hash_quitar(garage, "A421ACB");
+    hash_quitar(garage, "A421ACB");
+    printf("Se trazan las inserciones: %s\n", eventos.cantidad[HASH_TRAZA_INSERTAR] == 24 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Se trazan las busquedas: %s\n", eventos.cantidad[HASH_TRAZA_BUSCAR] == 2 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Se trazan los quitados: %s\n", eventos.cantidad[HASH_TRAZA_QUITAR] == 2 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Cada rehash tiene inicio y fin: %s\n", (eventos.cantidad[HASH_TRAZA_REHASH_INICIO] > 0 && eventos.cantidad[HASH_TRAZA_REHASH_INICIO] == eventos.cantidad[HASH_TRAZA_REHASH_FIN]) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_estadisticas_t estadisticas;
+    hash_estadisticas(garage, &estadisticas);
+    printf("El fin del rehash informa la capacidad nueva: %s\n", eventos.capacidad_final == estadisticas.capacidad ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_establecer_trazador(garage, NULL, NULL);
+    guardar_vehiculo(garage, "AA442CD", "Auto de Guido");
+    printf("Sin trazador no se trazan eventos: %s\n", eventos.cantidad[HASH_TRAZA_INSERTAR] == 24 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+#else
+    printf("Sin trazas compiladas no se puede registrar un trazador (FALLA): %s\n", hash_establecer_trazador(garage, contar_evento, &eventos) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+#endif
+    hash_destruir(garage);
+}
+
+void pruebas_memoria(){
+    printf("\nPruebo la memoria y la compactacion del hash\n");
+    hash_t* garage = hash_crear(destruir_string, 3);
+    hash_memoria_t memoria;
+    printf("Pido la memoria de un hash NULL (FALLA): %s\n", hash_memoria(NULL, &memoria) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Compacto un hash NULL (FALLA): %s\n", hash_compactar(NULL) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    char patente[10];
+    for(int i = 0; i < 1000; i++){
+        sprintf(patente, "AB%03iCD", i);
+        hash_insertar(garage, patente, duplicar_string(patente));
+    }
+    hash_memoria(garage, &memoria);
+    size_t pico = memoria.total;
+    printf("Las claves ocupan sus bytes: %s\n", memoria.claves == 1000 * 8 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El total suma todas las categorias: %s\n", memoria.total == memoria.vector + memoria.listas + memoria.nodos + memoria.entradas + memoria.claves + memoria.valores + memoria.indice ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    for(int i = 10; i < 1000; i++){
+        sprintf(patente, "AB%03iCD", i);
+        hash_quitar(garage, patente);
+    }
+    hash_memoria_t despues_de_quitar;
+    hash_memoria(garage, &despues_de_quitar);
+    printf("Quitar libera las listas vacias: %s\n", despues_de_quitar.listas < memoria.listas ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Compacto el garage: %s\n", hash_compactar(garage) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_memoria(garage, &memoria);
+    printf("El vector se achica: %s\n", memoria.vector < despues_de_quitar.vector && memoria.total < pico ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    bool todos = hash_cantidad(garage) == 10;
+    for(int i = 0; i < 10; i++){
+        sprintf(patente, "AB%03iCD", i);
+        char* guardado = hash_obtener(garage, patente);
+        todos = todos && guardado && strcmp(guardado, patente) == 0;
+    }
+    printf("Siguen todos los vehiculos: %s\n", todos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    guardar_vehiculo(garage, "AC123BD", "Auto de Mariano");
+    verificar_vehiculo(garage, "AC123BD", true);
+    hash_destruir(garage);
+}
+
+void pruebas_pool(){
+    printf("\nPruebo el pool de claves compartido\n");
+    hash_pool_t* pool = hash_pool_crear();
+    printf("Creo un pool: %s\n", pool != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Creo un hash con un pool NULL (FALLA): %s\n", hash_crear_con_pool(NULL, 3, NULL) == NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_t* garage = hash_crear_con_pool(destruir_string, 3, pool);
+    hash_t* multas = hash_crear_con_pool(NULL, 3, pool);
+    guardar_vehiculo(garage, "AC123BD", "Auto de Mariano");
+    guardar_vehiculo(garage, "OPQ976", "Auto de Lucas");
+    guardar_vehiculo(garage, "A421ACB", "Moto de Manu");
+    hash_insertar(multas, "AC123BD", "Mal estacionado");
+    hash_insertar(multas, "OPQ976", "Exceso de velocidad");
+    printf("Las claves repetidas se guardan una vez: %s\n", hash_pool_cantidad(pool) == 3 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    const char* internada = hash_pool_buscar(pool, "AC123BD");
+    printf("Internar devuelve siempre el mismo puntero: %s\n", (internada && hash_pool_internar(pool, "AC123BD") == internada) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_pool_soltar(pool, internada);
+    printf("Busco un vehiculo con la clave internada: %s\n", hash_obtener(multas, internada) != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    verificar_vehiculo(garage, "OPQ976", true);
+    verificar_vehiculo(multas, "A421ACB", false);
+    verificar_vehiculo(garage, "ZZ999ZZ", false);
+
+    hash_quitar(garage, "AC123BD");
+    printf("La clave sigue en el pool mientras otro hash la use: %s\n", (hash_pool_buscar(pool, "AC123BD") != NULL && hash_contiene(multas, "AC123BD")) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_quitar(multas, "AC123BD");
+    printf("La clave se libera al soltarla el ultimo hash: %s\n", hash_pool_buscar(pool, "AC123BD") == NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    char patente[10];
+    for(int i = 0; i < 200; i++){
+        sprintf(patente, "AB%03iCD", i);
+        hash_insertar(multas, patente, "Sin patente");
+    }
+    for(int i = 0; i < 200; i += 2){
+        sprintf(patente, "AB%03iCD", i);
+        hash_quitar(multas, patente);
+    }
+    bool todos = hash_pool_cantidad(pool) == 102;
+    for(int i = 1; i < 200; i += 2){
+        sprintf(patente, "AB%03iCD", i);
+        todos = todos && hash_contiene(multas, patente);
+    }
+    printf("El pool crece y libera claves sin perder ninguna: %s\n", todos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(multas);
+    hash_destruir(garage);
+    printf("Al destruir los hash el pool queda vacio: %s\n", hash_pool_cantidad(pool) == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_pool_destruir(pool);
+}
+
+size_t claves_destruidas = 0;
+
+void destruir_clave_contando(char* clave){
+    claves_destruidas++;
+    free(clave);
+}
+
+//Devuelve la clave que guarda el hash igual a la recibida, recorriendolo
+const char* clave_guardada(hash_t* hash, const char* clave){
+    const char* guardada = NULL;
+    hash_iterador_t* iterador = hash_iterador_crear(hash);
+    while(hash_iterador_tiene_siguiente(iterador) && !guardada){
+        const char* actual = hash_iterador_siguiente(iterador);
+        if(actual && strcmp(actual, clave) == 0)
+            guardada = actual;
+    }
+    hash_iterador_destruir(iterador);
+    return guardada;
+}
+
+void pruebas_propiedad_claves(){
+    printf("\nPruebo ceder y prestar las claves al hash\n");
+    hash_t* garage = hash_crear(destruir_string, 3);
+    printf("Establezco el destructor de claves de un hash NULL (FALLA): %s\n", hash_establecer_destructor_clave(NULL, destruir_clave_contando) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_establecer_destructor_clave(garage, destruir_clave_contando);
+    char* patente = duplicar_string("AC123BD");
+    printf("Cedo la clave al insertar: %s\n", hash_insertar_propio(garage, patente, duplicar_string("Auto de Mariano")) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El hash guarda la misma clave sin copiarla: %s\n", clave_guardada(garage, "AC123BD") == patente ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_insertar_propio(garage, duplicar_string("AC123BD"), duplicar_string("Auto de Mariano reemplazado"));
+    printf("Una clave cedida repetida se libera enseguida: %s\n", claves_destruidas == 1 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    const char* prestada = "OPQ976";
+    printf("Presto una clave al insertar: %s\n", hash_insertar_prestado(garage, prestada, duplicar_string("Auto de Lucas")) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El hash usa la clave prestada: %s\n", clave_guardada(garage, "OPQ976") == prestada ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    guardar_vehiculo(garage, "A421ACB", "Moto de Manu");
+    verificar_vehiculo(garage, "AC123BD", true);
+    verificar_vehiculo(garage, "OPQ976", true);
+    printf("Cedo una clave NULL (FALLA): %s\n", hash_insertar_propio(garage, NULL, NULL) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_quitar(garage, "OPQ976");
+    hash_quitar(garage, "AC123BD");
+    printf("Al quitar la clave cedida se libera con el destructor: %s\n", claves_destruidas == 2 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_insertar_propio(garage, duplicar_string("AA442CD"), duplicar_string("Auto de Guido"));
+    hash_destruir(garage);
+    printf("Al destruir el hash se liberan las claves cedidas: %s\n", claves_destruidas == 3 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    hash_pool_t* pool = hash_pool_crear();
+    hash_t* multas = hash_crear_con_pool(NULL, 3, pool);
+    hash_establecer_destructor_clave(multas, destruir_clave_contando);
+    hash_insertar_propio(multas, duplicar_string("AC123BD"), "Mal estacionado");
+    printf("Con pool la clave cedida se interna y se libera: %s\n", (claves_destruidas == 4 && hash_contiene(multas, "AC123BD")) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(multas);
+    hash_pool_destruir(pool);
+}
+
+bool contar_claves_rh(hash_rh_t* hash, const char* clave, void* aux){
+    (*(size_t*)aux)++;
+    return false;
+}
+
+void pruebas_robin_hood(){
+    printf("\nPruebo el hash Robin Hood\n");
+    printf("Creo un hash Robin Hood de capacidad 0 (FALLA): %s\n", hash_rh_crear(NULL, 0) == NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_rh_t* garage = hash_rh_crear(destruir_string, 3);
+    printf("Creo un hash Robin Hood: %s\n", garage != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Inserto un vehiculo: %s\n", hash_rh_insertar(garage, "AC123BD", duplicar_string("Auto de Mariano")) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_rh_insertar(garage, "AC123BD", duplicar_string("Auto de Mariano reemplazado"));
+    char* guardado = hash_rh_obtener(garage, "AC123BD");
+    printf("Reemplazo el vehiculo: %s\n", (guardado && strcmp(guardado, "Auto de Mariano reemplazado") == 0 && hash_rh_cantidad(garage) == 1) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Inserto con clave NULL (FALLA): %s\n", hash_rh_insertar(garage, NULL, NULL) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    char patente[10];
+    for(int i = 0; i < 5000; i++){
+        sprintf(patente, "AB%04iCD", i);
+        hash_rh_insertar(garage, patente, duplicar_string(patente));
+    }
+    for(int i = 0; i < 5000; i += 3){
+        sprintf(patente, "AB%04iCD", i);
+        hash_rh_quitar(garage, patente);
+    }
+    bool correctos = true;
+    for(int i = 0; i < 5000; i++){
+        sprintf(patente, "AB%04iCD", i);
+        guardado = hash_rh_obtener(garage, patente);
+        if(i % 3 == 0)
+            correctos = correctos && !guardado && !hash_rh_contiene(garage, patente);
+        else
+            correctos = correctos && guardado && strcmp(guardado, patente) == 0;
+    }
+    printf("Inserto y quito muchos vehiculos sin perder ninguno: %s\n", correctos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    size_t recorridas = 0;
+    hash_rh_con_cada_clave(garage, contar_claves_rh, &recorridas);
+    printf("Recorro todas las claves: %s\n", (recorridas == hash_rh_cantidad(garage) && recorridas == 3334) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("La distancia maxima se mantiene chica: %s\n", hash_rh_distancia_maxima(garage) < 32 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quito un vehiculo que no esta (FALLA): %s\n", hash_rh_quitar(garage, "AB0000CD") == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_rh_destruir(garage);
+}
+
+bool contar_claves_cuckoo(hash_cuckoo_t* hash, const char* clave, void* aux){
+    (*(size_t*)aux)++;
+    return false;
+}
+
+void pruebas_cuckoo(){
+    printf("\nPruebo el hash cuckoo\n");
+    printf("Creo un hash cuckoo de capacidad 0 (FALLA): %s\n", hash_cuckoo_crear(NULL, 0) == NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cuckoo_t* garage = hash_cuckoo_crear(destruir_string, 3);
+    printf("Creo un hash cuckoo: %s\n", garage != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Inserto un vehiculo: %s\n", hash_cuckoo_insertar(garage, "AC123BD", duplicar_string("Auto de Mariano")) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cuckoo_insertar(garage, "AC123BD", duplicar_string("Auto de Mariano reemplazado"));
+    char* guardado = hash_cuckoo_obtener(garage, "AC123BD");
+    printf("Reemplazo el vehiculo: %s\n", (guardado && strcmp(guardado, "Auto de Mariano reemplazado") == 0 && hash_cuckoo_cantidad(garage) == 1) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Inserto con clave NULL (FALLA): %s\n", hash_cuckoo_insertar(garage, NULL, NULL) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quito el vehiculo: %s\n", hash_cuckoo_quitar(garage, "AC123BD") == EXITO && !hash_cuckoo_contiene(garage, "AC123BD") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quito un vehiculo que no esta (FALLA): %s\n", hash_cuckoo_quitar(garage, "AB0000CD") == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cuckoo_destruir(garage);
+
+    //Con 2 baldes, una clave cuyos dos baldes son el mismo no entra si ese balde esta lleno:
+    //se deshacen los desplazamientos y la tabla crece con la clave pendiente antes del limite de carga
+    char patente[16];
+    size_t crecimientos = 0;
+    bool correctos = true;
+    for(int grupo = 0; grupo < 200 && correctos; grupo++){
+        hash_cuckoo_t* chico = hash_cuckoo_crear(NULL, 3);
+        size_t capacidad = hash_cuckoo_capacidad(chico);
+        for(int i = 0; i < 7 && correctos; i++){
+            sprintf(patente, "G%03iP%i", grupo, i);
+            correctos = hash_cuckoo_insertar(chico, patente, (void*)(intptr_t)(i + 1)) == EXITO;
+            for(int j = 0; j <= i && correctos; j++){
+                sprintf(patente, "G%03iP%i", grupo, j);
+                correctos = hash_cuckoo_obtener(chico, patente) == (void*)(intptr_t)(j + 1);
+            }
+            size_t recorridas = 0;
+            hash_cuckoo_con_cada_clave(chico, contar_claves_cuckoo, &recorridas);
+            correctos = correctos && recorridas == (size_t)i + 1 && hash_cuckoo_cantidad(chico) == (size_t)i + 1;
+        }
+        if(hash_cuckoo_capacidad(chico) > capacidad)
+            crecimientos++;
+        hash_cuckoo_destruir(chico);
+    }
+    printf("Deshago los desplazamientos que no encuentran lugar sin perder claves: %s\n", correctos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Crezco con la clave pendiente antes de llegar al limite de carga: %s\n", correctos && crecimientos > 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    hash_cuckoo_t* lleno = hash_cuckoo_crear(NULL, 3);
+    size_t capacidad = hash_cuckoo_capacidad(lleno);
+    for(int i = 0; i < 8; i++){
+        sprintf(patente, "LL%iCD", i);
+        hash_cuckoo_insertar(lleno, patente, NULL);
+    }
+    printf("Crezco al pasar el 95%% de carga: %s\n", hash_cuckoo_capacidad(lleno) > capacidad && hash_cuckoo_cantidad(lleno) == 8 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_cuckoo_destruir(lleno);
+}
+
+/*
+ * Claves de 16 bytes (un solo bloque del hash) con el mismo hash
+ * completo: difieren solo en los 5 bits bajos de la primera palabra, en
+ * una combinacion cuyo CRC32C se anula, y esa palabra entra a un solo
+ * carril.
+ */
+const char* claves_en_colision[] = {"@@@@@@@@PATENTES", "XM[HUXA@PATENTES", "CCGALCJ@PATENTES", "FFNBXFT@PATENTES"};
+
+int comparar_hashes(const void* a, const void* b){
+    uint64_t primero = *(const uint64_t*)a, segundo = *(const uint64_t*)b;
+    return (primero > segundo) - (primero < segundo);
+}
+
+void pruebas_simd(){
+    printf("\nPruebo los nucleos de hash y comparacion de claves\n");
+    char url[121], copia[122];
+    for(int i = 0; i < 120; i++)
+        url[i] = (char)('a' + i % 26);
+    url[120] = 0;
+    strcpy(copia + 1, url);
+    printf("El hash no depende de la alineacion: %s\n", hash_simd_hashear(url, 120) == hash_simd_hashear(copia + 1, 120) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    bool distintos = true;
+    for(size_t largo = 1; largo <= 120; largo++)
+        distintos = distintos && hash_simd_hashear(url, largo) != hash_simd_hashear(url, largo - 1);
+    printf("Cada largo da un hash distinto: %s\n", distintos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    size_t cantidad = 400000, repetidos = 0;
+    uint64_t* hashes = malloc(cantidad * sizeof(uint64_t));
+    char numero[10];
+    for(size_t i = 0; hashes && i < cantidad; i++){
+        sprintf(numero, "x%07zu", i * 13 + 5);
+        hashes[i] = hash_simd_hashear(numero, 8);
+    }
+    if(hashes)
+        qsort(hashes, cantidad, sizeof(uint64_t), comparar_hashes);
+    for(size_t i = 1; hashes && i < cantidad; i++)
+        repetidos += hashes[i] == hashes[i - 1];
+    printf("Las claves de 8 bytes no repiten hashes: %s\n", hashes && !repetidos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    free(hashes);
+    printf("Comparo dos claves iguales: %s\n", hash_simd_iguales(url, copia + 1, 120) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    copia[120] = 'Z';
+    printf("Comparo claves que difieren en el ultimo byte (FALLA): %s\n", !hash_simd_iguales(url, copia + 1, 120) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    copia[120] = url[119];
+    copia[2] = 'Z';
+    printf("Comparo claves que difieren al principio (FALLA): %s\n", !hash_simd_iguales(url, copia + 1, 120) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    hash_rh_t* rh = hash_rh_crear(NULL, 3);
+    hash_cuckoo_t* cuckoo = hash_cuckoo_crear(NULL, 3);
+    hash_ordenado_t* ordenado = hash_ordenado_crear(NULL, 3);
+    for(int i = 0; i < 4; i++){
+        hash_rh_insertar(rh, claves_en_colision[i], (void*)claves_en_colision[i]);
+        hash_cuckoo_insertar(cuckoo, claves_en_colision[i], (void*)claves_en_colision[i]);
+        hash_ordenado_insertar(ordenado, claves_en_colision[i], (void*)claves_en_colision[i]);
+    }
+    bool separadas = hash_rh_cantidad(rh) == 4 && hash_cuckoo_cantidad(cuckoo) == 4 && hash_ordenado_cantidad(ordenado) == 4;
+    for(int i = 0; i < 4; i++){
+        separadas = separadas && hash_rh_obtener(rh, claves_en_colision[i]) == claves_en_colision[i];
+        separadas = separadas && hash_cuckoo_obtener(cuckoo, claves_en_colision[i]) == claves_en_colision[i];
+        separadas = separadas && hash_ordenado_obtener(ordenado, claves_en_colision[i]) == claves_en_colision[i];
+    }
+    printf("Las otras tablas comparan las claves con el mismo hash: %s\n", separadas ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_rh_destruir(rh);
+    hash_cuckoo_destruir(cuckoo);
+    hash_ordenado_destruir(ordenado);
+}
+
+void pruebas_nucleos(){
+    printf("\nPruebo la eleccion de nucleos en tiempo de ejecucion\n");
+    const char* nombres[] = {"portable", "sse42", "avx2"};
+    const hash_nucleos_t* portable = hash_simd_buscar("portable");
+    char clave[100];
+    uint8_t etiquetas[40];
+    for(int i = 0; i < 99; i++)
+        clave[i] = (char)('A' + i % 57);
+    clave[99] = 0;
+    for(int i = 0; i < 40; i++)
+        etiquetas[i] = (uint8_t)(i % 7);
+    bool coinciden = portable != NULL;
+    for(size_t i = 0; i < 3; i++){
+        const hash_nucleos_t* nucleos = hash_simd_buscar(nombres[i]);
+        if(!nucleos)
+            continue;
+        for(size_t largo = 0; largo < 100; largo++)
+            coinciden = coinciden && nucleos->hashear(clave, largo) == portable->hashear(clave, largo);
+        coinciden = coinciden && nucleos->iguales(clave, clave, 99);
+        coinciden = coinciden && nucleos->coincidencias(etiquetas, 32, 3) == portable->coincidencias(etiquetas, 32, 3);
+        coinciden = coinciden && nucleos->coincidencias(etiquetas, 4, 9) == 0;
+    }
+    printf("Todos los nucleos soportados dan los mismos resultados: %s\n", coinciden ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Fuerzo nucleos inexistentes (FALLA): %s\n", hash_simd_forzar("inexistente") == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Fuerzo los nucleos portables: %s\n", hash_simd_forzar("portable") == EXITO && hash_simd_nucleos() == portable ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_t* hash = hash_crear(NULL, 3);
+    hash_cuckoo_t* cuckoo = hash_cuckoo_crear(NULL, 3);
+    hash_simd_forzar(NULL);
+    hash_insertar(hash, "AC123BD", "Auto de Mariano");
+    hash_cuckoo_insertar(cuckoo, "AC123BD", "Auto de Mariano");
+    printf("El hash creado con los nucleos portables los sigue usando: %s\n", hash_contiene(hash, "AC123BD") && hash_cuckoo_contiene(cuckoo, "AC123BD") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Sin forzar vuelven los mejores nucleos: %s\n", hash_simd_nucleos() == hash_simd_mejores() || getenv(HASH_NUCLEOS_ENTORNO) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(hash);
+    hash_cuckoo_destruir(cuckoo);
+}
+
+void pruebas_multimapa(){
+    printf("\nPruebo las claves con varios valores\n");
+    hash_t* hash = hash_crear(destruir_string, 3);
+    char* rojo = duplicar_string("Auto rojo");
+    char* azul = duplicar_string("Auto azul");
+    hash_insertar(hash, "AC123BD", rojo);
+    hash_agregar(hash, "AC123BD", azul);
+    for(int i = 0; i < 10; i++)
+        hash_agregar(hash, "OPQ976", duplicar_string("Moto"));
+    size_t cantidad = 0;
+    void** valores = hash_obtener_todos(hash, "AC123BD", &cantidad);
+    printf("La clave guarda sus valores en orden: %s\n", cantidad == 2 && valores[0] == rojo && valores[1] == azul ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_obtener_todos(hash, "OPQ976", &cantidad);
+    printf("El bloque de valores crece: %s\n", cantidad == 10 && hash_cantidad(hash) == 2 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("hash_obtener devuelve el primer valor: %s\n", hash_obtener(hash, "AC123BD") == rojo ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Busco los valores de una clave que no esta (FALLA): %s\n", !hash_obtener_todos(hash, "ZZZ000", &cantidad) && cantidad == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quito un valor que la clave no tiene (FALLA): %s\n", hash_quitar_valor(hash, "AC123BD", hash) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_memoria_t memoria;
+    hash_memoria(hash, &memoria);
+    printf("La memoria cuenta los bloques de valores: %s\n", memoria.valores > 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Un hash con varios valores no se congela (FALLA): %s\n", !hash_congelar(hash) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    FILE* archivo = fopen(RUTA_IMAGEN, "wb");
+    printf("Un hash con varios valores no se guarda (FALLA): %s\n", archivo && hash_guardar(hash, fileno(archivo), serializar_string) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    if(archivo)
+        fclose(archivo);
+    remove(RUTA_IMAGEN);
+    printf("Quito el primer valor: %s\n", hash_quitar_valor(hash, "AC123BD", rojo) == EXITO && hash_obtener(hash, "AC123BD") == azul ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quitar el ultimo valor quita la clave: %s\n", hash_quitar_valor(hash, "AC123BD", azul) == EXITO && !hash_contiene(hash, "AC123BD") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_insertar(hash, "OPQ976", duplicar_string("Camioneta"));
+    valores = hash_obtener_todos(hash, "OPQ976", &cantidad);
+    printf("Insertar deja un unico valor: %s\n", cantidad == 1 && strcmp(valores[0], "Camioneta") == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_agregar(hash, "OPQ976", duplicar_string("Moto"));
+    char* camion = duplicar_string("Camion");
+    hash_agregar(hash, "AA442CD", camion);
+    hash_agregar(hash, "AA442CD", duplicar_string("Acoplado"));
+    hash_insertar(hash, "AA442CD", camion);
+    char* guardado = hash_obtener(hash, "AA442CD");
+    printf("Insertar uno de los valores que ya tenia lo conserva: %s\n", guardado == camion && strcmp(guardado, "Camion") == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(hash);
+}
+
+typedef struct orden{
+    size_t cantidad;
+    bool en_orden;
+}orden_t;
+
+//Verifica que las patentes ABnnnnCD aparezcan en orden creciente
+bool verificar_orden(hash_ordenado_t* hash, const char* clave, void* elemento, void* aux){
+    orden_t* orden = aux;
+    int numero = atoi(clave + 2);
+    orden->en_orden = orden->en_orden && numero >= (int)orden->cantidad && elemento && strcmp(elemento, clave) == 0;
+    orden->cantidad = (size_t)numero + 1;
+    return false;
+}
+
+void pruebas_ordenado(){
+    printf("\nPruebo el hash ordenado por insercion\n");
+    printf("Creo un hash ordenado de capacidad 0 (FALLA): %s\n", hash_ordenado_crear(NULL, 0) == NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_ordenado_t* garage = hash_ordenado_crear(destruir_string, 3);
+    printf("Creo un hash ordenado: %s\n", garage != NULL ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    char patente[10];
+    for(int i = 0; i < 5000; i++){
+        sprintf(patente, "AB%04iCD", i);
+        hash_ordenado_insertar(garage, patente, duplicar_string(patente));
+    }
+    for(int i = 0; i < 5000; i += 3){
+        sprintf(patente, "AB%04iCD", i);
+        hash_ordenado_quitar(garage, patente);
+    }
+    hash_ordenado_insertar(garage, "AB4999CD", duplicar_string("AB4999CD"));
+    bool correctos = hash_ordenado_cantidad(garage) == 3333;
+    for(int i = 0; i < 5000; i++){
+        sprintf(patente, "AB%04iCD", i);
+        char* guardado = hash_ordenado_obtener(garage, patente);
+        if(i % 3 == 0)
+            correctos = correctos && !guardado && !hash_ordenado_contiene(garage, patente);
+        else
+            correctos = correctos && guardado && strcmp(guardado, patente) == 0;
+    }
+    printf("Inserto, reemplazo y quito muchos vehiculos sin perder ninguno: %s\n", correctos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    orden_t orden = {0, true};
+    size_t recorridas = hash_ordenado_con_cada_clave(garage, verificar_orden, &orden);
+    printf("Recorro las claves en el orden de insercion: %s\n", recorridas == 3333 && orden.en_orden ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_t* encadenado = hash_crear(NULL, 3);
+    for(int i = 0; i < 5000; i++){
+        sprintf(patente, "AB%04iCD", i);
+        if(i % 3 != 0)
+            hash_insertar(encadenado, patente, NULL);
+    }
+    hash_memoria_t memoria;
+    hash_memoria(encadenado, &memoria);
+    printf("Ocupa menos memoria que el hash encadenado: %s\n", hash_ordenado_bytes(garage) < memoria.total - memoria.claves ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(encadenado);
+    for(int i = 0; i < 4000; i++){
+        sprintf(patente, "AB%04iCD", i);
+        hash_ordenado_quitar(garage, patente);
+    }
+    hash_ordenado_insertar(garage, "AB0000CD", duplicar_string("AB0000CD"));
+    orden.cantidad = 0;
+    orden.en_orden = true;
+    hash_ordenado_con_cada_clave(garage, verificar_orden, &orden);
+    printf("Una clave quitada y vuelta a insertar va al final (FALLA el orden): %s\n", !orden.en_orden ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quito un vehiculo que no esta (FALLA): %s\n", hash_ordenado_quitar(garage, "AB0003CD") == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_ordenado_destruir(garage);
+}
+
+typedef struct claves_vistas{
+    size_t cantidad;
+    char anterior[10];
+    bool en_orden;
+    const char* prefijo;
+}claves_vistas_t;
+
+//Verifica que las claves lleguen en orden y con el prefijo esperado
+bool ver_clave_ordenada(hash_t* hash, const char* clave, void* aux){
+    claves_vistas_t* vistas = aux;
+    bool prefijo = !vistas->prefijo || strncmp(clave, vistas->prefijo, strlen(vistas->prefijo)) == 0;
+    vistas->en_orden = vistas->en_orden && prefijo && hash_contiene(hash, clave) && (!vistas->cantidad || strcmp(vistas->anterior, clave) < 0);
+    strcpy(vistas->anterior, clave);
+    vistas->cantidad++;
+    return false;
+}
+
+//Cuenta las claves que empiezan con el prefijo recibido
+bool contar_con_prefijo(hash_t* hash, const char* clave, void* aux){
+    claves_vistas_t* vistas = aux;
+    if(strncmp(clave, vistas->prefijo, strlen(vistas->prefijo)) == 0)
+        vistas->cantidad++;
+    return false;
+}
+
+bool cortar_en_tres(hash_t* hash, const char* clave, void* aux){
+    return ++(*(size_t*)aux) == 3;
+}
+
+void pruebas_indice(){
+    printf("\nPruebo el indice ordenado de claves\n");
+    hash_t* garage = hash_crear(NULL, 3);
+    claves_vistas_t vistas = {0, "", true, "AC1"};
+    printf("Recorro por prefijo sin indice (FALLA): %s\n", hash_con_cada_prefijo(garage, "AC1", ver_clave_ordenada, &vistas) == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    char patente[10];
+    srand(7);
+    for(int i = 0; i < 3000; i++){
+        sprintf(patente, "A%c%i%c", 'A' + rand() % 4, rand() % 1000, 'A' + rand() % 26);
+        hash_insertar(garage, patente, NULL);
+        if(i == 1000)
+            printf("Activo el indice con claves ya guardadas: %s\n", hash_activar_indice(garage) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    }
+    for(int i = 0; i < 1000; i++){
+        sprintf(patente, "A%c%i%c", 'A' + rand() % 4, rand() % 1000, 'A' + rand() % 26);
+        hash_quitar(garage, patente);
+    }
+    hash_insertar(garage, "AC1", NULL);
+    claves_vistas_t esperadas = {0, "", true, "AC1"};
+    hash_con_cada_clave(garage, contar_con_prefijo, &esperadas);
+    size_t recorridas = hash_con_cada_prefijo(garage, "AC1", ver_clave_ordenada, &vistas);
+    printf("Recorro en orden las claves con un prefijo: %s\n", vistas.en_orden && recorridas == esperadas.cantidad && recorridas > 1 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    claves_vistas_t todas = {0, "", true, NULL};
+    printf("Recorro en orden todas las claves: %s\n", hash_con_cada_en_rango(garage, NULL, NULL, ver_clave_ordenada, &todas) == hash_cantidad(garage) && todas.en_orden ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    claves_vistas_t rango = {0, "", true, "AB"};
+    esperadas.cantidad = 0;
+    esperadas.prefijo = "AB";
+    hash_con_cada_clave(garage, contar_con_prefijo, &esperadas);
+    printf("Recorro un rango de claves: %s\n", hash_con_cada_en_rango(garage, "AB", "AC", ver_clave_ordenada, &rango) == esperadas.cantidad && rango.en_orden ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Recorro un prefijo que no esta (FALLA): %s\n", hash_con_cada_prefijo(garage, "B", ver_clave_ordenada, &vistas) == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    size_t cortadas = 0;
+    printf("Corto el recorrido del prefijo: %s\n", hash_con_cada_prefijo(garage, "A", cortar_en_tres, &cortadas) == 3 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_memoria_t memoria;
+    hash_memoria(garage, &memoria);
+    printf("La memoria cuenta el indice: %s\n", memoria.indice > 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(garage);
+}
+
+size_t elementos_destruidos = 0;
+
+void destruir_contando(void* elemento){
+    elementos_destruidos++;
+}
+
+void pruebas_conjuntos(){
+    printf("\nPruebo las operaciones de conjuntos entre hashes\n");
+    hash_t* destino = hash_crear(destruir_contando, 3);
+    hash_t* origen = hash_crear(destruir_contando, 3);
+    char patente[10];
+    printf("Reservo lugar para muchos elementos: %s\n", hash_reservar(destino, 1000) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    for(int i = 0; i < 1000; i++){
+        sprintf(patente, "AB%04iCD", i);
+        hash_insertar(destino, patente, "destino");
+        sprintf(patente, "AB%04iCD", i + 500);
+        hash_insertar_con_ttl(origen, patente, "origen", i % 100 == 0 ? 0 : 1000000);
+    }
+    hash_estadisticas_t estadisticas;
+    hash_estadisticas(destino, &estadisticas);
+    printf("Insertar lo reservado no rehashea: %s\n", estadisticas.rehashes == 1 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Fusiono el origen en el destino: %s\n", hash_fusionar(destino, origen, HASH_CONSERVAR_DESTINO) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El origen queda vacio: %s\n", hash_cantidad(origen) == 0 && hash_cantidad(destino) == 1500 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("En un conflicto queda el elemento del destino: %s\n", strcmp(hash_obtener(destino, "AB0600CD"), "destino") == 0 && elementos_destruidos == 500 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Las claves movidas conservan su vencimiento: %s\n", !hash_contiene(destino, "AB1100CD") && strcmp(hash_obtener(destino, "AB1101CD"), "origen") == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_insertar(origen, "AB0001CD", "origen");
+    hash_insertar(origen, "ZZ0001CD", "origen");
+    hash_fusionar(destino, origen, HASH_USAR_ORIGEN);
+    printf("En un conflicto queda el elemento del origen: %s\n", strcmp(hash_obtener(destino, "AB0001CD"), "origen") == 0 && hash_contiene(destino, "ZZ0001CD") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    for(int i = 0; i < 100; i++){
+        sprintf(patente, "AB%04iCD", i * 2);
+        hash_insertar(origen, patente, "origen");
+    }
+    size_t antes = hash_cantidad(destino);
+    size_t quitadas = 0;
+    printf("Quito las claves que estan en otro hash: %s\n", hash_diferencia(destino, origen, &quitadas) == EXITO && quitadas == 100 && hash_cantidad(destino) == antes - 100 && !hash_contiene(destino, "AB0002CD") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_insertar(origen, "AB0003CD", "origen");
+    printf("Dejo solo las claves que estan en otro hash: %s\n", hash_interseccion(destino, origen, &quitadas) == EXITO && quitadas == antes - 101 && hash_cantidad(destino) == 1 && hash_contiene(destino, "AB0003CD") && hash_cantidad(origen) == 101 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_establecer_reloj(origen, reloj_de_prueba);
+    tiempo_de_prueba = 0;
+    hash_insertar_con_ttl(origen, "AB0003CD", "origen", 10);
+    tiempo_de_prueba = 20;
+    printf("Comparar con una clave vencida no la quita del otro hash: %s\n", hash_diferencia(destino, origen, &quitadas) == EXITO && quitadas == 0 && hash_cantidad(destino) == 1 && hash_cantidad(origen) == 101 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("La clave vencida se quita al buscarla: %s\n", !hash_contiene(origen, "AB0003CD") && hash_cantidad(origen) == 100 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quito de un hash NULL las claves de otro (FALLA): %s\n", hash_diferencia(NULL, origen, &quitadas) == ERROR && quitadas == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_pool_t* pool = hash_pool_crear();
+    hash_t* con_pool = hash_crear_con_pool(NULL, 3, pool);
+    printf("Fusiono hashes que guardan las claves distinto (FALLA): %s\n", hash_fusionar(destino, con_pool, HASH_USAR_ORIGEN) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Fusiono un hash consigo mismo (FALLA): %s\n", hash_fusionar(destino, destino, HASH_USAR_ORIGEN) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(con_pool);
+    hash_pool_destruir(pool);
+    hash_destruir(destino);
+    hash_destruir(origen);
+}
+
+//Libera el elemento y lo cuenta
+void liberar_contando(void* elemento){
+    free(elemento);
+    elementos_destruidos++;
+}
+
+//Cuenta los elementos que todavia dicen viejo
+bool contar_viejos(const char* clave, void* elemento, void* aux){
+    if(strcmp(elemento, "viejo") == 0)
+        (*(size_t*)aux)++;
+    return false;
+}
+
+//Cuenta las claves recorridas por el indice
+bool contar_clave(hash_t* hash, const char* clave, void* aux){
+    (*(size_t*)aux)++;
+    return false;
+}
+
+void pruebas_snapshot(){
+    printf("\nPruebo los snapshots del hash\n");
+    hash_t* garage = hash_crear(liberar_contando, 3);
+    hash_establecer_reloj(garage, reloj_de_prueba);
+    tiempo_de_prueba = 0;
+    hash_activar_indice(garage);
+    char patente[10];
+    for(int i = 0; i < 2000; i++){
+        sprintf(patente, "AC%04iZZ", i);
+        hash_insertar(garage, patente, duplicar_string("viejo"));
+    }
+    hash_insertar_con_ttl(garage, "VENCE", duplicar_string("vence"), 10);
+    elementos_destruidos = 0;
+    hash_snapshot_t* snapshot = hash_snapshot(garage);
+    printf("Tomo un snapshot: %s\n", snapshot && hash_snapshot_cantidad(snapshot) == 2001 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    for(int i = 0; i < 1000; i++){
+        sprintf(patente, "AC%04iZZ", i);
+        hash_insertar(garage, patente, duplicar_string("nuevo"));
+    }
+    for(int i = 1000; i < 1500; i++){
+        sprintf(patente, "AC%04iZZ", i);
+        hash_quitar(garage, patente);
+    }
+    for(int i = 2000; i < 6000; i++){
+        sprintf(patente, "AC%04iZZ", i);
+        hash_insertar(garage, patente, duplicar_string("nuevo"));
+    }
+    tiempo_de_prueba = 100;
+    printf("El hash sigue cambiando: %s\n", hash_expirar(garage, 100) == 1 && hash_cantidad(garage) == 5500 && strcmp(hash_obtener(garage, "AC0001ZZ"), "nuevo") == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("No se libera lo que usa el snapshot: %s\n", elementos_destruidos == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El snapshot ve las claves que tenia: %s\n", strcmp(hash_snapshot_obtener(snapshot, "AC0001ZZ"), "viejo") == 0 && hash_snapshot_contiene(snapshot, "AC1200ZZ") && hash_snapshot_contiene(snapshot, "VENCE") && !hash_snapshot_contiene(snapshot, "AC3000ZZ") && hash_snapshot_cantidad(snapshot) == 2001 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    size_t viejos = 0;
+    printf("Recorro el snapshot: %s\n", hash_snapshot_con_cada_clave(snapshot, contar_viejos, &viejos) == 2001 && viejos == 2000 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Agrego un valor con un snapshot tomado (FALLA): %s\n", hash_agregar(garage, "AC0001ZZ", NULL) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_snapshot_t* segundo = hash_snapshot(garage);
+    hash_quitar(garage, "AC0002ZZ");
+    hash_snapshot_liberar(snapshot);
+    hash_quitar(garage, "AC0003ZZ");
+    printf("Al soltar el snapshot se libera lo que usaba: %s\n", elementos_destruidos == 1501 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("El otro snapshot sigue viendo sus claves: %s\n", strcmp(hash_snapshot_obtener(segundo, "AC0002ZZ"), "nuevo") == 0 && hash_snapshot_cantidad(segundo) == 5500 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    size_t con_prefijo = 0;
+    hash_con_cada_prefijo(garage, "AC000", contar_clave, &con_prefijo);
+    printf("El indice sigue al dia: %s\n", con_prefijo == 8 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_snapshot_liberar(segundo);
+    hash_destruir(garage);
+    printf("Destruir el hash libera todo una sola vez: %s\n", elementos_destruidos == 7001 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+}
+
+//Cuenta las claves recorridas del hamt
+bool contar_clave_hamt(hash_hamt_t* hash, const char* clave, void* aux){
+    (*(size_t*)aux)++;
+    return false;
+}
+
+void pruebas_hamt(){
+    printf("\nPruebo el hash persistente (HAMT)\n");
+    hash_hamt_t* garage = hash_hamt_crear(liberar_contando);
+    printf("Creo un hash persistente: %s\n", garage && hash_hamt_cantidad(garage) == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    uint64_t colision = hash_simd_hashear(claves_en_colision[0], 16);
+    bool iguales = true;
+    for(int i = 1; i < 4; i++)
+        iguales = iguales && hash_simd_hashear(claves_en_colision[i], 16) == colision;
+    printf("Las claves de prueba tienen el mismo hash: %s\n", iguales ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    char vecina[10] = "";
+    char patente[10];
+    for(int i = 0; i < 10000 && !vecina[0]; i++){
+        sprintf(patente, "AB%04iCD", i);
+        if((hash_simd_hashear(patente, 8) & 1023) == (colision & 1023))
+            strcpy(vecina, patente);
+    }
+    for(int i = 0; i < 3; i++)
+        hash_hamt_insertar(garage, claves_en_colision[i], duplicar_string(claves_en_colision[i]));
+    hash_hamt_insertar(garage, vecina, duplicar_string(vecina));
+    bool correctos = hash_hamt_cantidad(garage) == 4 && strcmp(hash_hamt_obtener(garage, vecina), vecina) == 0;
+    for(int i = 0; i < 3; i++)
+        correctos = correctos && strcmp(hash_hamt_obtener(garage, claves_en_colision[i]), claves_en_colision[i]) == 0;
+    printf("Guardo claves con el mismo hash y una que comparte dos niveles: %s\n", vecina[0] && correctos && !hash_hamt_contiene(garage, claves_en_colision[3]) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    elementos_destruidos = 0;
+    hash_hamt_t* version = hash_hamt_version(garage);
+    hash_hamt_insertar(version, claves_en_colision[3], duplicar_string(claves_en_colision[3]));
+    hash_hamt_insertar(garage, claves_en_colision[1], duplicar_string("reemplazo"));
+    printf("Reemplazar en una version no libera el elemento de la otra: %s\n", elementos_destruidos == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Cada version ve sus colisiones: %s\n", hash_hamt_cantidad(version) == 5 && hash_hamt_contiene(version, claves_en_colision[3]) && !hash_hamt_contiene(garage, claves_en_colision[3]) && strcmp(hash_hamt_obtener(garage, claves_en_colision[1]), "reemplazo") == 0 && strcmp(hash_hamt_obtener(version, claves_en_colision[1]), claves_en_colision[1]) == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Quito una colision que esta solo en la otra version (FALLA): %s\n", hash_hamt_quitar(garage, claves_en_colision[3]) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    hash_hamt_quitar(garage, claves_en_colision[0]);
+    hash_hamt_quitar(garage, claves_en_colision[1]);
+    printf("Quitar de las colisiones deja la ultima: %s\n", hash_hamt_cantidad(garage) == 2 && strcmp(hash_hamt_obtener(garage, claves_en_colision[2]), claves_en_colision[2]) == 0 && strcmp(hash_hamt_obtener(garage, vecina), vecina) == 0 && elementos_destruidos == 1 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_hamt_quitar(garage, vecina);
+    size_t recorridas = 0;
+    printf("El camino se colapsa hasta la clave que queda: %s\n", hash_hamt_con_cada_clave(garage, contar_clave_hamt, &recorridas) == 1 && recorridas == 1 && hash_hamt_contiene(garage, claves_en_colision[2]) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_hamt_quitar(garage, claves_en_colision[2]);
+    printf("Quitar la ultima deja el hash vacio: %s\n", hash_hamt_cantidad(garage) == 0 && hash_hamt_con_cada_clave(garage, contar_clave_hamt, &recorridas) == 0 && elementos_destruidos == 1 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    correctos = hash_hamt_cantidad(version) == 5 && strcmp(hash_hamt_obtener(version, vecina), vecina) == 0;
+    for(int i = 0; i < 4; i++)
+        correctos = correctos && strcmp(hash_hamt_obtener(version, claves_en_colision[i]), claves_en_colision[i]) == 0;
+    printf("La otra version conserva todo lo que compartian: %s\n", correctos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_hamt_insertar(garage, claves_en_colision[0], duplicar_string("de nuevo"));
+    printf("Vuelvo a insertar en el hash vacio: %s\n", hash_hamt_cantidad(garage) == 1 && strcmp(hash_hamt_obtener(garage, claves_en_colision[0]), "de nuevo") == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_hamt_destruir(version);
+    printf("Al destruir la version se libera lo que solo ella tenia: %s\n", elementos_destruidos == 6 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_hamt_destruir(garage);
+    printf("Destruir el hash libera el resto: %s\n", elementos_destruidos == 7 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    hash_hamt_t* versiones[50];
+    versiones[0] = hash_hamt_crear(liberar_contando);
+    elementos_destruidos = 0;
+    for(int i = 1; i < 50; i++){
+        versiones[i] = hash_hamt_version(versiones[i - 1]);
+        sprintf(patente, "AB%04iCD", i);
+        hash_hamt_insertar(versiones[i], patente, duplicar_string(patente));
+    }
+    correctos = true;
+    for(int i = 0; i < 50; i++){
+        sprintf(patente, "AB%04iCD", i + 1);
+        correctos = correctos && hash_hamt_cantidad(versiones[i]) == (size_t)i && !hash_hamt_contiene(versiones[i], patente);
+        sprintf(patente, "AB%04iCD", i);
+        correctos = correctos && (i == 0 || strcmp(hash_hamt_obtener(versiones[i], patente), patente) == 0);
+    }
+    printf("Una cadena de versiones agrega una clave en cada una: %s\n", correctos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    for(int i = 0; i < 50; i += 2)
+        hash_hamt_destruir(versiones[i]);
+    printf("Destruir versiones intermedias no libera lo que usan las demas: %s\n", elementos_destruidos == 0 && strcmp(hash_hamt_obtener(versiones[49], "AB0001CD"), "AB0001CD") == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    for(int i = 49; i > 0; i -= 2)
+        hash_hamt_destruir(versiones[i]);
+    printf("Destruir todas las versiones libera cada elemento una vez: %s\n", elementos_destruidos == 49 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+}
+
+void pruebas_reserva(){
+    printf("\nPruebo las reservas con paginas grandes y NUMA\n");
+    reserva_t reserva = {true, RESERVA_NUMA_INTERCALAR, 0};
+    size_t bytes = 3 * 1024 * 1024;
+    unsigned char* memoria = reserva_obtener(&reserva, bytes);
+    bool en_cero = memoria != NULL;
+    for(size_t i = 0; en_cero && i < bytes; i++)
+        en_cero = memoria[i] == 0;
+    printf("Reservo memoria en 0 con paginas grandes: %s\n", en_cero ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    memset(memoria, 0x5a, bytes);
+    memoria = reserva_redimensionar(&reserva, memoria, 2 * bytes);
+    bool conservada = memoria != NULL;
+    for(size_t i = 0; conservada && i < bytes; i++)
+        conservada = memoria[i] == 0x5a;
+    printf("Agrando la memoria conservando su contenido: %s\n", conservada ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    reserva_liberar(memoria);
+    reserva_t en_nodo = {false, RESERVA_NUMA_NODO, 0};
+    memoria = reserva_obtener(&en_nodo, 16);
+    printf("Una reserva chica usa malloc: %s\n", memoria && !reserva_con_paginas_grandes(memoria) ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    reserva_liberar(memoria);
+    hash_t* garage = hash_crear_con_reserva(destruir_contando, 3, &reserva);
+    hash_rh_t* rh = hash_rh_crear_con_reserva(NULL, 3, &en_nodo);
+    hash_cuckoo_t* cuckoo = hash_cuckoo_crear_con_reserva(NULL, 3, &reserva);
+    hash_ordenado_t* ordenado = hash_ordenado_crear_con_reserva(NULL, 3, &reserva);
+    char patente[10];
+    for(int i = 0; i < 100000; i++){
+        sprintf(patente, "AB%05iC", i);
+        hash_insertar(garage, patente, NULL);
+        hash_rh_insertar(rh, patente, NULL);
+        hash_cuckoo_insertar(cuckoo, patente, NULL);
+        hash_ordenado_insertar(ordenado, patente, NULL);
+    }
+    bool correctos = hash_cantidad(garage) == 100000 && hash_rh_cantidad(rh) == 100000 && hash_cuckoo_cantidad(cuckoo) == 100000 && hash_ordenado_cantidad(ordenado) == 100000;
+    for(int i = 0; i < 100000 && correctos; i += 7){
+        sprintf(patente, "AB%05iC", i);
+        correctos = hash_contiene(garage, patente) && hash_rh_contiene(rh, patente) && hash_cuckoo_contiene(cuckoo, patente) && hash_ordenado_contiene(ordenado, patente);
+    }
+    printf("Los hashes con reserva crecen sin perder claves: %s\n", correctos ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(garage);
+    hash_rh_destruir(rh);
+    hash_cuckoo_destruir(cuckoo);
+    hash_ordenado_destruir(ordenado);
+}
+
+void* deserializar_string(const void* datos, size_t tamanio){
+    return duplicar_string(datos);
+}
+
+//Devuelve true si el hash recuperado tiene el vehiculo con la descripcion dada
+bool recuperado_con(hash_t* recuperado, const char* patente, const char* descripcion){
+    const char* vehiculo = hash_obtener(recuperado, patente);
+    return vehiculo && strcmp(vehiculo, descripcion) == 0;
+}
+
+void pruebas_wal(){
+    printf("\nPruebo el log de escritura anticipada\n");
+    hash_t* garage = hash_crear(free, 3);
+    guardar_vehiculo(garage, "AC123BD", "Auto de Mariano");
+    printf("Activo el log en el garage: %s\n", hash_activar_wal(garage, RUTA_WAL, serializar_string, 2) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Activo el log dos veces (FALLA): %s\n", hash_activar_wal(garage, RUTA_WAL, serializar_string, 2) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    guardar_vehiculo(garage, "OPQ976", "Auto de Lucas");
+    guardar_vehiculo(garage, "A421ACB", "Moto de Manu");
+    guardar_vehiculo(garage, "OPQ976", "Auto de Guido");
+    quitar_vehiculo(garage, "AC123BD");
+    printf("Agrego un valor con el log activo (FALLA): %s\n", hash_agregar(garage, "A421ACB", NULL) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Sincronizo el log: %s\n", hash_wal_sincronizar(garage) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+
+    hash_t* recuperado = hash_recuperar(RUTA_WAL, free, deserializar_string);
+    bool correcto = recuperado && hash_cantidad(recuperado) == 2 && !hash_contiene(recuperado, "AC123BD");
+    printf("Recupero el garage de la imagen y el log: %s\n", correcto && recuperado_con(recuperado, "OPQ976", "Auto de Guido") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(recuperado);
+
+    printf("Hago un checkpoint: %s\n", hash_wal_checkpoint(garage) == EXITO ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    guardar_vehiculo(garage, "AA442CD", "Auto de Agustina");
+    quitar_vehiculo(garage, "A421ACB");
+    guardar_vehiculo(garage, "DZE443", "Auto de Jonathan");
+    hash_destruir(garage);
+    recuperado = hash_recuperar(RUTA_WAL, free, deserializar_string);
+    correcto = recuperado && hash_cantidad(recuperado) == 3 && !hash_contiene(recuperado, "A421ACB") && recuperado_con(recuperado, "AA442CD", "Auto de Agustina");
+    printf("Recupero despues del checkpoint con lo pendiente al destruir: %s\n", correcto && recuperado_con(recuperado, "DZE443", "Auto de Jonathan") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(recuperado);
+
+    FILE* log = fopen(RUTA_WAL".log", "ab");
+    if(log){
+        fwrite("basura", 1, 6, log);
+        fclose(log);
+    }
+    recuperado = hash_recuperar(RUTA_WAL, free, deserializar_string);
+    printf("Ignoro un registro escrito a medias: %s\n", recuperado && hash_cantidad(recuperado) == 3 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(recuperado);
+
+    remove(RUTA_WAL".log");
+    remove(RUTA_WAL".img");
+    recuperado = hash_recuperar(RUTA_WAL, free, deserializar_string);
+    printf("Sin imagen ni log se recupera un garage vacio: %s\n", recuperado && hash_cantidad(recuperado) == 0 ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    printf("Activo el log sin ruta (FALLA): %s\n", hash_activar_wal(recuperado, NULL, NULL, 1) == ERROR ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(recuperado);
+
+    garage = hash_crear(free, 3);
+    hash_establecer_reloj(garage, reloj_de_prueba);
+    tiempo_de_prueba = 0;
+    hash_activar_wal(garage, RUTA_WAL, serializar_string, 1);
+    hash_insertar_con_ttl(garage, "AC123BD", duplicar_string("Auto de Mariano"), 10);
+    tiempo_de_prueba = 20;
+    hash_insertar(garage, "AC123BD", duplicar_string("Auto de Lucas"));
+    hash_wal_sincronizar(garage);
+    recuperado = hash_recuperar(RUTA_WAL, free, deserializar_string);
+    printf("Reinsertar una clave vencida queda en el log: %s\n", recuperado && hash_cantidad(recuperado) == 1 && recuperado_con(recuperado, "AC123BD", "Auto de Lucas") ? VERDE"EXITO"RESET : ROJO"FALLO"RESET);
+    hash_destruir(recuperado);
+    hash_destruir(garage);
+    remove(RUTA_WAL".log");
+    remove(RUTA_WAL".img");
+}
+
 int main(){
     pruebas_funcionamiento();
     pruebas_hash_vacio();
     pruebas_null();
+    pruebas_persistencia();
+    pruebas_congelado();
+    pruebas_filtro();
+    pruebas_cache();
+    pruebas_ttl();
+    pruebas_estadisticas();
+    pruebas_trazas();
+    pruebas_memoria();
+    pruebas_pool();
+    pruebas_propiedad_claves();
+    pruebas_robin_hood();
+    pruebas_cuckoo();
+    pruebas_simd();
+    pruebas_nucleos();
+    pruebas_multimapa();
+    pruebas_ordenado();
+    pruebas_indice();
+    pruebas_conjuntos();
+    pruebas_snapshot();
+    pruebas_hamt();
+    pruebas_reserva();
+    pruebas_wal();
     return 0;
 }
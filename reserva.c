@@ -0,0 +1,175 @@
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "reserva.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#define PAGINA_GRANDE (2 * 1024 * 1024)
+//Lugar para la cabecera que deja la memoria alineada a una linea de cache
+#define DESPLAZAMIENTO RESERVA_ALINEACION
+#define MAX_NODOS 1024
+#define BITS_POR_PALABRA (8 * sizeof(unsigned long))
+//Valores de linux/mempolicy.h
+#define POLITICA_LIGAR 2
+#define POLITICA_INTERCALAR 3
+#define NODOS_PERMITIDOS 4
+
+/*
+ * Va justo antes de la memoria que se entrega. Base es el principio del
+ * bloque, que es de malloc si mapeado es 0. La memoria se entrega
+ * DESPLAZAMIENTO bytes despues de base, alineada a una linea de cache.
+ */
+typedef struct cabecera{
+    void* base;
+    size_t mapeado;
+    size_t bytes;
+    bool paginas_grandes;
+}cabecera_t;
+
+static cabecera_t* cabecera_de(void* memoria){
+    return (cabecera_t*)memoria - 1;
+}
+
+//Devuelve true si hay que mapear la memoria en lugar de usar malloc
+static bool mapear(const reserva_t* reserva, size_t bytes){
+#ifdef __linux__
+    return reserva && bytes >= RESERVA_MINIMA && (reserva->paginas_grandes || reserva->numa != RESERVA_NUMA_SISTEMA);
+#else
+    return false;
+#endif
+}
+
+static void* obtener_de_malloc(size_t bytes){
+    void* base = NULL;
+    if(posix_memalign(&base, DESPLAZAMIENTO, DESPLAZAMIENTO + bytes) != 0)
+        return NULL;
+    char* memoria = (char*)base + DESPLAZAMIENTO;
+    memset(memoria, 0, bytes);
+    cabecera_t* cabecera = cabecera_de(memoria);
+    cabecera->base = base;
+    cabecera->mapeado = 0;
+    cabecera->bytes = bytes;
+    cabecera->paginas_grandes = false;
+    return memoria;
+}
+
+#ifdef __linux__
+static size_t redondear(size_t bytes, size_t unidad){
+    return (bytes + unidad - 1) / unidad * unidad;
+}
+
+/*
+ * Mapea el largo dado alineado a 2 MB: del pool de paginas grandes si
+ * tiene lugar o, si no, con paginas comunes pidiendo paginas grandes
+ * transparentes. Devuelve la memoria o NULL en caso de error.
+ */
+static void* mapear_grande(size_t largo, bool* grandes){
+    void* memoria = mmap(NULL, largo, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if(memoria != MAP_FAILED){
+        *grandes = true;
+        return memoria;
+    }
+    char* mapeado = mmap(NULL, largo + PAGINA_GRANDE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(mapeado == MAP_FAILED)
+        return NULL;
+    char* alineado = (char*)redondear((size_t)(uintptr_t)mapeado, PAGINA_GRANDE);
+    size_t antes = (size_t)(alineado - mapeado);
+    if(antes)
+        munmap(mapeado, antes);
+    munmap(alineado + largo, PAGINA_GRANDE - antes);
+    *grandes = madvise(alineado, largo, MADV_HUGEPAGE) == 0;
+    return alineado;
+}
+
+/*
+ * Fija la politica NUMA de la memoria, que todavia no se toco. Si el
+ * sistema no tiene NUMA o no acepta la politica, la memoria queda con
+ * la del proceso.
+ */
+static void ubicar(void* memoria, size_t largo, const reserva_t* reserva){
+#if defined(SYS_mbind) && defined(SYS_get_mempolicy)
+    unsigned long nodos[MAX_NODOS / BITS_POR_PALABRA] = {0};
+    int politica = POLITICA_INTERCALAR;
+    if(reserva->numa == RESERVA_NUMA_NODO){
+        if(reserva->nodo < 0 || reserva->nodo >= MAX_NODOS)
+            return;
+        size_t nodo = (size_t)reserva->nodo;
+        nodos[nodo / BITS_POR_PALABRA] |= 1UL << (nodo % BITS_POR_PALABRA);
+        politica = POLITICA_LIGAR;
+    }else if(reserva->numa != RESERVA_NUMA_INTERCALAR || syscall(SYS_get_mempolicy, NULL, nodos, MAX_NODOS, NULL, NODOS_PERMITIDOS) != 0){
+        return;
+    }
+    syscall(SYS_mbind, memoria, largo, politica, nodos, MAX_NODOS, 0);
+#endif
+}
+
+static void* obtener_mapeado(const reserva_t* reserva, size_t bytes){
+    size_t unidad = reserva->paginas_grandes ? PAGINA_GRANDE : (size_t)sysconf(_SC_PAGESIZE);
+    size_t largo = redondear(bytes + DESPLAZAMIENTO, unidad);
+    bool grandes = false;
+    void* base = NULL;
+    if(reserva->paginas_grandes)
+        base = mapear_grande(largo, &grandes);
+    else{
+        base = mmap(NULL, largo, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(base == MAP_FAILED)
+            base = NULL;
+    }
+    if(!base)
+        return NULL;
+    ubicar(base, largo, reserva);
+    char* memoria = (char*)base + DESPLAZAMIENTO;
+    cabecera_t* cabecera = cabecera_de(memoria);
+    cabecera->base = base;
+    cabecera->mapeado = largo;
+    cabecera->bytes = bytes;
+    cabecera->paginas_grandes = grandes;
+    return memoria;
+}
+#endif
+
+void* reserva_obtener(const reserva_t* reserva, size_t bytes){
+#ifdef __linux__
+    if(mapear(reserva, bytes))
+        return obtener_mapeado(reserva, bytes);
+#endif
+    return obtener_de_malloc(bytes);
+}
+
+void* reserva_redimensionar(const reserva_t* reserva, void* memoria, size_t bytes){
+    if(!memoria)
+        return reserva_obtener(reserva, bytes);
+    cabecera_t* cabecera = cabecera_de(memoria);
+    void* nueva = reserva_obtener(reserva, bytes);
+    if(!nueva)
+        return NULL;
+    memcpy(nueva, memoria, cabecera->bytes < bytes ? cabecera->bytes : bytes);
+    reserva_liberar(memoria);
+    return nueva;
+}
+
+bool reserva_con_paginas_grandes(void* memoria){
+    return memoria && cabecera_de(memoria)->paginas_grandes;
+}
+
+void reserva_liberar(void* memoria){
+    if(!memoria)
+        return;
+    cabecera_t* cabecera = cabecera_de(memoria);
+#ifdef __linux__
+    if(cabecera->mapeado){
+        munmap(cabecera->base, cabecera->mapeado);
+        return;
+    }
+#endif
+    free(cabecera->base);
+}
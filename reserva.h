@@ -0,0 +1,72 @@
+#ifndef __RESERVA_H__
+#define __RESERVA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Reserva de arreglos grandes con paginas de 2 MB y ubicacion en nodos
+ * NUMA, para las tablas que ocupan tanta memoria que las fallas de TLB
+ * pesan en cada acceso.
+ *
+ * Las paginas grandes se piden primero al pool de hugetlbfs
+ * (MAP_HUGETLB) y, si no hay, se reserva memoria alineada a 2 MB y se le
+ * pide al kernel que use paginas grandes transparentes. La ubicacion
+ * NUMA se fija antes de tocar la memoria, asi que rige desde la primera
+ * pagina. Las dos cosas son pedidos: si el sistema no las soporta la
+ * memoria se reserva igual con paginas comunes y la politica del
+ * proceso.
+ *
+ * Los arreglos de menos de RESERVA_MINIMA bytes, y todos cuando no se
+ * pide nada, se reservan con malloc. En todos los casos la memoria queda
+ * alineada a RESERVA_ALINEACION bytes, una linea de cache.
+ */
+#define RESERVA_MINIMA (64 * 1024)
+#define RESERVA_ALINEACION 64
+
+typedef enum reserva_numa{
+    RESERVA_NUMA_SISTEMA,
+    RESERVA_NUMA_NODO,
+    RESERVA_NUMA_INTERCALAR
+}reserva_numa_t;
+
+/*
+ * Como reservar. Con todos los campos en 0 se usa malloc: paginas
+ * comunes y la politica NUMA del proceso. Con RESERVA_NUMA_NODO toda la
+ * memoria va al nodo dado; con RESERVA_NUMA_INTERCALAR las paginas se
+ * reparten entre todos los nodos que el proceso puede usar.
+ */
+typedef struct reserva{
+    bool paginas_grandes;
+    reserva_numa_t numa;
+    int nodo;
+}reserva_t;
+
+/*
+ * Reserva la cantidad de bytes en 0. Si reserva es NULL usa malloc.
+ * Devuelve la memoria o NULL en caso de error.
+ */
+void* reserva_obtener(const reserva_t* reserva, size_t bytes);
+
+/*
+ * Cambia el tamanio de una memoria de reserva_obtener conservando su
+ * contenido hasta el menor de los dos tamanios; los bytes nuevos quedan
+ * en 0. La memoria siempre se mueve a una reserva nueva.
+ *
+ * Devuelve la memoria, que puede haberse movido, o NULL en caso de
+ * error, en cuyo caso la memoria original queda intacta.
+ */
+void* reserva_redimensionar(const reserva_t* reserva, void* memoria, size_t bytes);
+
+/*
+ * Devuelve true si la memoria se reservo con paginas de 2 MB (o con el
+ * pedido de paginas grandes transparentes) o false en caso contrario.
+ */
+bool reserva_con_paginas_grandes(void* memoria);
+
+/*
+ * Libera una memoria de reserva_obtener.
+ */
+void reserva_liberar(void* memoria);
+
+#endif /* __RESERVA_H__ */
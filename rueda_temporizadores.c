@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "rueda_temporizadores.h"
+
+#define VACIO 0
+#define NIVELES 4
+#define BITS_NIVEL 6
+#define CASILLEROS 64
+#define MASCARA 63
+
+struct rueda{
+    temporizador_t* casilleros[NIVELES][CASILLEROS];
+    uint64_t ocupados[NIVELES];
+    uint64_t actual;
+    size_t cantidad;
+    size_t nivel_cascada;
+};
+
+rueda_t* rueda_crear(uint64_t ahora){
+    rueda_t* rueda = calloc(1, sizeof(rueda_t));
+    if(!rueda)
+        return NULL;
+    rueda->actual = ahora;
+    return rueda;
+}
+
+/*
+ * Elige el nivel y el casillero del temporizador segun cuanto falta
+ * para su vencimiento, y lo enlaza al principio de ese casillero. Los
+ * vencimientos que exceden el alcance de la rueda van al casillero del
+ * ultimo nivel que se visita mas tarde, y se reubican al llegar a el.
+ */
+static void ubicar(rueda_t* rueda, temporizador_t* temporizador){
+    uint64_t vencimiento = temporizador->vencimiento < rueda->actual ? rueda->actual : temporizador->vencimiento;
+    uint64_t distancia = vencimiento - rueda->actual;
+    size_t nivel = 0;
+    while(nivel < NIVELES - 1 && distancia >= ((uint64_t)1 << (BITS_NIVEL * (nivel + 1))))
+        nivel++;
+    size_t indice;
+    if(distancia >= ((uint64_t)1 << (BITS_NIVEL * NIVELES)))
+        indice = (size_t)(((rueda->actual >> (BITS_NIVEL * nivel)) - 1) & MASCARA);
+    else
+        indice = (size_t)((vencimiento >> (BITS_NIVEL * nivel)) & MASCARA);
+
+    temporizador_t** casillero = &rueda->casilleros[nivel][indice];
+    temporizador->anterior = NULL;
+    temporizador->siguiente = *casillero;
+    if(*casillero)
+        (*casillero)->anterior = temporizador;
+    *casillero = temporizador;
+    rueda->ocupados[nivel] |= (uint64_t)1 << indice;
+    temporizador->casillero = nivel * CASILLEROS + indice;
+    temporizador->enlazado = true;
+}
+
+/*
+ * Desenlaza el temporizador de su casillero, sin tocar la cantidad.
+ */
+static void desenlazar(rueda_t* rueda, temporizador_t* temporizador){
+    size_t nivel = temporizador->casillero / CASILLEROS;
+    size_t indice = temporizador->casillero % CASILLEROS;
+    if(temporizador->anterior)
+        temporizador->anterior->siguiente = temporizador->siguiente;
+    else
+        rueda->casilleros[nivel][indice] = temporizador->siguiente;
+    if(temporizador->siguiente)
+        temporizador->siguiente->anterior = temporizador->anterior;
+    if(!rueda->casilleros[nivel][indice])
+        rueda->ocupados[nivel] &= ~((uint64_t)1 << indice);
+    temporizador->anterior = NULL;
+    temporizador->siguiente = NULL;
+    temporizador->enlazado = false;
+}
+
+void rueda_agregar(rueda_t* rueda, temporizador_t* temporizador){
+    if(!rueda || !temporizador)
+        return;
+    ubicar(rueda, temporizador);
+    rueda->cantidad++;
+}
+
+void rueda_quitar(rueda_t* rueda, temporizador_t* temporizador){
+    if(!rueda || !temporizador || !temporizador->enlazado)
+        return;
+    desenlazar(rueda, temporizador);
+    rueda->cantidad--;
+}
+
+/*
+ * Se llamara al entrar en un casillero nuevo del nivel 0 que empieza
+ * una vuelta. Deja pendiente bajar de nivel los temporizadores de los
+ * casilleros de los niveles superiores que empiezan en este momento,
+ * empezando por el nivel mas alto para que lo que baja de el se reparta
+ * tambien.
+ */
+static void empezar_cascada(rueda_t* rueda){
+    size_t nivel = 1;
+    while(nivel < NIVELES - 1 && ((rueda->actual >> (BITS_NIVEL * nivel)) & MASCARA) == 0)
+        nivel++;
+    rueda->nivel_cascada = nivel;
+}
+
+/*
+ * Continua la cascada pendiente, bajando de nivel como mucho presupuesto
+ * temporizadores. Si no termina, la proxima llamada sigue desde el
+ * mismo casillero.
+ *
+ * Devuelve la cantidad de temporizadores movidos.
+ */
+static size_t cascada(rueda_t* rueda, size_t presupuesto){
+    size_t movidos = 0;
+    while(rueda->nivel_cascada > 0 && movidos < presupuesto){
+        size_t nivel = rueda->nivel_cascada;
+        size_t indice = (size_t)((rueda->actual >> (BITS_NIVEL * nivel)) & MASCARA);
+        temporizador_t* temporizador = rueda->casilleros[nivel][indice];
+        if(!temporizador){
+            rueda->nivel_cascada--;
+            continue;
+        }
+        desenlazar(rueda, temporizador);
+        ubicar(rueda, temporizador);
+        movidos++;
+    }
+    return movidos;
+}
+
+/*
+ * Devuelve el proximo tick en el que hay algo para hacer: vencer un
+ * casillero del nivel 0 o bajar de nivel un casillero ocupado. Los
+ * tramos en los que no hay temporizadores se saltean completos, por lo
+ * que ponerse al dia despues de mucho tiempo sin avanzar es barato.
+ */
+static uint64_t proximo_tick(rueda_t* rueda){
+    for(size_t nivel = 0; nivel < NIVELES; nivel++){
+        size_t desplazamiento = BITS_NIVEL * nivel;
+        uint64_t indice = (rueda->actual >> desplazamiento) & MASCARA;
+        uint64_t posteriores = indice == MASCARA ? VACIO : rueda->ocupados[nivel] >> (indice + 1);
+        if(posteriores != VACIO){
+            uint64_t salto = (uint64_t)__builtin_ctzll(posteriores) + 1;
+            return ((rueda->actual >> desplazamiento) + salto) << desplazamiento;
+        }
+        if(rueda->ocupados[nivel] != VACIO)
+            return ((rueda->actual >> (desplazamiento + BITS_NIVEL)) + 1) << (desplazamiento + BITS_NIVEL);
+    }
+    return rueda->actual + 1;
+}
+
+size_t rueda_avanzar(rueda_t* rueda, uint64_t ahora, size_t presupuesto, void (*vencido)(temporizador_t* temporizador, void* aux), void* aux){
+    if(!rueda || !vencido)
+        return VACIO;
+    size_t vencidos = 0, trabajo = 0;
+    while(rueda->actual <= ahora && trabajo < presupuesto){
+        trabajo += cascada(rueda, presupuesto - trabajo);
+        if(rueda->nivel_cascada)
+            break;
+        if(!rueda->cantidad){
+            rueda->actual = ahora + 1;
+            break;
+        }
+        temporizador_t** casillero = &rueda->casilleros[0][rueda->actual & MASCARA];
+        while(*casillero && trabajo < presupuesto){
+            temporizador_t* temporizador = *casillero;
+            rueda_quitar(rueda, temporizador);
+            vencido(temporizador, aux);
+            vencidos++;
+            trabajo++;
+        }
+        if(*casillero)
+            break;
+        uint64_t siguiente = proximo_tick(rueda);
+        rueda->actual = siguiente <= ahora ? siguiente : ahora + 1;
+        trabajo++;
+        if((rueda->actual & MASCARA) == 0)
+            empezar_cascada(rueda);
+    }
+    return vencidos;
+}
+
+size_t rueda_cantidad(rueda_t* rueda){
+    if(!rueda)
+        return VACIO;
+    return rueda->cantidad;
+}
+
+void rueda_destruir(rueda_t* rueda){
+    free(rueda);
+}
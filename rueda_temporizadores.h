@@ -0,0 +1,74 @@
+#ifndef __RUEDA_TEMPORIZADORES_H__
+#define __RUEDA_TEMPORIZADORES_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Rueda jerarquica de temporizadores. Cada nivel tiene 64 casilleros y
+ * cada casillero de un nivel abarca una vuelta completa del nivel
+ * anterior. Agregar y quitar un temporizador es O(1), y al avanzar el
+ * tiempo solo se visitan los casilleros que vencen, bajando de nivel
+ * los temporizadores a medida que se acerca su vencimiento.
+ *
+ * El tiempo se mide en unidades enteras (ticks) definidas por quien
+ * usa la rueda.
+ */
+typedef struct rueda rueda_t;
+
+/*
+ * Temporizador de la rueda. Lo reserva quien lo usa, que debe completar
+ * el vencimiento y el dato antes de agregarlo; el resto de los campos
+ * los maneja la rueda.
+ */
+typedef struct temporizador{
+    struct temporizador* anterior;
+    struct temporizador* siguiente;
+    uint64_t vencimiento;
+    void* dato;
+    size_t casillero;
+    bool enlazado;
+}temporizador_t;
+
+/*
+ * Crea una rueda cuyo tiempo actual es ahora.
+ * Devuelve la rueda creada o NULL en caso de error.
+ */
+rueda_t* rueda_crear(uint64_t ahora);
+
+/*
+ * Agrega el temporizador a la rueda. Si su vencimiento ya paso, vencera
+ * en el proximo avance.
+ */
+void rueda_agregar(rueda_t* rueda, temporizador_t* temporizador);
+
+/*
+ * Quita el temporizador de la rueda. No hace nada si el temporizador
+ * no esta en la rueda.
+ */
+void rueda_quitar(rueda_t* rueda, temporizador_t* temporizador);
+
+/*
+ * Avanza el tiempo de la rueda hasta ahora, invocando a la funcion con
+ * cada temporizador vencido (que ya fue quitado de la rueda, por lo que
+ * la funcion puede liberarlo). El trabajo se corta al llegar al
+ * presupuesto, contando cada temporizador vencido o movido de nivel y
+ * cada salto de casillero; una llamada posterior continua desde donde
+ * quedo.
+ *
+ * Devuelve la cantidad de temporizadores vencidos.
+ */
+size_t rueda_avanzar(rueda_t* rueda, uint64_t ahora, size_t presupuesto, void (*vencido)(temporizador_t* temporizador, void* aux), void* aux);
+
+/*
+ * Devuelve la cantidad de temporizadores en la rueda.
+ */
+size_t rueda_cantidad(rueda_t* rueda);
+
+/*
+ * Libera la rueda. Los temporizadores que contenga no se liberan.
+ */
+void rueda_destruir(rueda_t* rueda);
+
+#endif /* __RUEDA_TEMPORIZADORES_H__ */